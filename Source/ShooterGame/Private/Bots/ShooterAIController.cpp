@@ -10,6 +10,11 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
 #include "Weapons/ShooterWeapon.h"
+#include "Weapons/ShooterWeapon_Projectile.h"
+
+int32 CVar_ShooterBots_LeadAim = 1;
+static FAutoConsoleVariableRef CVarShooterBotsLeadAim(TEXT("ShooterBots.LeadAim"), CVar_ShooterBots_LeadAim,
+	TEXT("Bots with projectile weapon aim where moving enemy will be when projectile reaches it"), ECVF_Default);
 
 AShooterAIController::AShooterAIController(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -248,6 +253,16 @@ void AShooterAIController::UpdateControlRotation(float DeltaTime, bool bUpdatePa
 	if( !FocalPoint.IsZero() && GetPawn())
 	{
 		FVector Direction = FocalPoint - GetPawn()->GetActorLocation();
+
+		// lead enemy with projectile
+		AShooterBot* MyBot = Cast<AShooterBot>(GetPawn());
+		AShooterWeapon_Projectile* ProjectileWeapon = MyBot ? Cast<AShooterWeapon_Projectile>(MyBot->GetWeapon()) : nullptr;
+		AActor* FocusActor = GetFocusActor();
+		if (CVar_ShooterBots_LeadAim && ProjectileWeapon && FocusActor && FocusActor == GetEnemy())
+		{
+			Direction = ProjectileWeapon->GetLeadDirection(ProjectileWeapon->GetMuzzleLocation(), FocalPoint, FocusActor->GetVelocity());
+		}
+
 		FRotator NewControlRotation = Direction.Rotation();
 		
 		NewControlRotation.Yaw = FRotator::ClampAxis(NewControlRotation.Yaw);
@@ -0,0 +1,246 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Commandlets/ShooterRadarMinimapCommandlet.h"
+
+#include "ShooterGame.h"
+#include "UI/ShooterRadarMinimap.h"
+
+#if WITH_EDITOR
+#include "AssetRegistryModule.h"
+#include "Engine/LevelBounds.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/Texture2D.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#endif
+
+namespace RadarMinimapBake
+{
+	/** Surfaces with normal Z below this are walls and drawn darker */
+	const float WalkableNormalZ = 0.7f;
+
+	/** Floor shade of lowest and highest map height */
+	const uint8 MinShade = 60;
+	const uint8 MaxShade = 200;
+
+	/** Wall shade multiplier */
+	const float WallShadeScale = 0.6f;
+}
+
+UShooterRadarMinimapCommandlet::UShooterRadarMinimapCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UShooterRadarMinimapCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString Maps;
+	if (!FParse::Value(*Params, TEXT("Map="), Maps, false))
+	{
+		UE_LOG(LogShooter, Error, TEXT("ShooterRadarMinimap: no -Map=/Game/Maps/MapName given"));
+		return 1;
+	}
+
+	FParse::Value(*Params, TEXT("TileResolution="), TileResolution);
+	FParse::Value(*Params, TEXT("TileWorldSize="), TileWorldSize);
+	TileResolution = FMath::Clamp(FMath::RoundUpToPowerOfTwo(FMath::Max(TileResolution, 16)), 16u, 2048u);  // power of two for full mip chain
+	TileWorldSize = FMath::Max(TileWorldSize, 256.0f);
+
+	TArray<FString> MapNames;
+	Maps.ParseIntoArray(MapNames, TEXT(","));
+
+	int32 NumFailed = 0;
+	for (const FString& MapName : MapNames)
+	{
+		if (!BakeMap(MapName))
+		{
+			NumFailed++;
+		}
+	}
+
+	return NumFailed > 0 ? 1 : 0;
+#else
+	UE_LOG(LogShooter, Error, TEXT("ShooterRadarMinimap commandlet needs editor build"));
+	return 1;
+#endif
+}
+
+#if WITH_EDITOR
+
+UWorld* UShooterRadarMinimapCommandlet::LoadMapWorld(const FString& MapPackageName)
+{
+	UPackage* MapPackage = LoadPackage(nullptr, *MapPackageName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	World->WorldType = EWorldType::Editor;
+	World->AddToRoot();
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.RequiresHitProxies(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true));
+	}
+
+	// gameplay, collision and meshing sublevels all contribute to minimap
+	for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		StreamingLevel->SetShouldBeLoaded(true);
+		StreamingLevel->SetShouldBeVisible(true);
+	}
+	World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+	World->UpdateWorldComponents(true, false);
+
+	return World;
+}
+
+bool UShooterRadarMinimapCommandlet::BakeMap(const FString& MapPackageName)
+{
+	UWorld* World = LoadMapWorld(MapPackageName);
+	if (World == nullptr)
+	{
+		UE_LOG(LogShooter, Error, TEXT("ShooterRadarMinimap: can't load map %s"), *MapPackageName);
+		return false;
+	}
+
+	FBox MapBounds(ForceInit);
+	for (ULevel* Level : World->GetLevels())
+	{
+		MapBounds += ALevelBounds::CalculateLevelBounds(Level);
+	}
+
+	if (!MapBounds.IsValid)
+	{
+		UE_LOG(LogShooter, Error, TEXT("ShooterRadarMinimap: map %s has no bounds"), *MapPackageName);
+		World->DestroyWorld(false);
+		World->RemoveFromRoot();
+		return false;
+	}
+
+	const FString MapName = FPackageName::GetShortName(MapPackageName);
+	const FString DataPackageName = UShooterRadarMinimapData::GetPackagePath(MapName);
+
+	UPackage* DataPackage = CreatePackage(*DataPackageName);
+	UShooterRadarMinimapData* Data = NewObject<UShooterRadarMinimapData>(DataPackage, *FPackageName::GetShortName(DataPackageName), RF_Public | RF_Standalone);
+	Data->WorldOrigin = FVector2D(MapBounds.Min);
+	Data->TileWorldSize = TileWorldSize;
+	Data->NumTilesX = FMath::Max(FMath::CeilToInt(MapBounds.GetSize().X / TileWorldSize), 1);
+	Data->NumTilesY = FMath::Max(FMath::CeilToInt(MapBounds.GetSize().Y / TileWorldSize), 1);
+	Data->Tiles.SetNum(Data->NumTilesX * Data->NumTilesY);
+
+	UE_LOG(LogShooter, Display, TEXT("ShooterRadarMinimap: baking %s, %d x %d tiles of %d texels"), *MapPackageName, Data->NumTilesX, Data->NumTilesY, TileResolution);
+
+	const FVector2D HeightRange(MapBounds.Min.Z, MapBounds.Max.Z);
+	TArray<FColor> Texels;
+	bool bSuccess = true;
+
+	for (int32 Y = 0; Y < Data->NumTilesY && bSuccess; Y++)
+	{
+		for (int32 X = 0; X < Data->NumTilesX && bSuccess; X++)
+		{
+			RasterizeTile(World, Data->GetTileBounds(X, Y), HeightRange, Texels);
+
+			const FString TilePackageName = FString::Printf(TEXT("%s/T_%s_Minimap_%d_%d"), *UShooterRadarMinimapData::GetPackageDirectory(MapName), *MapName, X, Y);
+			UTexture2D* Texture = SaveTileTexture(TilePackageName, Texels);
+			Data->Tiles[Data->GetTileIndex(X, Y)] = Texture;
+			bSuccess = Texture != nullptr;
+		}
+	}
+
+	FAssetRegistryModule::AssetCreated(Data);
+	bSuccess = bSuccess && SaveAssetPackage(Data);
+
+	// tear down physics scene and subsystems InitWorld created, so each baked map is fully released
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	CollectGarbage(RF_NoFlags);  // tile textures source data and map are dropped before next map
+
+	return bSuccess;
+}
+
+void UShooterRadarMinimapCommandlet::RasterizeTile(UWorld* World, const FBox2D& TileBounds, const FVector2D& HeightRange, TArray<FColor>& OutTexels) const
+{
+	OutTexels.SetNumUninitialized(TileResolution * TileResolution);
+
+	const float TexelSize = TileWorldSize / TileResolution;
+	const float TraceStartZ = HeightRange.Y + 100.0f;
+	const float TraceEndZ = HeightRange.X - 100.0f;
+	const float InvHeightRange = 1.0f / FMath::Max(HeightRange.Y - HeightRange.X, 1.0f);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(RadarMinimapBake), true);
+
+	for (int32 TexelY = 0; TexelY < TileResolution; TexelY++)
+	{
+		for (int32 TexelX = 0; TexelX < TileResolution; TexelX++)
+		{
+			// texel U goes along world X, V along world Y, matches FRadarMinimap UVs
+			const FVector2D Location = TileBounds.Min + FVector2D(TexelX + 0.5f, TexelY + 0.5f) * TexelSize;
+
+			FHitResult Hit;
+			FColor& Texel = OutTexels[TexelY * TileResolution + TexelX];
+			if (!World->LineTraceSingleByChannel(Hit, FVector(Location, TraceStartZ), FVector(Location, TraceEndZ), ECC_Visibility, QueryParams))
+			{
+				Texel = FColor::Transparent;
+				continue;
+			}
+
+			const float RelativeHeight = FMath::Clamp((Hit.ImpactPoint.Z - HeightRange.X) * InvHeightRange, 0.0f, 1.0f);
+			float Shade = FMath::Lerp((float)RadarMinimapBake::MinShade, (float)RadarMinimapBake::MaxShade, RelativeHeight);
+			if (Hit.ImpactNormal.Z < RadarMinimapBake::WalkableNormalZ)
+			{
+				Shade *= RadarMinimapBake::WallShadeScale;
+			}
+
+			const uint8 ShadeByte = (uint8)FMath::RoundToInt(Shade);
+			Texel = FColor(ShadeByte, ShadeByte, ShadeByte, 255);
+		}
+	}
+}
+
+UTexture2D* UShooterRadarMinimapCommandlet::SaveTileTexture(const FString& PackageName, const TArray<FColor>& Texels) const
+{
+	UPackage* Package = CreatePackage(*PackageName);
+	UTexture2D* Texture = NewObject<UTexture2D>(Package, *FPackageName::GetShortName(PackageName), RF_Public | RF_Standalone);
+
+	Texture->Source.Init(TileResolution, TileResolution, 1, 1, TSF_BGRA8, (const uint8*)Texels.GetData());
+	Texture->SRGB = true;
+	Texture->CompressionSettings = TC_Default;
+	Texture->MipGenSettings = TMGS_FromTextureGroup;
+	Texture->LODGroup = TEXTUREGROUP_World;  // mips and streaming, UI group has none
+	Texture->AddressX = TA_Clamp;
+	Texture->AddressY = TA_Clamp;
+	Texture->PostEditChange();
+
+	FAssetRegistryModule::AssetCreated(Texture);
+	return SaveAssetPackage(Texture) ? Texture : nullptr;
+}
+
+bool UShooterRadarMinimapCommandlet::SaveAssetPackage(UObject* Asset) const
+{
+	UPackage* Package = Asset->GetOutermost();
+	Package->MarkPackageDirty();
+
+	const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+	if (!UPackage::SavePackage(Package, Asset, RF_Public | RF_Standalone, *Filename))
+	{
+		UE_LOG(LogShooter, Error, TEXT("ShooterRadarMinimap: can't save %s"), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+#endif
@@ -278,6 +278,19 @@ void AShooterGameMode::PreLogin(const FString& Options, const FString& Address,
 }
 
 
+void AShooterGameMode::GenericPlayerInitialization(AController* C)
+{
+	Super::GenericPlayerInitialization(C);
+
+	// remote players get radar points from server, they may not know about actors out of their network relevancy.
+	// runs after login and after seamless travel, which destroys feed with old world
+	AShooterPlayerController* PC = Cast<AShooterPlayerController>(C);
+	if (PC)
+	{
+		PC->InitRadarFeed();
+	}
+}
+
 void AShooterGameMode::PostLogin(APlayerController* NewPlayer)
 {
 	Super::PostLogin(NewPlayer);
@@ -0,0 +1,501 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ShooterGame.h"
+#include "Online/ShooterRadarFeed.h"
+#include "UI/ShooterRadarSubsystem.h"
+#include "Net/UnrealNetwork.h"
+
+DECLARE_CYCLE_STAT(TEXT("Radar Feed Build"), STAT_RadarFeedBuild, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Feed Entries Built"), STAT_RadarFeedEntries, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Feed Bytes Sent"), STAT_RadarFeedBytes, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Pings Transmitted"), STAT_RadarPingsTransmitted, STATGROUP_ShooterRadar);
+
+float CVar_ShooterRadarFeed_CullDistance = 8000.f;
+static FAutoConsoleVariableRef CVarShooterRadarFeedCullDistance(TEXT("ShooterRadarFeed.CullDistance"), CVar_ShooterRadarFeed_CullDistance,
+	TEXT("Radar points further then this from feed owner are not sent, unless they are shown on radar border. Should be not less then HUD RadarWorldAreaRadius"), ECVF_Default);
+
+float CVar_ShooterRadarFeed_PingMoveThreshold = 100.f;
+static FAutoConsoleVariableRef CVarShooterRadarFeedPingMoveThreshold(TEXT("ShooterRadarFeed.PingMoveThreshold"), CVar_ShooterRadarFeed_PingMoveThreshold,
+	TEXT("Reveal in display time of already sent ping is sent again only if revealed actor moved further then this"), ECVF_Default);
+
+namespace RadarFeedNet
+{
+	/** Entry Category byte layout */
+	static const uint8 CategoryMask = 0x3F;
+	static const uint8 ExpiresBit = 0x40;
+	static const uint8 ShowIfOutRadarBorderBit = 0x80;
+	static_assert(RADAR_CATEGORY_MAX - 1 <= CategoryMask, "Radar category id doesn't fit radar feed entry category bits");
+
+	static uint16 QuantizeTime(float Time)
+	{
+		return (uint16)((uint32)FMath::FloorToInt(Time / RADAR_FEED_TIME_QUANTIZATION) & 0xFFFF);
+	}
+
+	template<typename T>
+	static T QuantizeAxis(float Value, float Step)
+	{
+		return (T)FMath::Clamp<int32>(FMath::RoundToInt(Value / Step), TNumericLimits<T>::Min(), TNumericLimits<T>::Max());
+	}
+
+	/** Server expire time of radar point with TimeLeft to show */
+	static uint16 QuantizeExpireTime(uint16 ServerTimeQuantized, float TimeLeft)
+	{
+		return ServerTimeQuantized + (uint16)FMath::CeilToInt(FMath::Max(0.0f, TimeLeft) / RADAR_FEED_TIME_QUANTIZATION);
+	}
+
+	/** Convert ExpireTime in server time steps to local world time, ServerTimeQuantized is current server time */
+	static float ToLocalExpireTime(uint16 ExpireTime, uint16 ServerTimeQuantized, float LocalTime)
+	{
+		const int16 StepsLeft = (int16)(ExpireTime - ServerTimeQuantized);  // wrap safe difference
+		return LocalTime + FMath::Max<int16>(StepsLeft, 0) * RADAR_FEED_TIME_QUANTIZATION;
+	}
+
+	/** Snapshot entry payload: X, Y, Z, Category, and ExpireTime of expiring entries */
+	static const int32 EntryBytes = 2 + 2 + 1 + 1;
+	static const int32 ExpireTimeBytes = 2;
+
+	/** Estimated ping item payload: handle, X, Y, Z, Category, ExpireTime */
+	static const int32 PingItemBytes = 4 + 2 + 2 + 1 + 1 + 2;
+	/** Estimated removed ping payload: handle */
+	static const int32 PingRemoveBytes = 4;
+}
+
+bool FShooterRadarFeedSnapshot::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 NumEntries = Entries.Num();
+	Ar.SerializeIntPacked(NumEntries);
+
+	if (Ar.IsLoading())
+	{
+		if (NumEntries > RADAR_FEED_MAX_ENTRIES)
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+		Entries.SetNumUninitialized(NumEntries);
+	}
+
+	for (FShooterRadarFeedEntry& Entry : Entries)
+	{
+		uint8 CategoryByte = Entry.Category & RadarFeedNet::CategoryMask;
+		CategoryByte |= Entry.bExpires ? RadarFeedNet::ExpiresBit : 0;
+		CategoryByte |= Entry.bShowIfOutRadarBorder ? RadarFeedNet::ShowIfOutRadarBorderBit : 0;
+
+		Ar << Entry.X;
+		Ar << Entry.Y;
+		Ar << Entry.Z;
+		Ar << CategoryByte;
+
+		Entry.Category = CategoryByte & RadarFeedNet::CategoryMask;
+		Entry.bExpires = (CategoryByte & RadarFeedNet::ExpiresBit) != 0;
+		Entry.bShowIfOutRadarBorder = (CategoryByte & RadarFeedNet::ShowIfOutRadarBorderBit) != 0;
+
+		if (Entry.bExpires)
+		{
+			Ar << Entry.ExpireTime;
+		}
+		else
+		{
+			Entry.ExpireTime = 0;
+		}
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+int32 FShooterRadarFeedSnapshot::GetSerializedSize() const
+{
+	// packed entries count, one byte per 7 bits
+	int32 Size = 1;
+	for (uint32 PackedCount = (uint32)Entries.Num() >> 7; PackedCount > 0; PackedCount >>= 7)
+	{
+		Size++;
+	}
+
+	for (const FShooterRadarFeedEntry& Entry : Entries)
+	{
+		Size += RadarFeedNet::EntryBytes + (Entry.bExpires ? RadarFeedNet::ExpireTimeBytes : 0);
+	}
+
+	return Size;
+}
+
+void FRadarFeedPoints::Reset()
+{
+	PosX.Reset();
+	PosY.Reset();
+	PosZ.Reset();
+	Flags.Reset();
+	Floors.Reset();
+	ExpireTimes.Reset();
+}
+
+AShooterRadarFeed::AShooterRadarFeed(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	bReplicates = true;
+	bOnlyRelevantToOwner = true;
+	bAlwaysRelevant = false;
+	SetReplicatingMovement(false);
+
+	// rate is driven by replication graph radar feed node, see ShooterRepGraph.RadarFeed.Rate
+	NetUpdateFrequency = 10.0f;
+}
+
+void AShooterRadarFeed::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(AShooterRadarFeed, Snapshot, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(AShooterRadarFeed, Pings, COND_OwnerOnly);
+}
+
+bool AShooterRadarFeed::BuildSnapshot()
+{
+	SCOPE_CYCLE_COUNTER(STAT_RadarFeedBuild);
+
+	UWorld* World = GetWorld();
+	UShooterRadarSubsystem* RadarModel = World ? World->GetSubsystem<UShooterRadarSubsystem>() : nullptr;
+	APlayerController* OwnerPC = Cast<APlayerController>(GetOwner());
+	if (RadarModel == nullptr || OwnerPC == nullptr)
+	{
+		return false;
+	}
+
+	RadarModel->UpdateRadar();  // no-op if model is already updated this frame
+
+	// radar center is owner pawn, spectators see radar from view point
+	const AActor* Viewer = OwnerPC->GetPawn();
+	FVector ViewLocation;
+	if (Viewer)
+	{
+		ViewLocation = Viewer->GetActorLocation();
+	}
+	else
+	{
+		FRotator ViewRotation;
+		OwnerPC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	}
+
+	// previous entries are kept to detect changes, both arrays keep their memory between builds
+	Exchange(PrevSnapshotEntries, Snapshot.Entries);
+	Snapshot.Entries.Reset();
+
+	const float CullDistanceSq = FMath::Square(CVar_ShooterRadarFeed_CullDistance);
+	const uint16 ServerTimeQuantized = RadarFeedNet::QuantizeTime(World->GetTimeSeconds());
+
+	// expiring categories are sent by pings stream
+	const FRadarCategoryTable& Categories = RadarModel->GetCategories();
+	for (int32 Category = 0; Category < Categories.Num(); Category++)
+	{
+		if (!Categories.GetCategory(Category).ExpiresOnShow())
+		{
+			AddRegistryEntries(*RadarModel, Category, Viewer, ViewLocation, CullDistanceSq, ServerTimeQuantized);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_RadarFeedEntries, Snapshot.Entries.Num());
+
+	int32 SentBytes = UpdatePings(*RadarModel, OwnerPC, Viewer, ViewLocation, CullDistanceSq, ServerTimeQuantized);
+
+	if (Snapshot.Entries != PrevSnapshotEntries)
+	{
+		SentBytes += Snapshot.GetSerializedSize();
+	}
+
+	AddSentBytes(SentBytes);
+
+	return SentBytes > 0;
+}
+
+bool AShooterRadarFeed::ShouldResendPing(const FShooterRadarPingItem& SentPing, const FShooterRadarPingItem& NewPing, float ShowTime)
+{
+	const int32 MoveThreshold = FMath::RoundToInt(CVar_ShooterRadarFeed_PingMoveThreshold / RADAR_FEED_POS_QUANTIZATION);
+	const int32 RefreshSteps = FMath::CeilToInt(ShowTime * 0.5f / RADAR_FEED_TIME_QUANTIZATION);
+
+	const bool bMoved = FMath::Abs(NewPing.X - SentPing.X) > MoveThreshold || FMath::Abs(NewPing.Y - SentPing.Y) > MoveThreshold
+		|| FMath::Abs(NewPing.Z - SentPing.Z) > 1;
+	const bool bExpiresSoon = (int16)(NewPing.ExpireTime - SentPing.ExpireTime) >= RefreshSteps;
+
+	return bMoved || bExpiresSoon;
+}
+
+int32 AShooterRadarFeed::UpdatePings(const UShooterRadarSubsystem& RadarModel, const AController* OwnerController, const AActor* Viewer,
+	const FVector& ViewLocation, float CullDistanceSq, uint16 ServerTimeQuantized)
+{
+	const FRadarCategoryTable& Categories = RadarModel.GetCategories();
+
+	int32 NumDirtied = 0;
+	RevealedActors.Reset();
+
+	// same culling and limit as snapshot entries, pings of actors skipped here are removed below
+	auto ShouldPing = [&](const FRadarPointRegistry& Registry, int32 Index)
+	{
+		if (RevealedActors.Num() >= RADAR_FEED_MAX_ENTRIES)
+		{
+			return false;
+		}
+
+		const float DeltaX = Registry.PosX[Index] - ViewLocation.X;
+		const float DeltaY = Registry.PosY[Index] - ViewLocation.Y;
+		return (Registry.Flags[Index] & ERadarPointFlags::CanShowIfOutRadarBorder) != 0 || DeltaX * DeltaX + DeltaY * DeltaY <= CullDistanceSq;
+	};
+
+	for (int32 Category = 0; Category < Categories.Num(); Category++)
+	{
+		const float ShowTime = Categories.GetCategory(Category).ShowTime;
+		if (ShowTime <= 0.0f)
+		{
+			continue;  // sent by snapshot
+		}
+
+		const FRadarPointRegistry& Registry = RadarModel.GetRegistry(Category);
+		for (int32 i = 0; i < Registry.NumSlots(); i++)
+		{
+			if (Registry.CanShow(i) && Registry.Actors[i] != Viewer && ShouldPing(Registry, i))
+			{
+				NumDirtied += UpdatePing(Registry, i, Category, ShowTime, Registry.ShowTimeMaxes[i] - Registry.ShowTimes[i], ServerTimeQuantized);
+			}
+		}
+	}
+
+	// spots of owner team are revealed only to it
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	RadarModel.ForEachSpottedPoint(OwnerController, [&](int32 Category, int32 Index, float ExpireTime)
+	{
+		const FRadarPointRegistry& Registry = RadarModel.GetRegistry(Category);
+		if (ShouldPing(Registry, Index))
+		{
+			NumDirtied += UpdatePing(Registry, Index, Category, Categories.GetCategory(Category).ShowTime, ExpireTime - WorldTime, ServerTimeQuantized);
+		}
+	});
+
+	const int32 NumRemoved = Pings.Items.RemoveAll([this](const FShooterRadarPingItem& Item) { return !RevealedActors.Contains(Item.Actor); });
+	if (NumRemoved > 0)
+	{
+		Pings.MarkArrayDirty();
+	}
+
+	INC_DWORD_STAT_BY(STAT_RadarPingsTransmitted, NumDirtied);
+	PingsTransmitted += NumDirtied;
+
+	return NumDirtied * RadarFeedNet::PingItemBytes + NumRemoved * RadarFeedNet::PingRemoveBytes;
+}
+
+bool AShooterRadarFeed::UpdatePing(const FRadarPointRegistry& Registry, int32 Index, int32 Category, float ShowTime, float TimeLeft, uint16 ServerTimeQuantized)
+{
+	const AActor* Actor = Registry.Actors[Index];
+	RevealedActors.Add(Actor);
+
+	FShooterRadarPingItem NewPing;
+	NewPing.X = RadarFeedNet::QuantizeAxis<int16>(Registry.PosX[Index], RADAR_FEED_POS_QUANTIZATION);
+	NewPing.Y = RadarFeedNet::QuantizeAxis<int16>(Registry.PosY[Index], RADAR_FEED_POS_QUANTIZATION);
+	NewPing.Z = RadarFeedNet::QuantizeAxis<int8>(Registry.PosZ[Index], RADAR_FEED_HEIGHT_QUANTIZATION);
+	NewPing.Category = (uint8)Category;
+	NewPing.ExpireTime = RadarFeedNet::QuantizeExpireTime(ServerTimeQuantized, TimeLeft);
+
+	// few pings per feed, linear search is fine
+	FShooterRadarPingItem* Ping = Pings.Items.FindByPredicate([Actor](const FShooterRadarPingItem& Item) { return Item.Actor == Actor; });
+	if (Ping == nullptr)
+	{
+		Ping = &Pings.Items.AddDefaulted_GetRef();
+		Ping->Actor = Actor;
+	}
+	else if (Ping->Category == NewPing.Category && !ShouldResendPing(*Ping, NewPing, ShowTime))
+	{
+		return false;  // coalesced with already sent ping
+	}
+
+	Ping->X = NewPing.X;
+	Ping->Y = NewPing.Y;
+	Ping->Z = NewPing.Z;
+	Ping->Category = NewPing.Category;
+	Ping->ExpireTime = NewPing.ExpireTime;
+	Pings.MarkItemDirty(*Ping);
+	return true;
+}
+
+void AShooterRadarFeed::AddRegistryEntries(const UShooterRadarSubsystem& RadarModel, int32 Category, const AActor* Viewer,
+	const FVector& ViewLocation, float CullDistanceSq, uint16 ServerTimeQuantized)
+{
+	const FRadarPointRegistry& Registry = RadarModel.GetRegistry(Category);
+
+	for (int32 i = 0; i < Registry.NumSlots(); i++)
+	{
+		if (Snapshot.Entries.Num() >= RADAR_FEED_MAX_ENTRIES)
+		{
+			return;
+		}
+
+		if (!Registry.CanShow(i) || Registry.Actors[i] == Viewer)
+		{
+			continue;
+		}
+
+		const uint8 PointFlags = Registry.Flags[i];
+		const bool bShowIfOutRadarBorder = (PointFlags & ERadarPointFlags::CanShowIfOutRadarBorder) != 0;
+
+		const float DeltaX = Registry.PosX[i] - ViewLocation.X;
+		const float DeltaY = Registry.PosY[i] - ViewLocation.Y;
+		if (!bShowIfOutRadarBorder && DeltaX * DeltaX + DeltaY * DeltaY > CullDistanceSq)
+		{
+			continue;
+		}
+
+		FShooterRadarFeedEntry& Entry = Snapshot.Entries.AddDefaulted_GetRef();
+		Entry.X = RadarFeedNet::QuantizeAxis<int16>(Registry.PosX[i], RADAR_FEED_POS_QUANTIZATION);
+		Entry.Y = RadarFeedNet::QuantizeAxis<int16>(Registry.PosY[i], RADAR_FEED_POS_QUANTIZATION);
+		Entry.Z = RadarFeedNet::QuantizeAxis<int8>(Registry.PosZ[i], RADAR_FEED_HEIGHT_QUANTIZATION);
+		Entry.Category = (uint8)Category;
+		Entry.bShowIfOutRadarBorder = bShowIfOutRadarBorder;
+
+		const float ShowTimeMax = Registry.ShowTimeMaxes[i];
+		if (ShowTimeMax > 0.0f)
+		{
+			Entry.bExpires = true;
+			Entry.ExpireTime = RadarFeedNet::QuantizeExpireTime(ServerTimeQuantized, ShowTimeMax - Registry.ShowTimes[i]);
+		}
+	}
+}
+
+void AShooterRadarFeed::AddSentBytes(int32 NumBytes)
+{
+	INC_DWORD_STAT_BY(STAT_RadarFeedBytes, NumBytes);
+
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	BytesInWindow += NumBytes;
+
+	const float WindowTime = WorldTime - BytesWindowStartTime;
+	if (WindowTime >= 1.0f)
+	{
+		BytesPerSecond = BytesInWindow / WindowTime;
+		BytesInWindow = 0;
+		BytesWindowStartTime = WorldTime;
+	}
+}
+
+const FRadarFeedPoints& AShooterRadarFeed::GetPoints(int32 Category) const
+{
+	static const FRadarFeedPoints NoPoints;
+	return Points.IsValidIndex(Category) ? Points[Category] : NoPoints;
+}
+
+const FRadarCategoryTable* AShooterRadarFeed::ResetPoints(bool bExpiring)
+{
+	const UShooterRadarSubsystem* RadarModel = GetWorld()->GetSubsystem<UShooterRadarSubsystem>();
+	if (RadarModel == nullptr)
+	{
+		return nullptr;
+	}
+
+	const FRadarCategoryTable& Categories = RadarModel->GetCategories();
+	Points.SetNum(Categories.Num());
+
+	for (int32 Category = 0; Category < Categories.Num(); Category++)
+	{
+		if (Categories.GetCategory(Category).ExpiresOnShow() == bExpiring)
+		{
+			Points[Category].Reset();
+		}
+	}
+
+	return &Categories;
+}
+
+void AShooterRadarFeed::OnRep_Snapshot()
+{
+	bHasSnapshot = true;
+
+	const FRadarCategoryTable* Categories = ResetPoints(false);
+	if (Categories == nullptr)
+	{
+		return;
+	}
+
+	const FRadarFloorBands& FloorBands = GetWorld()->GetSubsystem<UShooterRadarSubsystem>()->GetFloorBands();
+
+	// expire times are sent in server time, convert them to local world time
+	const float LocalTime = GetWorld()->GetTimeSeconds();
+	const uint16 ServerTimeQuantized = GetServerTimeQuantized();
+
+	for (const FShooterRadarFeedEntry& Entry : Snapshot.Entries)
+	{
+		if (!Categories->IsValidCategory(Entry.Category))
+		{
+			continue;  // server has radar category client config doesn't know
+		}
+
+		FRadarFeedPoints& CategoryPoints = Points[Entry.Category];
+
+		CategoryPoints.PosX.Add(Entry.X * RADAR_FEED_POS_QUANTIZATION);
+		CategoryPoints.PosY.Add(Entry.Y * RADAR_FEED_POS_QUANTIZATION);
+		CategoryPoints.PosZ.Add(Entry.Z * RADAR_FEED_HEIGHT_QUANTIZATION);
+		CategoryPoints.Floors.Add(FloorBands.GetFloor(CategoryPoints.PosZ.Last()));
+		CategoryPoints.Flags.Add(ERadarPointFlags::CanShow | (Entry.bShowIfOutRadarBorder ? ERadarPointFlags::CanShowIfOutRadarBorder : ERadarPointFlags::None));
+
+		CategoryPoints.ExpireTimes.Add(Entry.bExpires ? RadarFeedNet::ToLocalExpireTime(Entry.ExpireTime, ServerTimeQuantized, LocalTime) : 0.0f);
+	}
+
+	UpdateFeedPoints();
+}
+
+void AShooterRadarFeed::OnRep_Pings()
+{
+	bHasSnapshot = true;
+
+	const FRadarCategoryTable* Categories = ResetPoints(true);
+	if (Categories == nullptr)
+	{
+		return;
+	}
+
+	const FRadarFloorBands& FloorBands = GetWorld()->GetSubsystem<UShooterRadarSubsystem>()->GetFloorBands();
+
+	const float LocalTime = GetWorld()->GetTimeSeconds();
+	const uint16 ServerTimeQuantized = GetServerTimeQuantized();
+
+	for (const FShooterRadarPingItem& Ping : Pings.Items)
+	{
+		if (!Categories->IsValidCategory(Ping.Category))
+		{
+			continue;
+		}
+
+		const uint8 PingFlags = Categories->GetCategory(Ping.Category).bShowIfOutRadarBorder ? ERadarPointFlags::CanShowIfOutRadarBorder : ERadarPointFlags::None;
+
+		FRadarFeedPoints& CategoryPoints = Points[Ping.Category];
+		CategoryPoints.PosX.Add(Ping.X * RADAR_FEED_POS_QUANTIZATION);
+		CategoryPoints.PosY.Add(Ping.Y * RADAR_FEED_POS_QUANTIZATION);
+		CategoryPoints.PosZ.Add(Ping.Z * RADAR_FEED_HEIGHT_QUANTIZATION);
+		CategoryPoints.Floors.Add(FloorBands.GetFloor(CategoryPoints.PosZ.Last()));
+		CategoryPoints.Flags.Add(ERadarPointFlags::CanShow | PingFlags);
+		CategoryPoints.ExpireTimes.Add(RadarFeedNet::ToLocalExpireTime(Ping.ExpireTime, ServerTimeQuantized, LocalTime));
+	}
+
+	UpdateFeedPoints();
+}
+
+uint16 AShooterRadarFeed::GetServerTimeQuantized() const
+{
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World->GetGameState();
+	return RadarFeedNet::QuantizeTime(GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds());
+}
+
+void AShooterRadarFeed::UpdateFeedPoints()
+{
+	const float LocalTime = GetWorld()->GetTimeSeconds();
+
+	for (FRadarFeedPoints& CategoryPoints : Points)
+	{
+		for (int32 i = 0; i < CategoryPoints.Num(); i++)
+		{
+			const float ExpireTime = CategoryPoints.ExpireTimes[i];
+			if (ExpireTime > 0.0f && LocalTime >= ExpireTime)
+			{
+				CategoryPoints.Flags[i] &= ~ERadarPointFlags::CanShow;
+			}
+		}
+	}
+}
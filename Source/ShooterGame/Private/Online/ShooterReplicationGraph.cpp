@@ -40,6 +40,10 @@
 *		to simulated connections at a low, steady frequency, and to take advantage of serialization sharing. Auto proxy player states are replicated at higher frequency (to the
 *		owning connection only) via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection.
 *		
+*		UShooterReplicationGraphNode_RadarFeed_ForConnection
+*		Connection specific node for AShooterRadarFeed: server authoritative radar points of the connection players. Feeds are rebuilt and returned at a fixed, low rate
+*		(ShooterRepGraph.RadarFeed.Rate) instead of their NetUpdateFrequency, so radar works for pawns out of connection relevancy and pawn cull distance can be kept small.
+*		
 *		UReplicationGraphNode_TearOff_ForConnection
 *		Connection specific node for handling tear off actors. This is created and managed in the base implementation of Replication Graph.
 *		
@@ -97,6 +101,8 @@
 #include "Online/ShooterPlayerState.h"
 #include "Weapons/ShooterWeapon.h"
 #include "Pickups/ShooterPickup.h"
+#include "Online/ShooterRadarFeed.h"
+#include "UI/ShooterRadarSubsystem.h"
 
 DEFINE_LOG_CATEGORY( LogShooterReplicationGraph );
 
@@ -124,6 +130,12 @@ static FAutoConsoleVariableRef CVarShooterRepDynamicActorFrequencyBuckets(TEXT("
 int32 CVar_ShooterRepGraph_DisableSpatialRebuilds = 1;
 static FAutoConsoleVariableRef CVarShooterRepDisableSpatialRebuilds(TEXT("ShooterRepGraph.DisableSpatialRebuilds"), CVar_ShooterRepGraph_DisableSpatialRebuilds, TEXT(""), ECVF_Default );
 
+float CVar_ShooterRepGraph_PawnCullDistance = 15000.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphPawnCullDistance(TEXT("ShooterRepGraph.PawnCullDistance"), CVar_ShooterRepGraph_PawnCullDistance, TEXT("Pawns cull distance (not squared). Radar doesn't need pawns relevancy since it's fed by AShooterRadarFeed"), ECVF_Default );
+
+float CVar_ShooterRepGraph_RadarFeedRate = 10.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphRadarFeedRate(TEXT("ShooterRepGraph.RadarFeed.Rate"), CVar_ShooterRepGraph_RadarFeedRate, TEXT("How many times per second radar feeds are rebuilt and replicated to their connection"), ECVF_Default );
+
 // ----------------------------------------------------------------------------------------------------------
 
 
@@ -196,6 +208,7 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	AddInfo( AReplicationGraphDebugActor::StaticClass(),			EClassRepNodeMapping::NotRouted);				// Not needed. Replicated special case inside RepGraph
 	AddInfo( AInfo::StaticClass(),									EClassRepNodeMapping::RelevantAllConnections);	// Non spatialized, relevant to all
 	AddInfo( AShooterPickup::StaticClass(),							EClassRepNodeMapping::Spatialize_Static);		// Spatialized and never moves. Routes to GridNode.
+	AddInfo( AShooterRadarFeed::StaticClass(),						EClassRepNodeMapping::NotRouted);				// Replicated via UShooterReplicationGraphNode_RadarFeed_ForConnection
 
 #if WITH_GAMEPLAY_DEBUGGER
 	AddInfo( AGameplayDebuggerCategoryReplicator::StaticClass(),	EClassRepNodeMapping::NotRouted);				// Replicated via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection
@@ -281,9 +294,15 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	PawnClassRepInfo.DistancePriorityScale = 1.f;
 	PawnClassRepInfo.StarvationPriorityScale = 1.f;
 	PawnClassRepInfo.ActorChannelFrameTimeout = 4;
-	PawnClassRepInfo.SetCullDistanceSquared(15000.f * 15000.f); // Yuck
+	PawnClassRepInfo.SetCullDistanceSquared(CVar_ShooterRepGraph_PawnCullDistance * CVar_ShooterRepGraph_PawnCullDistance);
 	SetClassInfo( APawn::StaticClass(), PawnClassRepInfo );
 
+	FClassReplicationInfo RadarFeedRepInfo;
+	RadarFeedRepInfo.DistancePriorityScale = 0.f;
+	RadarFeedRepInfo.ActorChannelFrameTimeout = 0;	// Gathered only at feed rate, channel must stay open in between
+	RadarFeedRepInfo.ReplicationPeriodFrame = 1;	// Rate is driven by UShooterReplicationGraphNode_RadarFeed_ForConnection
+	SetClassInfo( AShooterRadarFeed::StaticClass(), RadarFeedRepInfo );
+
 	FClassReplicationInfo PlayerStateRepInfo;
 	PlayerStateRepInfo.DistancePriorityScale = 0.f;
 	PlayerStateRepInfo.ActorChannelFrameTimeout = 0;
@@ -403,6 +422,9 @@ void UShooterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConn
 	RepGraphConnection->OnClientVisibleLevelNameRemove.AddUObject(AlwaysRelevantConnectionNode, &UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
 
 	AddConnectionGraphNode(AlwaysRelevantConnectionNode, RepGraphConnection);
+
+	UShooterReplicationGraphNode_RadarFeed_ForConnection* RadarFeedConnectionNode = CreateNewNode<UShooterReplicationGraphNode_RadarFeed_ForConnection>();
+	AddConnectionGraphNode(RadarFeedConnectionNode, RepGraphConnection);
 }
 
 EClassRepNodeMapping UShooterReplicationGraph::GetMappingPolicy(UClass* Class)
@@ -757,6 +779,50 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::LogNode(FReplica
 
 // ------------------------------------------------------------------------------
 
+void UShooterReplicationGraphNode_RadarFeed_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_RadarFeed_ForConnection_GatherActorListsForConnection );
+
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	const float GatherPeriod = CVar_ShooterRepGraph_RadarFeedRate > 0.f ? 1.f / CVar_ShooterRepGraph_RadarFeedRate : 0.f;
+	if (LastGatherTime >= 0.f && WorldTime - LastGatherTime < GatherPeriod)
+	{
+		return;
+	}
+	LastGatherTime = WorldTime;
+
+	ReplicationActorList.Reset();
+
+	for (const FNetViewer& CurViewer : Params.Viewers)
+	{
+		AShooterPlayerController* PC = Cast<AShooterPlayerController>(CurViewer.InViewer);
+		AShooterRadarFeed* RadarFeed = PC ? PC->GetRadarFeed() : nullptr;
+		if (RadarFeed == nullptr)
+		{
+			continue;
+		}
+
+		// Unchanged snapshot is still returned: it costs only property compare and keeps the channel alive
+		RadarFeed->BuildSnapshot();
+		ReplicationActorList.ConditionalAdd(RadarFeed);
+	}
+
+	if (ReplicationActorList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+	}
+}
+
+void UShooterReplicationGraphNode_RadarFeed_ForConnection::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+	LogActorRepList(DebugInfo, NodeName, ReplicationActorList);
+	DebugInfo.PopIndent();
+}
+
+// ------------------------------------------------------------------------------
+
 UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::UShooterReplicationGraphNode_PlayerStateFrequencyLimiter()
 {
 	bRequiresPrepareForReplicationCall = true;
@@ -871,3 +937,25 @@ FAutoConsoleCommandWithWorldAndArgs ChangeFrequencyBucketsCmd(TEXT("ShooterRepGr
 		Node->SetNonStreamingCollectionSize(Buckets);
 	}
 }));
+
+// ------------------------------------------------------------------------------
+
+FAutoConsoleCommandWithWorldAndArgs ShooterPrintRadarFeedStatsCmd(TEXT("ShooterRepGraph.RadarFeed.PrintStats"), TEXT("Prints radar feed bytes per second and enemy pings sent to each connection"), FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray< FString >& Args, UWorld* World)
+{
+	if (const UShooterRadarSubsystem* RadarModel = World ? World->GetSubsystem<UShooterRadarSubsystem>() : nullptr)
+	{
+		UE_LOG(LogShooterReplicationGraph, Display, TEXT("Enemy reveals generated: %u"), RadarModel->GetRevealsGenerated());
+	}
+
+	for (TObjectIterator<AShooterRadarFeed> It; It; ++It)
+	{
+		AShooterRadarFeed* RadarFeed = *It;
+		if (RadarFeed->HasAnyFlags(RF_ClassDefaultObject) || RadarFeed->GetLocalRole() != ROLE_Authority)
+		{
+			continue;
+		}
+
+		UNetConnection* Connection = RadarFeed->GetNetConnection();
+		UE_LOG(LogShooterReplicationGraph, Display, TEXT("%s (%s): %.1f bytes/sec, %u enemy pings transmitted"), *GetNameSafe(RadarFeed->GetOwner()), Connection ? *Connection->LowLevelGetRemoteAddress(true) : TEXT("no connection"), RadarFeed->GetBytesPerSecond(), RadarFeed->GetPingsTransmitted());
+	}
+}));
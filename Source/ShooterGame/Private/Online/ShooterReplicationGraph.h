@@ -120,6 +120,30 @@ private:
 	bool bInitializedPlayerState = false;
 };
 
+/** Connection specific node returning connection radar feeds at ShooterRepGraph.RadarFeed.Rate. Feed snapshots are rebuilt right before they are returned, so it's once per feed net update. */
+UCLASS()
+class UShooterReplicationGraphNode_RadarFeed_ForConnection : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override { }
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyResetAllNetworkActors() override { }
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+private:
+
+	FActorRepListRefView ReplicationActorList;
+
+	/** World time radar feeds of this connection were last gathered, negative if never */
+	float LastGatherTime = -1.f;
+};
+
 /** This is a specialized node for handling PlayerState replication in a frequency limited fashion. It tracks all player states but only returns a subset of them to the replication driver each frame. */
 UCLASS()
 class UShooterReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplicationGraphNode
@@ -12,7 +12,7 @@ AShooterPickup_Ammo::AShooterPickup_Ammo(const FObjectInitializer& ObjectInitial
 
 bool AShooterPickup_Ammo::IsForWeapon(UClass* WeaponClass)
 {
-	return WeaponType->IsChildOf(WeaponClass);
+	return WeaponType && WeaponType->IsChildOf(WeaponClass);
 }
 
 bool AShooterPickup_Ammo::CanBePickedUp(AShooterCharacter* TestPawn) const
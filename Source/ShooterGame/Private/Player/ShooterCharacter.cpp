@@ -5,6 +5,7 @@
 #include "Weapons/ShooterDamageType.h"
 #include "UI/ShooterHUD.h"
 #include "Online/ShooterPlayerState.h"
+#include "Weapons/ShooterHitValidation.h"
 #include "Animation/AnimMontage.h"
 #include "Animation/AnimInstance.h"
 #include "Sound/SoundNodeLocalPlayer.h"
@@ -88,6 +89,38 @@ void AShooterCharacter::BeginPlay()
 
 	FTimerHandle Handle;
 	GetWorld()->GetTimerManager().SetTimer(Handle, TimerCallback, 1.0f, false);
+
+	// server rewinds hitboxes to validate hits of remote clients
+	UShooterHitValidation* HitValidation = GetWorld()->GetSubsystem<UShooterHitValidation>();
+	if (HitValidation && GetLocalRole() == ROLE_Authority && GetNetMode() != NM_Standalone)
+	{
+		HitValidation->RegisterCharacter(this);
+		bRecordsHitboxes = true;
+		UpdatePawnMeshes();
+	}
+}
+
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UShooterHitValidation* HitValidation = GetWorld()->GetSubsystem<UShooterHitValidation>();
+	if (HitValidation)
+	{
+		HitValidation->UnregisterCharacter(this);
+	}
+	bRecordsHitboxes = false;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterCharacter::RecordHitboxes(float Time, int32 NumFrames)
+{
+	if (HitboxHistory.GetNumHitboxes() == 0)
+	{
+		HitboxHistory.SetHitboxesFromMesh(*GetMesh());
+	}
+
+	HitboxHistory.SetNumFrames(NumFrames);
+	HitboxHistory.RecordMesh(Time, *GetMesh());
 }
 
 void AShooterCharacter::PostInitializeComponents()
@@ -208,7 +241,8 @@ void AShooterCharacter::UpdatePawnMeshes()
 	Mesh1P->VisibilityBasedAnimTickOption = !bFirstPerson ? EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered : EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
 	Mesh1P->SetOwnerNoSee(!bFirstPerson);
 
-	GetMesh()->VisibilityBasedAnimTickOption = bFirstPerson ? EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered : EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	// listen server host's own pawn is first person, but its 3rd person pose is still recorded to validate hits on host
+	GetMesh()->VisibilityBasedAnimTickOption = bFirstPerson && !bRecordsHitboxes ? EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered : EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
 	GetMesh()->SetOwnerNoSee(bFirstPerson);
 }
 
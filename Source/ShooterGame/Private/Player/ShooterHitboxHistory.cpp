@@ -0,0 +1,218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Player/ShooterHitboxHistory.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+
+void FShooterHitboxHistory::SetHitboxes(TArrayView<const FShooterHitbox> InHitboxes)
+{
+	Hitboxes.Reset();
+	Hitboxes.Append(InHitboxes.GetData(), InHitboxes.Num());
+	AllocatePoses();
+}
+
+void FShooterHitboxHistory::SetHitboxesFromMesh(const USkeletalMeshComponent& Mesh)
+{
+	// poses drop bone scale, so mesh scale is baked into boxes
+	const FTransform MeshScale(FQuat::Identity, FVector::ZeroVector, Mesh.GetComponentScale());
+
+	TArray<FShooterHitbox> MeshHitboxes;
+	const UPhysicsAsset* PhysicsAsset = Mesh.GetPhysicsAsset();
+	if (PhysicsAsset)
+	{
+		for (const USkeletalBodySetup* BodySetup : PhysicsAsset->SkeletalBodySetups)
+		{
+			const int32 BoneIndex = BodySetup ? Mesh.GetBoneIndex(BodySetup->BoneName) : INDEX_NONE;
+			if (BoneIndex != INDEX_NONE)
+			{
+				const FBox Box = BodySetup->AggGeom.CalcAABB(MeshScale);
+				MeshHitboxes.Add({ BoneIndex, Box.GetCenter(), Box.GetExtent() });
+			}
+		}
+	}
+
+	if (MeshHitboxes.Num() == 0)
+	{
+		const FBox Box = Mesh.CalcBounds(MeshScale).GetBox();
+		MeshHitboxes.Add({ INDEX_NONE, Box.GetCenter(), Box.GetExtent() });
+	}
+
+	SetHitboxes(MeshHitboxes);
+}
+
+void FShooterHitboxHistory::SetNumFrames(int32 InNumFrames)
+{
+	InNumFrames = FMath::Clamp(InNumFrames, 2, MaxFrames);
+	if (InNumFrames != NumFrames)
+	{
+		NumFrames = InNumFrames;
+		AllocatePoses();
+	}
+}
+
+void FShooterHitboxHistory::AllocatePoses()
+{
+	Frames.Reset();
+	Frames.SetCapacity(NumFrames);
+	NextPoseSlot = 0;
+
+	Poses.Empty(NumFrames * Hitboxes.Num());
+	Poses.SetNumUninitialized(NumFrames * Hitboxes.Num());
+}
+
+TArrayView<FShooterHitboxTransform> FShooterHitboxHistory::AddFrame(float Time)
+{
+	checkSlow(Frames.IsEmpty() || Time >= GetNewestTime());
+
+	// full buffer overwrites its oldest frame, which owns this slot
+	const int32 PoseIndex = NextPoseSlot * Hitboxes.Num();
+	NextPoseSlot = (NextPoseSlot + 1) % NumFrames;
+
+	Frames.Add({ Time, PoseIndex });
+	return TArrayView<FShooterHitboxTransform>(Poses.GetData() + PoseIndex, Hitboxes.Num());
+}
+
+void FShooterHitboxHistory::RecordMesh(float Time, const USkeletalMeshComponent& Mesh)
+{
+	const FTransform& ComponentTransform = Mesh.GetComponentTransform();
+	const TArray<FTransform>& BoneTransforms = Mesh.GetComponentSpaceTransforms();
+
+	TArrayView<FShooterHitboxTransform> Pose = AddFrame(Time);
+	for (int32 i = 0; i < Hitboxes.Num(); i++)
+	{
+		const int32 BoneIndex = Hitboxes[i].BoneIndex;
+		const FTransform Transform = BoneTransforms.IsValidIndex(BoneIndex) ? BoneTransforms[BoneIndex] * ComponentTransform : ComponentTransform;
+		Pose[i].Rotation = Transform.GetRotation();
+		Pose[i].Location = Transform.GetLocation();
+	}
+}
+
+void FShooterHitboxHistory::Reset()
+{
+	Frames.Reset();
+	NextPoseSlot = 0;
+}
+
+void FShooterHitboxHistory::FindFrames(float Time, int32& OutFrom, int32& OutTo, float& OutAlpha) const
+{
+	const int32 Num = Frames.Num();
+	if (Time <= Frames[0].Time)
+	{
+		OutFrom = OutTo = 0;
+		OutAlpha = 0.0f;
+		return;
+	}
+
+	if (Time >= Frames[Num - 1].Time)
+	{
+		OutFrom = OutTo = Num - 1;
+		OutAlpha = 0.0f;
+		return;
+	}
+
+	// first frame after Time, frame times increase
+	int32 Low = 1;
+	int32 High = Num - 1;
+	while (Low < High)
+	{
+		const int32 Middle = (Low + High) / 2;
+		if (Frames[Middle].Time > Time)
+		{
+			High = Middle;
+		}
+		else
+		{
+			Low = Middle + 1;
+		}
+	}
+
+	OutFrom = Low - 1;
+	OutTo = Low;
+
+	const float FrameTime = Frames[OutTo].Time - Frames[OutFrom].Time;
+	OutAlpha = FrameTime > 0.0f ? (Time - Frames[OutFrom].Time) / FrameTime : 0.0f;
+}
+
+FShooterHitboxTransform FShooterHitboxHistory::BlendTransform(int32 Hitbox, const FFrame& From, const FFrame& To, float Alpha) const
+{
+	const FShooterHitboxTransform& FromTransform = Poses[From.PoseIndex + Hitbox];
+	if (Alpha <= 0.0f)
+	{
+		return FromTransform;
+	}
+
+	const FShooterHitboxTransform& ToTransform = Poses[To.PoseIndex + Hitbox];
+
+	FShooterHitboxTransform Result;
+	Result.Rotation = FQuat::FastLerp(FromTransform.Rotation, ToTransform.Rotation, Alpha).GetNormalized();
+	Result.Location = FMath::Lerp(FromTransform.Location, ToTransform.Location, Alpha);
+	return Result;
+}
+
+bool FShooterHitboxHistory::IsInHitbox(const FShooterHitbox& Hitbox, const FShooterHitboxTransform& Transform, const FVector& Location, float Leeway) const
+{
+	const FVector Local = Transform.Rotation.UnrotateVector(Location - Transform.Location) - Hitbox.Center;
+	return FMath::Abs(Local.X) <= Hitbox.Extent.X + Leeway
+		&& FMath::Abs(Local.Y) <= Hitbox.Extent.Y + Leeway
+		&& FMath::Abs(Local.Z) <= Hitbox.Extent.Z + Leeway;
+}
+
+bool FShooterHitboxHistory::Rewind(float Time, TArray<FShooterHitboxTransform>& OutPose) const
+{
+	if (Frames.IsEmpty())
+	{
+		return false;
+	}
+
+	int32 From, To;
+	float Alpha;
+	FindFrames(Time, From, To, Alpha);
+
+	OutPose.SetNumUninitialized(Hitboxes.Num(), false);
+	for (int32 i = 0; i < Hitboxes.Num(); i++)
+	{
+		OutPose[i] = BlendTransform(i, Frames[From], Frames[To], Alpha);
+	}
+
+	return true;
+}
+
+bool FShooterHitboxHistory::IsInPose(TArrayView<const FShooterHitboxTransform> Pose, const FVector& Location, float Leeway) const
+{
+	check(Pose.Num() == Hitboxes.Num());
+
+	for (int32 i = 0; i < Hitboxes.Num(); i++)
+	{
+		if (IsInHitbox(Hitboxes[i], Pose[i], Location, Leeway))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FShooterHitboxHistory::ValidateHit(float Time, const FVector& Location, float Leeway) const
+{
+	if (Frames.IsEmpty())
+	{
+		return false;
+	}
+
+	int32 From, To;
+	float Alpha;
+	FindFrames(Time, From, To, Alpha);
+
+	// stop at first hitbox containing hit, pose of other hitboxes is never blended
+	for (int32 i = 0; i < Hitboxes.Num(); i++)
+	{
+		if (IsInHitbox(Hitboxes[i], BlendTransform(i, Frames[From], Frames[To], Alpha), Location, Leeway))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
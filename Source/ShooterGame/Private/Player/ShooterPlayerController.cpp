@@ -6,6 +6,7 @@
 #include "Player/ShooterCheatManager.h"
 #include "Player/ShooterLocalPlayer.h"
 #include "Online/ShooterPlayerState.h"
+#include "Online/ShooterRadarFeed.h"
 #include "Weapons/ShooterWeapon.h"
 #include "UI/Menu/ShooterIngameMenu.h"
 #include "UI/Style/ShooterStyle.h"
@@ -59,6 +60,7 @@ AShooterPlayerController::AShooterPlayerController(const FObjectInitializer& Obj
 	bAllowGameActions = true;
 	bGameEndedFrame = false;
 	LastDeathLocation = FVector::ZeroVector;
+	RadarFeed = nullptr;
 
 	ServerSayString = TEXT("Say");
 	ShooterFriendUpdateTimer = 0.0f;
@@ -979,6 +981,39 @@ void AShooterPlayerController::GetLifetimeReplicatedProps( TArray< FLifetimeProp
 	DOREPLIFETIME_CONDITION( AShooterPlayerController, bInfiniteClip, COND_OwnerOnly );
 
 	DOREPLIFETIME(AShooterPlayerController, bHealthRegen);
+
+	DOREPLIFETIME_CONDITION( AShooterPlayerController, RadarFeed, COND_OwnerOnly );
+}
+
+void AShooterPlayerController::InitRadarFeed()
+{
+	if (GetLocalRole() < ROLE_Authority || IsLocalController())
+	{
+		return;
+	}
+
+	// controller kept by seamless travel still points to feed destroyed with previous world
+	if (IsValid(RadarFeed) && RadarFeed->GetWorld() == GetWorld())
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.Owner = this;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+	RadarFeed = GetWorld()->SpawnActor<AShooterRadarFeed>(SpawnInfo);
+}
+
+void AShooterPlayerController::Destroyed()
+{
+	if (RadarFeed)
+	{
+		RadarFeed->Destroy();
+		RadarFeed = nullptr;
+	}
+
+	Super::Destroyed();
 }
 
 void AShooterPlayerController::Suicide()
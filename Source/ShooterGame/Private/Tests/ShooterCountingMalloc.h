@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+/*
+ * GMalloc proxy counting allocations made on game thread, radar runs on game thread only,
+ * so count delta over radar update/draw is exactly what radar allocates.
+ * Installed only while FShooterCountingMallocScope is alive.
+ */
+class FShooterCountingMalloc : public FMalloc
+{
+public:
+	/** Proxy is created on first call and never deleted: other threads may still be inside its calls after it's removed */
+	static FShooterCountingMalloc& Get()
+	{
+		static FShooterCountingMalloc* Instance = nullptr;
+		if (Instance == nullptr)
+		{
+			Instance = new FShooterCountingMalloc(GMalloc);
+		}
+		return *Instance;
+	}
+
+	bool IsInstalled() const { return GMalloc == this; }
+
+	/** Wrap current GMalloc and replace it, memory allocated through proxy is owned by wrapped allocator */
+	void Install()
+	{
+		check(IsInGameThread() && !IsInstalled());
+		InnerMalloc = GMalloc;
+		GMalloc = this;
+	}
+
+	/** Restore wrapped GMalloc, unless something replaced proxy since */
+	void Uninstall()
+	{
+		check(IsInGameThread());
+		if (IsInstalled())
+		{
+			GMalloc = InnerMalloc;
+		}
+	}
+
+	uint64 GetNumGameThreadAllocs() const { return NumGameThreadAllocs; }
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override { CountAlloc(); return InnerMalloc->Malloc(Count, Alignment); }
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override { CountAlloc(); return InnerMalloc->TryMalloc(Count, Alignment); }
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override { CountAlloc(); return InnerMalloc->Realloc(Original, Count, Alignment); }
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override { CountAlloc(); return InnerMalloc->TryRealloc(Original, Count, Alignment); }
+	virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { InnerMalloc->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void UpdateStats() override { InnerMalloc->UpdateStats(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { InnerMalloc->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { InnerMalloc->DumpAllocatorStats(Ar); }
+	virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+	virtual const TCHAR* GetDescriptiveName() override { return InnerMalloc->GetDescriptiveName(); }
+
+private:
+	explicit FShooterCountingMalloc(FMalloc* InInnerMalloc) : InnerMalloc(InInnerMalloc) {}
+
+	void CountAlloc()
+	{
+		if (IsInGameThread())
+		{
+			NumGameThreadAllocs++;
+		}
+	}
+
+	FMalloc* InnerMalloc;
+
+	/** Touched by game thread only */
+	uint64 NumGameThreadAllocs = 0;
+};
+
+/*
+ * Counting proxy installed as GMalloc for lifetime of scope, previous GMalloc is restored when it ends
+ */
+class FShooterCountingMallocScope
+{
+public:
+	FShooterCountingMallocScope() { FShooterCountingMalloc::Get().Install(); }
+	~FShooterCountingMallocScope() { FShooterCountingMalloc::Get().Uninstall(); }
+
+	uint64 GetNumGameThreadAllocs() const { return FShooterCountingMalloc::Get().GetNumGameThreadAllocs(); }
+};
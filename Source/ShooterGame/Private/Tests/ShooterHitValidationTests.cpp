@@ -0,0 +1,430 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ShooterGame.h"
+#include "Misc/AutomationTest.h"
+#include "Player/ShooterCharacter.h"
+#include "Player/ShooterHitboxHistory.h"
+#include "Tests/ShooterTestWorld.h"
+#include "Weapons/ShooterHitValidation.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterHitValidationTests
+{
+	/** Record interval of histories in tests, default ShooterHitValidation.RecordRate */
+	const float RecordInterval = 1.0f / 60.0f;
+
+	/** Frames of default 0.5 s window at 60 Hz */
+	const int32 WindowFrames = 31;
+
+	/** Bodies of typical character physics asset */
+	const int32 CharacterHitboxes = 20;
+
+	/** Add frame at Time with all hitboxes at Location rotated by Yaw */
+	void AddFrame(FShooterHitboxHistory& History, float Time, const FVector& Location, float Yaw = 0.0f)
+	{
+		const FQuat Rotation(FVector::UpVector, FMath::DegreesToRadians(Yaw));
+		for (FShooterHitboxTransform& Transform : History.AddFrame(Time))
+		{
+			Transform.Rotation = Rotation;
+			Transform.Location = Location;
+		}
+	}
+
+	/** Synthetic character: stacked body boxes following its root, running in circles */
+	struct FCharacterTestData
+	{
+		FShooterHitboxHistory History;
+		FVector Start;
+		FVector Direction;
+
+		explicit FCharacterTestData(FRandomStream& Random)
+		{
+			TArray<FShooterHitbox> Hitboxes;
+			for (int32 i = 0; i < CharacterHitboxes; i++)
+			{
+				Hitboxes.Add({ i, FVector(0.0f, 0.0f, i * 9.0f), FVector(Random.FRandRange(5.0f, 15.0f), Random.FRandRange(5.0f, 15.0f), 8.0f) });
+			}
+
+			History.SetHitboxes(Hitboxes);
+			History.SetNumFrames(WindowFrames);
+
+			Start = FVector(Random.FRandRange(-5000.0f, 5000.0f), Random.FRandRange(-5000.0f, 5000.0f), 0.0f);
+			Direction = Random.GetUnitVector() * 600.0f;
+		}
+
+		FVector GetLocation(float Time) const
+		{
+			return Start + Direction * FMath::Sin(Time);
+		}
+
+		void Record(float Time)
+		{
+			AddFrame(History, Time, GetLocation(Time), Time * 90.0f);
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterHitboxHistoryRewindTest, "ShooterGame.HitValidation.HitboxHistory.Rewind",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterHitboxHistoryRewindTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterHitValidationTests;
+
+	const FShooterHitbox Hitbox = { INDEX_NONE, FVector(0.0f, 0.0f, 50.0f), FVector(20.0f, 20.0f, 50.0f) };
+	FShooterHitboxHistory History;
+	History.SetHitboxes(MakeArrayView(&Hitbox, 1));
+	History.SetNumFrames(WindowFrames);
+
+	TestFalse(TEXT("Empty history validates nothing"), History.ValidateHit(0.0f, FVector::ZeroVector, 100.0f));
+
+	// target runs along X at 600 cm/s, more frames than history keeps
+	const float Speed = 600.0f;
+	const int32 NumRecorded = 100;
+	for (int32 i = 0; i < NumRecorded; i++)
+	{
+		const float Time = i * RecordInterval;
+		AddFrame(History, Time, FVector(Speed * Time, 0.0f, 0.0f));
+	}
+
+	TestEqual(TEXT("History keeps window frames"), History.GetNumFrames(), WindowFrames);
+	TestEqual(TEXT("Oldest frame is overwritten"), History.GetOldestTime(), (NumRecorded - WindowFrames) * RecordInterval);
+	TestEqual(TEXT("Newest frame"), History.GetNewestTime(), (NumRecorded - 1) * RecordInterval);
+
+	// hit at pose client saw 0.3 s ago
+	const float Now = History.GetNewestTime();
+	const float ShotTime = Now - 0.3f;
+	const FVector SeenCenter(Speed * ShotTime, 0.0f, 50.0f);
+	TestTrue(TEXT("Hit at rewound pose is valid"), History.ValidateHit(ShotTime, SeenCenter, 0.0f));
+	TestFalse(TEXT("Same hit at current pose is invalid"), History.ValidateHit(Now, SeenCenter, 0.0f));
+
+	// between frames pose is interpolated
+	const float MidTime = ShotTime + RecordInterval * 0.5f;
+	const float MidX = Speed * MidTime;
+	TestTrue(TEXT("Interpolated box contains its edge"), History.ValidateHit(MidTime, FVector(MidX + 19.5f, 0.0f, 50.0f), 0.0f));
+	TestFalse(TEXT("Interpolated box ends at its extent"), History.ValidateHit(MidTime, FVector(MidX + 20.5f, 0.0f, 50.0f), 0.0f));
+	TestTrue(TEXT("Leeway grows box"), History.ValidateHit(MidTime, FVector(MidX + 25.0f, 0.0f, 50.0f), 10.0f));
+	TestFalse(TEXT("Box has its height"), History.ValidateHit(MidTime, FVector(MidX, 0.0f, 101.0f), 0.0f));
+
+	// shots older than history are checked against oldest pose
+	const FVector OldestCenter(Speed * History.GetOldestTime(), 0.0f, 50.0f);
+	TestTrue(TEXT("Old shot is clamped to oldest frame"), History.ValidateHit(History.GetOldestTime() - 1.0f, OldestCenter, 0.0f));
+
+	// rewound pose agrees with direct validation
+	TArray<FShooterHitboxTransform> Pose;
+	TestTrue(TEXT("Rewind"), History.Rewind(MidTime, Pose));
+	for (float OffsetX = -30.0f; OffsetX <= 30.0f; OffsetX += 3.0f)
+	{
+		const FVector Location(MidX + OffsetX, 5.0f, 50.0f);
+		TestTrue(TEXT("Rewound pose matches direct validation"), History.IsInPose(Pose, Location, 0.0f) == History.ValidateHit(MidTime, Location, 0.0f));
+	}
+
+	// hitbox follows bone rotation
+	const FShooterHitbox LongHitbox = { INDEX_NONE, FVector::ZeroVector, FVector(100.0f, 10.0f, 10.0f) };
+	FShooterHitboxHistory Rotated;
+	Rotated.SetHitboxes(MakeArrayView(&LongHitbox, 1));
+	AddFrame(Rotated, 0.0f, FVector::ZeroVector, 90.0f);
+	TestTrue(TEXT("Rotated box spans Y"), Rotated.ValidateHit(0.0f, FVector(0.0f, 90.0f, 0.0f), 0.0f));
+	TestFalse(TEXT("Rotated box doesn't span X"), Rotated.ValidateHit(0.0f, FVector(90.0f, 0.0f, 0.0f), 0.0f));
+
+	// memory is bounded by window and recording doesn't grow it
+	const SIZE_T WindowSize = History.GetAllocatedSize();
+	AddFrame(History, Now + RecordInterval, FVector::ZeroVector);
+	TestTrue(TEXT("Recording doesn't allocate"), History.GetAllocatedSize() == WindowSize);
+
+	History.SetNumFrames(WindowFrames * 2);
+	TestTrue(TEXT("Longer window takes more memory"), History.GetAllocatedSize() > WindowSize);
+	TestTrue(TEXT("Window change clears history"), History.IsEmpty());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterHitValidationWindowTest, "ShooterGame.HitValidation.HistoryWindow.Clamped",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterHitValidationWindowTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterHitValidationTests;
+
+	IConsoleVariable* HistoryWindow = IConsoleManager::Get().FindConsoleVariable(TEXT("ShooterHitValidation.HistoryWindow"));
+	IConsoleVariable* RecordRate = IConsoleManager::Get().FindConsoleVariable(TEXT("ShooterHitValidation.RecordRate"));
+	const float OldHistoryWindow = HistoryWindow->GetFloat();
+	const float OldRecordRate = RecordRate->GetFloat();
+
+	RecordRate->Set(60.0f, ECVF_SetByCode);
+	HistoryWindow->Set(0.5f, ECVF_SetByCode);
+	TestEqual(TEXT("Window fitting history is kept"), UShooterHitValidation::GetHistoryWindow(), 0.5f);
+	TestEqual(TEXT("Window frames"), UShooterHitValidation::GetHistoryFrames(), WindowFrames);
+
+	// 5 s at 60 Hz is 301 frames, history keeps 128
+	HistoryWindow->Set(5.0f, ECVF_SetByCode);
+	const float MaxWindow = (FShooterHitboxHistory::MaxFrames - 1) * RecordInterval;
+	TestEqual(TEXT("Window is clamped to history capacity"), UShooterHitValidation::GetHistoryWindow(), MaxWindow, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Clamped window frames"), UShooterHitValidation::GetHistoryFrames(), FShooterHitboxHistory::MaxFrames);
+
+	// lower rate fits longer window in the same frames
+	RecordRate->Set(30.0f, ECVF_SetByCode);
+	TestEqual(TEXT("Window is clamped at record rate"), UShooterHitValidation::GetHistoryWindow(), (FShooterHitboxHistory::MaxFrames - 1) / 30.0f, KINDA_SMALL_NUMBER);
+
+	HistoryWindow->Set(OldHistoryWindow, ECVF_SetByCode);
+	RecordRate->Set(OldRecordRate, ECVF_SetByCode);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterHitValidationBenchmark, "ShooterGame.HitValidation.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterHitValidationBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace ShooterHitValidationTests;
+
+	const int32 NumPlayers = 64;
+	const int32 NumRecorded = 120;
+	const int32 NumHits = 100000;
+
+	FRandomStream Random(64);
+	TArray<TUniquePtr<FCharacterTestData>> Players;
+	for (int32 i = 0; i < NumPlayers; i++)
+	{
+		Players.Add(MakeUnique<FCharacterTestData>(Random));
+	}
+
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < NumRecorded; Frame++)
+	{
+		for (const TUniquePtr<FCharacterTestData>& Player : Players)
+		{
+			Player->Record(Frame * RecordInterval);
+		}
+	}
+	const double RecordTime = (FPlatformTime::Seconds() - StartTime) / NumRecorded;
+
+	SIZE_T Memory = 0;
+	for (const TUniquePtr<FCharacterTestData>& Player : Players)
+	{
+		Memory += Player->History.GetAllocatedSize() + sizeof(FShooterHitboxHistory);
+	}
+
+	// hits on random players within window, half of them near their body so some hitboxes are tested to the end
+	struct FTestHit
+	{
+		int32 Player;
+		float Time;
+		FVector Location;
+	};
+
+	const float Now = (NumRecorded - 1) * RecordInterval;
+	TArray<FTestHit> Hits;
+	for (int32 i = 0; i < NumHits; i++)
+	{
+		const int32 Player = Random.RandHelper(NumPlayers);
+		const float Time = Now - Random.FRandRange(0.0f, 0.5f);
+		const FVector Offset = (i % 2 ? FVector(0.0f, 0.0f, Random.FRandRange(0.0f, 180.0f)) : FVector::ZeroVector) + Random.GetUnitVector() * 30.0f;
+		Hits.Add({ Player, Time, Players[Player]->GetLocation(Time) + Offset });
+	}
+
+	int32 NumValid = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (const FTestHit& Hit : Hits)
+	{
+		NumValid += Players[Hit.Player]->History.ValidateHit(Hit.Time, Hit.Location, 10.0f);
+	}
+	const double ValidateTime = (FPlatformTime::Seconds() - StartTime) / NumHits;
+
+	TArray<FShooterHitboxTransform> Pose;
+	int32 NumValidInPose = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (const FTestHit& Hit : Hits)
+	{
+		const FShooterHitboxHistory& History = Players[Hit.Player]->History;
+		History.Rewind(Hit.Time, Pose);
+		NumValidInPose += History.IsInPose(Pose, Hit.Location, 10.0f);
+	}
+	const double RewindTime = (FPlatformTime::Seconds() - StartTime) / NumHits;
+
+	TestEqual(TEXT("Rewound pose validates the same hits"), NumValidInPose, NumValid);
+
+	AddInfo(FString::Printf(TEXT("%d players, %d hitboxes, %d frames: record %.2f us per frame, %.1f KB history"),
+		NumPlayers, CharacterHitboxes, WindowFrames, RecordTime * 1e6, Memory / 1024.0));
+	AddInfo(FString::Printf(TEXT("Per hit: validate %.1f ns, rewind whole pose %.1f ns, %d of %d hits valid"),
+		ValidateTime * 1e9, RewindTime * 1e9, NumValid, NumHits));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterHitQueueTest, "ShooterGame.HitValidation.Queue.MatchesImmediate",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterHitQueueTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterHitValidationTests;
+
+	UClass* CharacterClass = LoadClass<AShooterCharacter>(nullptr, TEXT("/Game/Blueprints/Pawns/PlayerPawn.PlayerPawn_C"));
+	if (!TestNotNull(TEXT("Character class"), CharacterClass))
+	{
+		return false;
+	}
+
+	IConsoleVariable* MinParallelTargets = IConsoleManager::Get().FindConsoleVariable(TEXT("ShooterHitValidation.MinParallelTargets"));
+	const int32 OldMinParallelTargets = MinParallelTargets->GetInt();
+
+	// game thread and worker thread batches of the same claims
+	const int32 MinParallelValues[] = { 1000, 1 };
+	TArray<uint8> FirstVerdicts;
+	for (const int32 MinParallel : MinParallelValues)
+	{
+		MinParallelTargets->Set(MinParallel, ECVF_SetByCode);
+
+		ShooterTests::FScopedTestWorld TestWorld;
+		UShooterHitValidation* HitValidation = TestWorld.World->GetSubsystem<UShooterHitValidation>();
+		if (!TestNotNull(TEXT("Hit validation subsystem"), HitValidation))
+		{
+			break;
+		}
+
+		TArray<AActor*> Targets;
+		for (int32 i = 0; i < 6; i++)
+		{
+			Targets.Add(TestWorld.SpawnBlockingBox(FVector(i * 1000.0f, 0.0f, 100.0f), FVector(40.0f, 40.0f, 90.0f)));
+		}
+
+		// characters running along Y with recorded history
+		const FVector Velocity(0.0f, 600.0f, 0.0f);
+		const int32 NumRecorded = 30;
+		TArray<AShooterCharacter*> Characters;
+		for (int32 i = 0; i < 3; i++)
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			AShooterCharacter* Character = TestWorld.World->SpawnActor<AShooterCharacter>(CharacterClass, FVector(i * 1000.0f, 3000.0f, 100.0f), FRotator::ZeroRotator, SpawnParams);
+			if (Character)
+			{
+				HitValidation->RegisterCharacter(Character);
+				Characters.Add(Character);
+			}
+		}
+
+		if (!TestEqual(TEXT("Characters are spawned"), Characters.Num(), 3))
+		{
+			break;
+		}
+
+		for (int32 Frame = 0; Frame < NumRecorded; Frame++)
+		{
+			for (int32 i = 0; i < Characters.Num(); i++)
+			{
+				const float Time = Frame * RecordInterval;
+				Characters[i]->SetActorLocation(FVector(i * 1000.0f, 3000.0f, 100.0f) + Velocity * Time);
+				Characters[i]->RecordHitboxes(Time, UShooterHitValidation::GetHistoryFrames());
+			}
+		}
+
+		// first character is shot by one client, its claims share shot time, others by clients seeing them at different times
+		const float SharedShotTime = 12.0f * RecordInterval;
+		const float ShotTimes[] = { 4.0f * RecordInterval, SharedShotTime, 12.5f * RecordInterval, 22.0f * RecordInterval };
+		TMap<const AActor*, TSet<float>> TargetShotTimes;
+
+		// claims on and around targets, without weapon to confirm them to, verdicts of one by one validation as without batch
+		FRandomStream Random(25);
+		const float BoundsScale = 1.2f;
+		const int32 NumClaims = 200;
+		TArray<uint8> ExpectedVerdicts;
+		uint32 ExpectedValid = 0;
+		int32 NumHistoryClaims = 0;
+		int32 NumHistoryValid = 0;
+		for (int32 i = 0; i < NumClaims; i++)
+		{
+			const int32 TargetIndex = Random.RandHelper(Targets.Num() + Characters.Num());
+			const bool bIsCharacter = TargetIndex >= Targets.Num();
+			AActor* Target = bIsCharacter ? Characters[TargetIndex - Targets.Num()] : Targets[TargetIndex];
+
+			const float ShotTime = !bIsCharacter ? 0.0f : Target == Characters[0] ? SharedShotTime : ShotTimes[Random.RandHelper(UE_ARRAY_COUNT(ShotTimes))];
+			const FVector Center = bIsCharacter ? Target->GetActorLocation() - Velocity * ((NumRecorded - 1) * RecordInterval - ShotTime) : Target->GetActorLocation();
+			const FVector Offset = bIsCharacter ? FVector(Random.FRandRange(-60.0f, 60.0f), Random.FRandRange(-60.0f, 60.0f), Random.FRandRange(-100.0f, 100.0f))
+				: Random.GetUnitVector() * Random.FRandRange(0.0f, 150.0f);
+
+			FShooterHitClaim Claim;
+			Claim.Impact = FHitResult(Target, nullptr, Center + Offset, FVector::UpVector);
+			Claim.Origin = FVector::ZeroVector;
+			Claim.ShootDir = FVector::ForwardVector;
+			Claim.RandomSeed = i;
+			Claim.ReticleSpread = 0.0f;
+			Claim.ShotTime = ShotTime;
+			Claim.BoundsScale = BoundsScale;
+			Claim.QueueTime = FPlatformTime::Seconds();
+			HitValidation->QueueHit(Claim);
+
+			if (HitValidation->HasHistory(Target))
+			{
+				const bool bIsValid = HitValidation->ValidateHit(Target, Claim.Impact.Location, ShotTime);
+				ExpectedVerdicts.Add(bIsValid);
+				TargetShotTimes.FindOrAdd(Target).Add(ShotTime);
+				NumHistoryClaims++;
+				NumHistoryValid += bIsValid;
+			}
+			else
+			{
+				ExpectedVerdicts.Add(UShooterHitValidation::IsInScaledBounds(Target->GetComponentsBoundingBox(), Claim.Impact.Location, BoundsScale));
+			}
+			ExpectedValid += ExpectedVerdicts.Last();
+		}
+
+		AActor* RemovedTarget = TestWorld.SpawnBlockingBox(FVector(0.0f, 1000.0f, 100.0f), FVector(40.0f, 40.0f, 90.0f));
+		FShooterHitClaim RemovedClaim;
+		RemovedClaim.Impact = FHitResult(RemovedTarget, nullptr, RemovedTarget->GetActorLocation(), FVector::UpVector);
+		RemovedClaim.ShotTime = 0.0f;
+		RemovedClaim.BoundsScale = BoundsScale;
+		RemovedClaim.QueueTime = FPlatformTime::Seconds();
+		HitValidation->QueueHit(RemovedClaim);
+		RemovedTarget->Destroy();
+
+		// every history target shares pose between claims with the same shot time
+		uint32 ExpectedPoses = 0;
+		for (const TPair<const AActor*, TSet<float>>& TargetTimes : TargetShotTimes)
+		{
+			ExpectedPoses += TargetTimes.Value.Num();
+		}
+
+		TestEqual(TEXT("Characters have history"), TargetShotTimes.Num(), Characters.Num());
+		TestTrue(TEXT("Claims share shot time"), TargetShotTimes.FindChecked(Characters[0]).Num() == 1);
+		TestTrue(TEXT("Claims differ in shot time"), TargetShotTimes.FindChecked(Characters[1]).Num() > 1 && TargetShotTimes.FindChecked(Characters[2]).Num() > 1);
+		TestTrue(TEXT("History claims are both valid and invalid"), NumHistoryValid > 0 && NumHistoryValid < NumHistoryClaims);
+
+		const uint32 ImmediateValidated = HitValidation->GetNumValidated();
+		const uint32 ImmediateRejected = HitValidation->GetNumRejected();
+
+		TestEqual(TEXT("Claims are queued"), HitValidation->GetQueueDepth(), NumClaims + 1);
+		HitValidation->ProcessQueue();
+
+		TestEqual(TEXT("Queue is empty after batch"), HitValidation->GetQueueDepth(), 0);
+
+		const TArrayView<const uint8> Verdicts = HitValidation->GetLastVerdicts();
+		if (TestEqual(TEXT("Verdict per claim"), Verdicts.Num(), NumClaims + 1))
+		{
+			for (int32 i = 0; i < NumClaims; i++)
+			{
+				TestTrue(TEXT("Batch verdict matches one by one validation"), Verdicts[i] == ExpectedVerdicts[i]);
+			}
+			TestTrue(TEXT("Claim on removed target is rejected"), Verdicts[NumClaims] == 0);
+		}
+
+		if (FirstVerdicts.Num() > 0)
+		{
+			TestTrue(TEXT("Worker thread batch matches game thread batch"), FirstVerdicts == TArray<uint8>(Verdicts.GetData(), Verdicts.Num()));
+		}
+		FirstVerdicts = TArray<uint8>(Verdicts.GetData(), Verdicts.Num());
+
+		TestTrue(TEXT("Batch validates the same hits"), HitValidation->GetNumValidated() - ImmediateValidated == ExpectedValid);
+		TestTrue(TEXT("Claim on removed target is dropped"), HitValidation->GetNumValidated() - ImmediateValidated + HitValidation->GetNumRejected() - ImmediateRejected == (uint32)NumClaims);
+		TestEqual(TEXT("Queue depth is tracked"), HitValidation->GetMaxQueueDepth(), NumClaims + 1);
+		TestTrue(TEXT("Latency is tracked"), HitValidation->GetAverageLatency() >= 0.0 && HitValidation->GetMaxLatency() >= HitValidation->GetAverageLatency());
+		TestTrue(TEXT("Pose is rewound once per target and shot time"), HitValidation->GetNumPosesRewound() == ExpectedPoses);
+	}
+
+	MinParallelTargets->Set(OldMinParallelTargets, ECVF_SetByCode);
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,1228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ShooterGame.h"
+#include "Misc/AutomationTest.h"
+#include "UI/ShooterRadarCollector.h"
+#include "UI/ShooterRadarSubsystem.h"
+#include "UI/ShooterRadarProjection.h"
+#include "UI/ShooterRadarIconBatch.h"
+#include "Online/ShooterRadarFeed.h"
+#include "UI/ShooterRadarCategories.h"
+#include "UI/ShooterRadarSpotter.h"
+#include "UI/ShooterRadarTimeline.h"
+#include "UI/ShooterRadarMinimap.h"
+#include "Player/ShooterCharacter.h"
+#include "Tests/ShooterCountingMalloc.h"
+#include "Tests/ShooterTestWorld.h"
+#include "Pickups/ShooterPickup_Health.h"
+#include "Pickups/ShooterPickup_Ammo.h"
+#include "Weapons/ShooterWeapon_Projectile.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterRadarTests
+{
+	using ShooterTests::FScopedTestWorld;
+
+	/** Average seconds per synthetic shot event (Find + Show) for registry of PointsNum points */
+	double MeasureShotEventCost(FScopedTestWorld& TestWorld, int32 PointsNum, int32 EventsNum)
+	{
+		TArray<AActor*> Actors;
+		TestWorld.SpawnActors(PointsNum, Actors);
+
+		FRadarPointRegistry Registry;
+		for (AActor* Actor : Actors)
+		{
+			bool bAdded;
+			Registry.FindOrAdd(Actor, FRadarPoint(), bAdded);
+		}
+
+		FRandomStream Random(PointsNum);
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < EventsNum; i++)
+		{
+			const int32 Index = Registry.Find(Actors[Random.RandHelper(PointsNum)]);
+			if (Index != INDEX_NONE)
+			{
+				Registry.Show(Index, true);
+			}
+		}
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+		for (AActor* Actor : Actors)
+		{
+			Actor->Destroy();
+		}
+
+		return Elapsed / EventsNum;
+	}
+
+	/** AoS radar point as HUD used to project it one by one */
+	struct FLegacyRadarPoint
+	{
+		bool bCanShow;
+		bool bCanShowIfOutRadarBorder;
+		FVector LastPos;
+	};
+
+	/** Per-point projection loop as it was done in AShooterHUD::DrawRadarCollectorPoints */
+	void ProjectLegacy(const FRadarProjectionParams& Params, const TArray<FLegacyRadarPoint>& Points, TArray<FRadarDrawItem>& OutDrawList)
+	{
+		OutDrawList.Reset();
+
+		float SinTheta = Params.SinTheta;
+		float CosTheta = Params.CosTheta;
+
+		for (int32 Index = 0; Index < Points.Num(); Index++)
+		{
+			const FLegacyRadarPoint& RadarPoint = Points[Index];
+			if (!RadarPoint.bCanShow)
+			{
+				continue;
+			}
+
+			FVector2D PointPosDeltaXY = FVector2D(Params.WorldCenter - RadarPoint.LastPos);
+			float DistRelToRadius = PointPosDeltaXY.Size() / Params.WorldRadius;
+
+			if (!RadarPoint.bCanShowIfOutRadarBorder && DistRelToRadius > 1.0f)
+			{
+				continue;
+			}
+
+			FVector2D PointRelDirection = FVector2D(PointPosDeltaXY);
+			PointRelDirection.Normalize();
+
+			float PointRadarDist = FMath::Clamp(DistRelToRadius, 0.0f, 1.0f) * Params.ScreenRadius;
+
+			float BasicPointPosX = PointRadarDist * PointRelDirection.Y;
+			float BasicPointPosY = -(PointRadarDist * PointRelDirection.X);
+
+			float PointRadialOffsetX = BasicPointPosX * CosTheta + BasicPointPosY * SinTheta;
+			float PointRadialOffsetY = -(BasicPointPosX * SinTheta) + BasicPointPosY * CosTheta;
+
+			float PickupDeltaZ = RadarPoint.LastPos.Z - Params.WorldCenter.Z;
+
+			FRadarDrawItem& Item = OutDrawList.AddUninitialized_GetRef();
+			Item.X = Params.ScreenCenter.Y + PointRadialOffsetX;
+			Item.Y = Params.ScreenCenter.X + PointRadialOffsetY;
+			Item.PointIndex = Index;
+			Item.HeightSign = PickupDeltaZ > Params.HeightThreshold ? 1 : (PickupDeltaZ < -Params.HeightThreshold ? -1 : 0);
+		}
+	}
+
+	/** Synthetic radar points scattered around radar center, some of them out of radar radius */
+	struct FProjectionTestData
+	{
+		FRadarProjectionParams Params;
+		TArray<float> PosX, PosY, PosZ;
+		TArray<uint8> Flags;
+		TArray<FLegacyRadarPoint> LegacyPoints;
+
+		explicit FProjectionTestData(int32 Num)
+		{
+			Params.WorldCenter = FVector(100.0f, -250.0f, 50.0f);
+			Params.WorldRadius = 5000.0f;
+			Params.ScreenCenter = FVector2D(151.0f, 131.0f);
+			Params.ScreenRadius = 111.0f;
+			Params.HeightThreshold = 200.0f;
+			Params.SetRotation(0.7f);
+
+			FRandomStream Random(Num);
+			for (int32 i = 0; i < Num; i++)
+			{
+				const FVector Pos = Params.WorldCenter + FVector(Random.FRandRange(-8000.0f, 8000.0f), Random.FRandRange(-8000.0f, 8000.0f), Random.FRandRange(-600.0f, 600.0f));
+				const bool bCanShow = Random.FRand() < 0.8f;
+				const bool bCanShowIfOutRadarBorder = Random.FRand() < 0.5f;
+
+				PosX.Add(Pos.X);
+				PosY.Add(Pos.Y);
+				PosZ.Add(Pos.Z);
+				Flags.Add((bCanShow ? ERadarPointFlags::CanShow : 0) | (bCanShowIfOutRadarBorder ? ERadarPointFlags::CanShowIfOutRadarBorder : 0));
+				LegacyPoints.Add({ bCanShow, bCanShowIfOutRadarBorder, Pos });
+			}
+		}
+
+		void Project(TArray<FRadarDrawItem>& OutDrawList) const
+		{
+			FShooterRadarProjection::Project(Params, PosX.GetData(), PosY.GetData(), PosZ.GetData(), Flags.GetData(), Flags.Num(), OutDrawList);
+		}
+	};
+
+	/*
+	 * Synthetic map with static pickups scattered over MapExtent x MapExtent area
+	 *
+	 * @param	OutOfBorderChance	chance of pickup to be flagged CanShowIfOutRadarBorder
+	 */
+	void FillPickupsMap(FScopedTestWorld& TestWorld, FRadarPointRegistry& Registry, int32 PickupsNum, float MapExtent, float OutOfBorderChance)
+	{
+		TArray<AActor*> Actors;
+		TestWorld.SpawnActors(PickupsNum, Actors);
+
+		FRadarPoint PickupTemplate;
+		PickupTemplate.Flags = ERadarPointFlags::CanShow | ERadarPointFlags::StaticPosition;
+
+		FRadarPoint OutOfBorderTemplate = PickupTemplate;
+		OutOfBorderTemplate.Flags |= ERadarPointFlags::CanShowIfOutRadarBorder;
+
+		FRandomStream Random(PickupsNum);
+		for (AActor* Actor : Actors)
+		{
+			bool bAdded;
+			const int32 Index = Registry.FindOrAdd(Actor, Random.FRand() < OutOfBorderChance ? OutOfBorderTemplate : PickupTemplate, bAdded);
+			Registry.SetPosition(Index, FVector(Random.FRandRange(-MapExtent, MapExtent), Random.FRandRange(-MapExtent, MapExtent), Random.FRandRange(-500.0f, 500.0f)));
+		}
+
+		Registry.Update(0.0f, FRadarPositionSnapshot());
+	}
+
+	FRadarProjectionParams MakePickupsMapParams(const FVector& WorldCenter)
+	{
+		FRadarProjectionParams Params;
+		Params.WorldCenter = WorldCenter;
+		Params.WorldRadius = 5000.0f;
+		Params.ScreenCenter = FVector2D(151.0f, 131.0f);
+		Params.ScreenRadius = 111.0f;
+		Params.HeightThreshold = 200.0f;
+		Params.SetRotation(-1.3f);
+		return Params;
+	}
+
+	/*
+	 * Synthetic demo radar history: NumActors actors, EventsPerSecond random radar events,
+	 * recorded to Timeline with keyframes every KeyframeInterval (0 for none)
+	 */
+	void RecordTimeline(FRadarTimeline& Timeline, float Duration, int32 NumActors, float EventsPerSecond, float KeyframeInterval)
+	{
+		FRandomStream Random(12);
+		TArray<FRadarTimelinePoint> Points;
+
+		for (int32 i = 0; i < NumActors; i++)
+		{
+			Timeline.FindOrAddKey(FName(TEXT("RadarActor"), i));
+		}
+
+		const float EventStep = 1.0f / EventsPerSecond;
+		for (float Time = 0.0f; Time < Duration; Time += EventStep)
+		{
+			if (KeyframeInterval > 0.0f && Timeline.NeedsKeyframe(Time, KeyframeInterval))
+			{
+				Timeline.Seek(Time, Points);  // same state as live radar model would have
+				Timeline.AddKeyframe(Time, Points);
+			}
+
+			const int32 Key = Random.RandHelper(NumActors);
+			const ERadarTimelineEvent::Type Type = (ERadarTimelineEvent::Type)Random.RandHelper(ERadarTimelineEvent::Hide + 1);
+			Timeline.AddEvent(Time, Key, (uint8)(Key % 4), Type, ERadarPointFlags::CanShow);
+		}
+	}
+
+	/** Compare points sets ignoring order */
+	bool PointsMatch(TArray<FRadarTimelinePoint> A, TArray<FRadarTimelinePoint> B)
+	{
+		if (A.Num() != B.Num())
+		{
+			return false;
+		}
+
+		auto ByKey = [](const FRadarTimelinePoint& L, const FRadarTimelinePoint& R) { return L.Key < R.Key; };
+		A.Sort(ByKey);
+		B.Sort(ByKey);
+
+		for (int32 i = 0; i < A.Num(); i++)
+		{
+			if (A[i].Key != B[i].Key || A[i].Category != B[i].Category || A[i].Flags != B[i].Flags
+				|| !FMath::IsNearlyEqual(A[i].ShowTime, B[i].ShowTime, 0.01f))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarRegistryLookupTest, "ShooterGame.Radar.Registry.Lookup",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarRegistryLookupTest::RunTest(const FString& Parameters)
+{
+	ShooterRadarTests::FScopedTestWorld TestWorld;
+
+	TArray<AActor*> Actors;
+	TestWorld.SpawnActors(8, Actors);
+
+	FRadarPointRegistry Registry;
+	for (AActor* Actor : Actors)
+	{
+		bool bAdded;
+		Registry.FindOrAdd(Actor, FRadarPoint(), bAdded);
+		TestTrue(TEXT("New actor is added"), bAdded);
+	}
+
+	bool bAdded;
+	Registry.FindOrAdd(Actors[0], FRadarPoint(), bAdded);
+	TestFalse(TEXT("Registered actor is not added twice"), bAdded);
+	TestEqual(TEXT("Registry size"), Registry.Num(), 8);
+
+	const FRadarPositionSnapshot Snapshot;
+	const int32 LastIndex = Registry.Find(Actors[7]);
+	const FRadarPointHandle RemovedHandle = Registry.GetHandle(Registry.Find(Actors[2]));
+
+	// remove from the middle, slot is freed and other radar points keep their indices
+	Registry.Remove(Actors[2]);
+	TestEqual(TEXT("Removed actor is not found"), Registry.Find(Actors[2]), (int32)INDEX_NONE);
+	Registry.Update(0.0f, Snapshot);
+	TestEqual(TEXT("Registry size after update"), Registry.Num(), 7);
+	TestEqual(TEXT("Last radar point keeps index"), Registry.Find(Actors[7]), LastIndex);
+	TestTrue(TEXT("Removed radar point slot is free"), Registry.IsFreeSlot(RemovedHandle.Index));
+	TestFalse(TEXT("Free slot is not shown"), Registry.CanShow(RemovedHandle.Index));
+
+	// re-registered actor reuses freed slot, old handle doesn't resolve to it
+	const int32 ReusedIndex = Registry.FindOrAdd(Actors[2], FRadarPoint(), bAdded);
+	TestEqual(TEXT("Freed slot is reused"), ReusedIndex, RemovedHandle.Index);
+	TestEqual(TEXT("Stale handle is not found"), Registry.Find(RemovedHandle), (int32)INDEX_NONE);
+	TestEqual(TEXT("New handle is found"), Registry.Find(Registry.GetHandle(ReusedIndex)), ReusedIndex);
+	Registry.Remove(Actors[2]);
+	Registry.Update(0.0f, Snapshot);
+
+	// destroyed actor is removed on update too
+	Actors[5]->Destroy();
+	Registry.Update(0.0f, Snapshot);
+	TestEqual(TEXT("Registry size after actor destroy"), Registry.Num(), 6);
+
+	for (int32 i = 0; i < Actors.Num(); i++)
+	{
+		if (i == 2 || i == 5)
+		{
+			continue;
+		}
+
+		const int32 Index = Registry.Find(Actors[i]);
+		if (TestNotEqual(TEXT("Actor is found"), Index, (int32)INDEX_NONE))
+		{
+			TestTrue(TEXT("Found index points to actor"), Registry.Actors[Index] == Actors[i]);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarRegistryChurnTest, "ShooterGame.Radar.Registry.ChurnAllocations",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarRegistryChurnTest::RunTest(const FString& Parameters)
+{
+	ShooterRadarTests::FScopedTestWorld TestWorld;
+
+	// deathmatch pool: characters die and respawn, actor ptrs are reused same as by UObject allocator
+	const int32 PoolSize = 64;
+	TArray<AActor*> Actors;
+	FRandomStream Random(16);
+	for (int32 i = 0; i < PoolSize; i++)
+	{
+		Actors.Add(TestWorld.SpawnMovableActor(FVector(Random.FRandRange(-20000.0f, 20000.0f), Random.FRandRange(-20000.0f, 20000.0f), 0.0f)));
+	}
+
+	FRadarPointRegistry Registry;
+	Registry.SetGridCellSize(5000.0f);
+	const FRadarPositionSnapshot Snapshot;
+
+	FRadarPoint PointTemplate;
+	PointTemplate.Flags = ERadarPointFlags::CanShow;
+
+	// warm-up: all actors alive once, slots and grid reach max size
+	bool bAdded;
+	for (AActor* Actor : Actors)
+	{
+		Registry.FindOrAdd(Actor, PointTemplate, bAdded);
+	}
+	Registry.Update(0.0f, Snapshot);
+
+	auto RunCycle = [&]()
+	{
+		AActor* Killed = Actors[Random.RandHelper(PoolSize)];
+		AActor* Spawned = Actors[Random.RandHelper(PoolSize)];
+		Registry.Remove(Killed);
+		Registry.Update(0.016f, Snapshot);
+		Registry.FindOrAdd(Spawned, PointTemplate, bAdded);
+	};
+
+	for (int32 Cycle = 0; Cycle < 100; Cycle++)
+	{
+		RunCycle();
+	}
+
+	const int32 Cycles = 10000;
+	uint64 NumAllocs;
+	{
+		FShooterCountingMallocScope CountingMalloc;
+		const uint64 StartAllocs = CountingMalloc.GetNumGameThreadAllocs();
+		for (int32 Cycle = 0; Cycle < Cycles; Cycle++)
+		{
+			RunCycle();
+		}
+		NumAllocs = CountingMalloc.GetNumGameThreadAllocs() - StartAllocs;
+	}
+
+	TestTrue(TEXT("No allocations over spawn/kill cycles"), NumAllocs == 0);
+	TestTrue(TEXT("Slots don't grow past pool size"), Registry.NumSlots() <= PoolSize);
+	AddInfo(FString::Printf(TEXT("%d spawn/kill cycles: %llu allocations, %d radar points in %d slots"), Cycles, NumAllocs, Registry.Num(), Registry.NumSlots()));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarRegistryInterpolationTest, "ShooterGame.Radar.Registry.Interpolation",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarRegistryInterpolationTest::RunTest(const FString& Parameters)
+{
+	ShooterRadarTests::FScopedTestWorld TestWorld;
+
+	AActor* Tracked = TestWorld.SpawnMovableActor(FVector::ZeroVector);
+	AActor* Sampled = TestWorld.SpawnMovableActor(FVector::ZeroVector);
+	AActor* Revealed = TestWorld.SpawnMovableActor(FVector::ZeroVector);
+
+	FRadarPoint TrackedTemplate;
+	TrackedTemplate.Flags = ERadarPointFlags::CanShow | ERadarPointFlags::Interpolated;
+
+	FRadarPoint SampledTemplate;
+	SampledTemplate.Flags = ERadarPointFlags::CanShow;
+
+	FRadarPoint RevealedTemplate;
+	RevealedTemplate.Flags = ERadarPointFlags::UpdatePosOnShowOnly | ERadarPointFlags::PosUpdateIsBlocked;
+
+	FRadarPointRegistry Registry;
+	bool bAdded;
+	const int32 TrackedIndex = Registry.FindOrAdd(Tracked, TrackedTemplate, bAdded);
+	const int32 SampledIndex = Registry.FindOrAdd(Sampled, SampledTemplate, bAdded);
+	const int32 RevealedIndex = Registry.FindOrAdd(Revealed, RevealedTemplate, bAdded);
+
+	const FVector Target(1000.0f, -500.0f, 100.0f);
+	Tracked->SetActorLocation(Target);
+	Sampled->SetActorLocation(Target);
+	Registry.Update(0.05f, FRadarPositionSnapshot());
+
+	TestTrue(TEXT("Not interpolated point takes sample at once"), Registry.GetPosition(SampledIndex).Equals(Target));
+
+	Registry.Interpolate(0.0f);
+	TestTrue(TEXT("Interpolation starts at previous sample"), Registry.GetPosition(TrackedIndex).Equals(FVector::ZeroVector));
+	Registry.Interpolate(0.5f);
+	TestTrue(TEXT("Interpolation blends samples"), Registry.GetPosition(TrackedIndex).Equals(Target * 0.5f));
+	Registry.Interpolate(1.0f);
+	TestTrue(TEXT("Interpolation ends at last sample"), Registry.GetPosition(TrackedIndex).Equals(Target));
+	TestTrue(TEXT("Interpolation doesn't move other points"), Registry.GetPosition(SampledIndex).Equals(Target));
+
+	// reveal between radar updates is drawn at revealed actor location, not last seen one
+	Revealed->SetActorLocation(Target);
+	Registry.Show(RevealedIndex, true);
+	TestTrue(TEXT("Revealed point is placed on show"), Registry.GetPosition(RevealedIndex).Equals(Target));
+
+	// teleport snaps interpolation
+	Registry.SetPosition(TrackedIndex, FVector(5.0f, 5.0f, 5.0f));
+	Registry.Interpolate(0.3f);
+	TestTrue(TEXT("Set position snaps interpolation"), Registry.GetPosition(TrackedIndex).Equals(FVector(5.0f, 5.0f, 5.0f)));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarRegistryShotEventCostTest, "ShooterGame.Radar.Registry.ShotEventCost",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterRadarRegistryShotEventCostTest::RunTest(const FString& Parameters)
+{
+	ShooterRadarTests::FScopedTestWorld TestWorld;
+
+	const int32 EventsNum = 20000;
+	const double SmallCost = ShooterRadarTests::MeasureShotEventCost(TestWorld, 64, EventsNum);
+	const double LargeCost = ShooterRadarTests::MeasureShotEventCost(TestWorld, 4096, EventsNum);
+
+	AddInfo(FString::Printf(TEXT("Shot event cost: 64 points %.1f ns, 4096 points %.1f ns"), SmallCost * 1e9, LargeCost * 1e9));
+
+	// linear scan would be ~64x slower, leave room for cache misses on bigger set
+	TestTrue(TEXT("Shot event cost stays flat as radar points count grows"), LargeCost < SmallCost * 8.0 + 1e-7);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarSubsystemWorldTest, "ShooterGame.Radar.Subsystem.IgnoresOtherWorldEvents",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarSubsystemWorldTest::RunTest(const FString& Parameters)
+{
+	UClass* CharacterClass = LoadClass<AShooterCharacter>(nullptr, TEXT("/Game/Blueprints/Pawns/PlayerPawn.PlayerPawn_C"));
+	if (!TestNotNull(TEXT("Character class"), CharacterClass))
+	{
+		return false;
+	}
+
+	// two worlds alive at once, as PIE clients or demo world next to game world, radar events are shared by both
+	ShooterRadarTests::FScopedTestWorld OwnWorld;
+	ShooterRadarTests::FScopedTestWorld OtherWorld;
+	const UShooterRadarSubsystem* RadarModel = OwnWorld.World->GetSubsystem<UShooterRadarSubsystem>();
+	const UShooterRadarSubsystem* OtherRadarModel = OtherWorld.World->GetSubsystem<UShooterRadarSubsystem>();
+	if (!TestNotNull(TEXT("Radar model"), RadarModel) || !TestNotNull(TEXT("Other world radar model"), OtherRadarModel))
+	{
+		return false;
+	}
+
+	const int32 Category = RadarModel->GetCategories().FindCategory(CharacterClass);
+	if (!TestTrue(TEXT("Character has radar category"), Category != INDEX_NONE))
+	{
+		return false;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AShooterCharacter* Character = OtherWorld.World->SpawnActor<AShooterCharacter>(CharacterClass, FTransform::Identity, SpawnParams);
+	if (!TestNotNull(TEXT("Character"), Character))
+	{
+		return false;
+	}
+
+	AShooterCharacter::NotifyShooterCharacterSpawn.Broadcast(Character);
+	TestEqual(TEXT("Spawn in other world adds no radar point"), RadarModel->GetRegistry(Category).Find(Character), INDEX_NONE);
+	TestTrue(TEXT("Spawn is added to radar of its world"), OtherRadarModel->GetRegistry(Category).Find(Character) != INDEX_NONE);
+
+	const uint32 Reveals = RadarModel->GetRevealsGenerated();
+	const uint32 OtherReveals = OtherRadarModel->GetRevealsGenerated();
+	AShooterWeapon::NotifyShooterCharacterWeaponShot.Broadcast(Character, nullptr);
+	TestTrue(TEXT("Shot in other world reveals nothing"), RadarModel->GetRevealsGenerated() == Reveals);
+	TestTrue(TEXT("Shot is revealed once, on radar of its world"), OtherRadarModel->GetRevealsGenerated() == OtherReveals + 1);
+
+	AShooterCharacter::NotifyShooterCharacterKill.Broadcast(Character);
+	TestEqual(TEXT("Kill removes radar point of its world"), OtherRadarModel->GetRegistry(Category).Find(Character), INDEX_NONE);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarProjectionTest, "ShooterGame.Radar.Projection.MatchesPerPointLoop",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarProjectionTest::RunTest(const FString& Parameters)
+{
+	// odd count to cover vectorized path tail
+	const ShooterRadarTests::FProjectionTestData Data(1027);
+
+	TArray<FRadarDrawItem> DrawList;
+	TArray<FRadarDrawItem> LegacyDrawList;
+	Data.Project(DrawList);
+	ShooterRadarTests::ProjectLegacy(Data.Params, Data.LegacyPoints, LegacyDrawList);
+
+	if (!TestEqual(TEXT("Draw list size"), DrawList.Num(), LegacyDrawList.Num()))
+	{
+		return false;
+	}
+
+	for (int32 i = 0; i < DrawList.Num(); i++)
+	{
+		const FRadarDrawItem& Item = DrawList[i];
+		const FRadarDrawItem& LegacyItem = LegacyDrawList[i];
+
+		TestEqual(TEXT("Point index"), Item.PointIndex, LegacyItem.PointIndex);
+		TestEqual(TEXT("Height sign"), Item.HeightSign, LegacyItem.HeightSign);
+		TestEqual(TEXT("Screen X"), Item.X, LegacyItem.X, 0.01f);
+		TestEqual(TEXT("Screen Y"), Item.Y, LegacyItem.Y, 0.01f);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarProjectionBenchmark, "ShooterGame.Radar.Projection.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterRadarProjectionBenchmark::RunTest(const FString& Parameters)
+{
+	const int32 PointCounts[] = { 16, 256, 4096 };
+	const int32 Iterations = 2000;
+
+	TArray<FRadarDrawItem> DrawList;
+	for (const int32 PointCount : PointCounts)
+	{
+		const ShooterRadarTests::FProjectionTestData Data(PointCount);
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; i++)
+		{
+			ShooterRadarTests::ProjectLegacy(Data.Params, Data.LegacyPoints, DrawList);
+		}
+		const double LegacyTime = (FPlatformTime::Seconds() - StartTime) / Iterations;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; i++)
+		{
+			Data.Project(DrawList);
+		}
+		const double BatchTime = (FPlatformTime::Seconds() - StartTime) / Iterations;
+
+		AddInfo(FString::Printf(TEXT("%4d points: per-point loop %.2f us, batch projection %.2f us (x%.2f)"),
+			PointCount, LegacyTime * 1e6, BatchTime * 1e6, BatchTime > 0.0 ? LegacyTime / BatchTime : 0.0));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarGridCullingTest, "ShooterGame.Radar.Grid.MatchesFullProjection",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarGridCullingTest::RunTest(const FString& Parameters)
+{
+	ShooterRadarTests::FScopedTestWorld TestWorld;
+
+	FRadarPointRegistry Registry;
+	ShooterRadarTests::FillPickupsMap(TestWorld, Registry, 2000, 40000.0f, 0.05f);
+
+	FRadarProjectionScratch Scratch;
+	TArray<FRadarDrawItem> FullDrawList;
+	TArray<FRadarDrawItem> GridDrawList;
+
+	FRandomStream Random(7);
+	for (int32 Query = 0; Query < 32; Query++)
+	{
+		const FRadarProjectionParams Params = ShooterRadarTests::MakePickupsMapParams(FVector(Random.FRandRange(-40000.0f, 40000.0f), Random.FRandRange(-40000.0f, 40000.0f), 0.0f));
+
+		Registry.SetGridCellSize(0.0f);
+		FShooterRadarProjection::Project(Params, Registry, FullDrawList, Scratch);
+
+		Registry.SetGridCellSize(Params.WorldRadius);
+		FShooterRadarProjection::Project(Params, Registry, GridDrawList, Scratch);
+
+		FullDrawList.Sort([](const FRadarDrawItem& A, const FRadarDrawItem& B) { return A.PointIndex < B.PointIndex; });
+		GridDrawList.Sort([](const FRadarDrawItem& A, const FRadarDrawItem& B) { return A.PointIndex < B.PointIndex; });
+
+		if (!TestEqual(TEXT("Grid culled draw list size"), GridDrawList.Num(), FullDrawList.Num()))
+		{
+			return false;
+		}
+
+		for (int32 i = 0; i < FullDrawList.Num(); i++)
+		{
+			TestEqual(TEXT("Grid culled draw item"), GridDrawList[i].PointIndex, FullDrawList[i].PointIndex);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarGridBenchmark, "ShooterGame.Radar.Grid.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterRadarGridBenchmark::RunTest(const FString& Parameters)
+{
+	ShooterRadarTests::FScopedTestWorld TestWorld;
+
+	FRadarPointRegistry Registry;
+	ShooterRadarTests::FillPickupsMap(TestWorld, Registry, 10000, 100000.0f, 0.0f);
+
+	const FRadarProjectionParams Params = ShooterRadarTests::MakePickupsMapParams(FVector(1234.0f, -4321.0f, 0.0f));
+	const int32 Iterations = 1000;
+
+	FRadarProjectionScratch Scratch;
+	TArray<FRadarDrawItem> DrawList;
+
+	Registry.SetGridCellSize(0.0f);
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		FShooterRadarProjection::Project(Params, Registry, DrawList, Scratch);
+	}
+	const double FullTime = (FPlatformTime::Seconds() - StartTime) / Iterations;
+
+	Registry.SetGridCellSize(Params.WorldRadius);
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		FShooterRadarProjection::Project(Params, Registry, DrawList, Scratch);
+	}
+	const double GridTime = (FPlatformTime::Seconds() - StartTime) / Iterations;
+
+	AddInfo(FString::Printf(TEXT("10k pickups map: all points %.2f us, grid culled %.2f us (%d candidates, %d drawn)"),
+		FullTime * 1e6, GridTime * 1e6, Scratch.Indices.Num(), DrawList.Num()));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarFloorBandsTest, "ShooterGame.Radar.Floors.BandLookup",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarFloorBandsTest::RunTest(const FString& Parameters)
+{
+	// 350 is closer then RADAR_FLOOR_MIN_HEIGHT to 300 and is merged
+	FRadarFloorBands FloorBands;
+	FloorBands.Init({ 1000.0f, 300.0f, 350.0f, 700.0f, -200.0f });
+	TestEqual(TEXT("Floors count"), FloorBands.NumFloors(), 5);
+
+	const float FloorBottoms[] = { -200.0f, 300.0f, 700.0f, 1000.0f };
+	auto ReferenceFloor = [&](float Z)
+	{
+		int32 Floor = 0;
+		for (const float Bottom : FloorBottoms)
+		{
+			Floor += Z >= Bottom ? 1 : 0;
+		}
+		return Floor;
+	};
+
+	for (const float Bottom : FloorBottoms)
+	{
+		TestEqual(TEXT("Floor at floor bottom"), (int32)FloorBands.GetFloor(Bottom), ReferenceFloor(Bottom));
+		TestEqual(TEXT("Floor below floor bottom"), (int32)FloorBands.GetFloor(Bottom - 0.5f), ReferenceFloor(Bottom - 0.5f));
+	}
+
+	FRandomStream Random(17);
+	int32 NumMismatches = 0;
+	for (int32 i = 0; i < 10000; i++)
+	{
+		const float Z = Random.FRandRange(-1000.0f, 3000.0f);
+		NumMismatches += FloorBands.GetFloor(Z) != ReferenceFloor(Z) ? 1 : 0;
+	}
+	TestEqual(TEXT("Floor lookup matches linear search"), NumMismatches, 0);
+
+	// registry buckets radar points when their position changes
+	ShooterRadarTests::FScopedTestWorld TestWorld;
+	AActor* Actor = TestWorld.SpawnMovableActor(FVector(0.0f, 0.0f, 800.0f));
+
+	FRadarPointRegistry Registry;
+	Registry.SetFloorBands(&FloorBands);
+
+	FRadarPoint PointTemplate;
+	PointTemplate.Flags = ERadarPointFlags::CanShow;
+	bool bAdded;
+	const int32 Index = Registry.FindOrAdd(Actor, PointTemplate, bAdded);
+	TestEqual(TEXT("Registered radar point floor"), (int32)Registry.Floors[Index], 3);
+	Registry.SetPosition(Index, FVector(0.0f, 0.0f, 0.0f));
+	TestEqual(TEXT("Moved radar point floor"), (int32)Registry.Floors[Index], 1);
+
+	// floor difference replaces height threshold
+	const uint8 PointFloors[] = { 0, 1, 3 };
+	TArray<FRadarDrawItem> DrawList;
+	for (int32 i = 0; i < 3; i++)
+	{
+		DrawList.Add({ 0.0f, 0.0f, i, 0 });
+	}
+
+	FRadarProjectionParams Params;
+	Params.ViewerFloor = 1;
+	FShooterRadarProjection::ApplyFloors(Params, PointFloors, DrawList);
+	if (TestEqual(TEXT("All floors are drawn"), DrawList.Num(), 3))
+	{
+		TestEqual(TEXT("Lower floor"), DrawList[0].HeightSign, -1);
+		TestEqual(TEXT("Same floor"), DrawList[1].HeightSign, 0);
+		TestEqual(TEXT("Higher floor"), DrawList[2].HeightSign, 1);
+	}
+
+	Params.bViewerFloorOnly = true;
+	FShooterRadarProjection::ApplyFloors(Params, PointFloors, DrawList);
+	if (TestEqual(TEXT("Only viewer floor is drawn"), DrawList.Num(), 1))
+	{
+		TestEqual(TEXT("Viewer floor radar point"), DrawList[0].PointIndex, 1);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarFloorBandsBenchmark, "ShooterGame.Radar.Floors.LookupCost",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterRadarFloorBandsBenchmark::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(18);
+	TArray<float> Heights;
+	for (int32 i = 0; i < 1024; i++)
+	{
+		Heights.Add(Random.FRandRange(-2000.0f, 30000.0f));
+	}
+
+	auto MeasureLookupCost = [&](int32 NumFloors)
+	{
+		TArray<float> FloorHeights;
+		for (int32 Floor = 1; Floor < NumFloors; Floor++)
+		{
+			FloorHeights.Add(Floor * 400.0f);
+		}
+
+		FRadarFloorBands FloorBands;
+		FloorBands.Init(FloorHeights);
+
+		uint32 FloorsSum = 0;  // keeps lookups from being optimized out
+		const int32 Rounds = 1000;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Round = 0; Round < Rounds; Round++)
+		{
+			for (const float Z : Heights)
+			{
+				FloorsSum += FloorBands.GetFloor(Z);
+			}
+		}
+		const double Cost = (FPlatformTime::Seconds() - StartTime) / (Rounds * Heights.Num());
+
+		AddInfo(FString::Printf(TEXT("%d floors: %.2f ns per radar point (floors sum %u)"), FloorBands.NumFloors(), Cost * 1e9, FloorsSum));
+		return Cost;
+	};
+
+	const double FewFloorsCost = MeasureLookupCost(2);
+	const double ManyFloorsCost = MeasureLookupCost(75);
+
+	// table lookup, search over floor bottoms would grow with floors count
+	TestTrue(TEXT("Floor lookup cost stays flat as floors count grows"), ManyFloorsCost < FewFloorsCost * 3.0 + 1e-8);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarFeedSerializeTest, "ShooterGame.Radar.Feed.SerializeRoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarFeedSerializeTest::RunTest(const FString& Parameters)
+{
+	FShooterRadarFeedSnapshot Snapshot;
+	FRandomStream Random(6);
+
+	for (int32 i = 0; i < 64; i++)
+	{
+		FShooterRadarFeedEntry& Entry = Snapshot.Entries.AddDefaulted_GetRef();
+		Entry.X = (int16)Random.RandRange(-32768, 32767);
+		Entry.Y = (int16)Random.RandRange(-32768, 32767);
+		Entry.Z = (int8)Random.RandRange(-128, 127);
+		Entry.Category = (uint8)Random.RandHelper(RADAR_CATEGORY_MAX);
+		Entry.bExpires = (i % 2) == 0;
+		Entry.bShowIfOutRadarBorder = (i % 3) == 0;
+		Entry.ExpireTime = Entry.bExpires ? (uint16)Random.RandRange(0, 65535) : 0;
+	}
+
+	FNetBitWriter Writer(nullptr, 0);
+	bool bSuccess = false;
+	Snapshot.NetSerialize(Writer, nullptr, bSuccess);
+	TestTrue(TEXT("Snapshot is written"), bSuccess);
+
+	// 6 bytes per entry, 2 more for expiring ones, packed count
+	TestTrue(TEXT("Snapshot payload size"), Writer.GetNumBytes() <= 64 * 6 + 32 * 2 + 2);
+	TestEqual(TEXT("Computed payload size matches serialized"), Snapshot.GetSerializedSize(), (int32)Writer.GetNumBytes());
+
+	FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+	FShooterRadarFeedSnapshot ReadSnapshot;
+	ReadSnapshot.NetSerialize(Reader, nullptr, bSuccess);
+	TestTrue(TEXT("Snapshot is read"), bSuccess);
+	TestTrue(TEXT("Read snapshot is identical"), ReadSnapshot.Identical(&Snapshot, 0));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarPingCoalesceTest, "ShooterGame.Radar.Feed.PingCoalescing",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarPingCoalesceTest::RunTest(const FString& Parameters)
+{
+	// standing enemy with automatic weapon: reveal every 0.1 sec for 3 sec, checked by radar feed at 10 Hz
+	const float ShowTime = 1.0f;
+	const int32 DisplaySteps = FMath::RoundToInt(ShowTime / RADAR_FEED_TIME_QUANTIZATION);
+	const int32 Shots = 30;
+
+	FShooterRadarPingItem SentPing;
+	SentPing.X = 100;
+	SentPing.Y = -200;
+	SentPing.ExpireTime = (uint16)(65530 + DisplaySteps);  // wraps during test
+
+	int32 Transmitted = 1;
+	for (int32 Shot = 1; Shot <= Shots; Shot++)
+	{
+		FShooterRadarPingItem NewPing = SentPing;
+		NewPing.X = 100 + (Shot % 2);  // jitter below move threshold
+		NewPing.ExpireTime = (uint16)(65530 + Shot + DisplaySteps);
+
+		if (AShooterRadarFeed::ShouldResendPing(SentPing, NewPing, ShowTime))
+		{
+			TestTrue(TEXT("Sent ping is refreshed before it expires on client"), (int16)(SentPing.ExpireTime - (uint16)(65530 + Shot)) > 0);
+			SentPing = NewPing;
+			Transmitted++;
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("%d reveals generated, %d pings transmitted"), Shots + 1, Transmitted));
+	TestTrue(TEXT("Reveals are coalesced"), Transmitted <= (Shots * 2) / DisplaySteps + 2);
+
+	// enemy moved far, ping is sent at once
+	FShooterRadarPingItem MovedPing = SentPing;
+	MovedPing.Y += 1000;
+	TestTrue(TEXT("Moved enemy ping is sent"), AShooterRadarFeed::ShouldResendPing(SentPing, MovedPing, ShowTime));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarIconBatchTest, "ShooterGame.Radar.IconBatch.Geometry",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarIconBatchTest::RunTest(const FString& Parameters)
+{
+	UTexture2D* Texture = UTexture2D::CreateTransient(512, 256);
+	if (!TestNotNull(TEXT("Transient texture"), Texture))
+	{
+		return false;
+	}
+
+	const FCanvasIcon Icon = UCanvas::MakeIcon(Texture, 432, 64, 16, 16);
+
+	FRadarIconBatch Batch;
+	Batch.Reset(Texture, FLinearColor::White);
+
+	// 64 enemies scene: icon + height fragment each
+	for (int32 i = 0; i < 64; i++)
+	{
+		Batch.AddIcon(Icon, i * 10.0f, 20.0f, 1.5f);
+		Batch.AddIcon(Icon, i * 10.0f, 40.0f, 1.5f);
+	}
+	TestEqual(TEXT("All icons are in one batch"), Batch.NumIcons(), 128);
+
+	const FCanvasUVTri& First = Batch.GetTriangles()[0];
+	TestEqual(TEXT("Top left corner"), First.V0_Pos, FVector2D(0.0f, 20.0f));
+	TestEqual(TEXT("Bottom right corner"), First.V2_Pos, FVector2D(24.0f, 44.0f));
+	TestEqual(TEXT("Top left UV"), First.V0_UV, FVector2D(432.0f / 512.0f, 64.0f / 256.0f));
+	TestEqual(TEXT("Bottom right UV"), First.V2_UV, FVector2D(448.0f / 512.0f, 80.0f / 256.0f));
+
+	// 90 deg around icon center maps top left corner to top right corner
+	Batch.Reset(Texture, FLinearColor::White);
+	Batch.AddRotatedIcon(Icon, 100.0f, 100.0f, 1.0f, 90.0f, FVector2D(0.5f, 0.5f));
+	const FCanvasUVTri& Rotated = Batch.GetTriangles()[0];
+	TestTrue(TEXT("Rotated top left corner"), Rotated.V0_Pos.Equals(FVector2D(116.0f, 100.0f), KINDA_SMALL_NUMBER * 100.0f));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarCategoryTableTest, "ShooterGame.Radar.Categories.ClassLookup",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarCategoryTableTest::RunTest(const FString& Parameters)
+{
+	// same rules as shipped DefaultGame.ini categories
+	TArray<FRadarCategoryDef> Defs;
+
+	FRadarCategoryDef& Grenades = Defs.AddDefaulted_GetRef();
+	Grenades.ActorClass = AShooterPickup_Ammo::StaticClass();
+	Grenades.AmmoWeaponClass = AShooterWeapon_Projectile::StaticClass();
+	Grenades.bStaticPosition = true;
+
+	FRadarCategoryDef& Health = Defs.AddDefaulted_GetRef();
+	Health.ActorClass = AShooterPickup_Health::StaticClass();
+	Health.bStaticPosition = true;
+
+	FRadarCategoryDef& Ammo = Defs.AddDefaulted_GetRef();
+	Ammo.ActorClass = AShooterPickup_Ammo::StaticClass();
+	Ammo.bStaticPosition = true;
+
+	FRadarCategoryDef& Enemy = Defs.AddDefaulted_GetRef();
+	Enemy.ActorClass = AShooterCharacter::StaticClass();
+	Enemy.bShowIfOutRadarBorder = true;
+	Enemy.bUpdatePosOnShowOnly = true;
+	Enemy.ShowTime = 1.0f;
+
+	FRadarCategoryTable Table;
+	Table.Init(Defs);
+
+	TestEqual(TEXT("Character category"), Table.FindCategory(AShooterCharacter::StaticClass()), 3);
+	TestEqual(TEXT("Health pickup category"), Table.FindCategory(AShooterPickup_Health::StaticClass()), 1);
+	TestEqual(TEXT("Ammo pickup without weapon type skips weapon rule category"), Table.FindCategory(AShooterPickup_Ammo::StaticClass()), 2);
+	TestEqual(TEXT("Base pickup has no category"), Table.FindCategory(AShooterPickup::StaticClass()), INDEX_NONE);
+	TestEqual(TEXT("Actor has no category"), Table.FindCategory(AActor::StaticClass()), INDEX_NONE);
+	TestEqual(TEXT("nullptr has no category"), Table.FindCategory(nullptr), INDEX_NONE);
+
+	// classes are resolved once, including ones without category
+	const int32 NumResolved = Table.NumResolvedClasses();
+	TestEqual(TEXT("Resolved classes"), NumResolved, 5);
+	for (int32 i = 0; i < 100; i++)
+	{
+		Table.FindCategory(AShooterCharacter::StaticClass());
+		Table.FindCategory(AActor::StaticClass());
+	}
+	TestEqual(TEXT("Repeated lookups hit cache"), Table.NumResolvedClasses(), NumResolved);
+
+	// show rules map to same radar point defaults as former hard-coded ones
+	const FRadarPoint EnemyPoint = Table.GetCategory(3).MakePointTemplate();
+	TestEqual(TEXT("Enemy radar point flags"), (int32)EnemyPoint.Flags, (int32)(ERadarPointFlags::CanShow | ERadarPointFlags::CanShowIfOutRadarBorder
+		| ERadarPointFlags::UpdatePosOnShowOnly | ERadarPointFlags::PosUpdateIsBlocked));
+	TestEqual(TEXT("Enemy radar point show time"), EnemyPoint.ShowTimeMax, 1.0f);
+	TestTrue(TEXT("Enemy category is sent as pings"), Table.GetCategory(3).ExpiresOnShow());
+
+	const FRadarPoint PickupPoint = Table.GetCategory(1).MakePointTemplate();
+	TestEqual(TEXT("Pickup radar point flags"), (int32)PickupPoint.Flags, (int32)(ERadarPointFlags::CanShow | ERadarPointFlags::StaticPosition));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRingBufferWrapTest, "ShooterGame.Radar.HitMarkers.RingBufferWrapAround",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRingBufferWrapTest::RunTest(const FString& Parameters)
+{
+	TShooterRingBuffer<int32, 8> Buffer;
+	Buffer.SetCapacity(3);
+	TestEqual(TEXT("Capacity"), Buffer.GetCapacity(), 3);
+
+	for (int32 Value = 0; Value < 7; Value++)
+	{
+		Buffer.Add(Value);
+	}
+
+	// 0..3 are overwritten, iteration goes oldest first across storage end
+	TestEqual(TEXT("Full buffer size"), Buffer.Num(), 3);
+	int32 Expected = 4;
+	for (int32 Value : Buffer)
+	{
+		TestEqual(TEXT("Iterated value"), Value, Expected++);
+	}
+	TestEqual(TEXT("Iterated count"), Expected, 7);
+
+	Buffer.PopOldest(2);
+	TestEqual(TEXT("Size after pop"), Buffer.Num(), 1);
+	TestEqual(TEXT("Oldest after pop"), Buffer.Oldest(), 6);
+
+	Buffer.Add(7);
+	Buffer.Add(8);
+	Buffer.Add(9);
+	TestEqual(TEXT("Oldest after wrapped adds"), Buffer[0], 7);
+	TestEqual(TEXT("Newest after wrapped adds"), Buffer.Newest(), 9);
+
+	// shrinking keeps newest elements
+	Buffer.SetCapacity(2);
+	TestEqual(TEXT("Size after shrink"), Buffer.Num(), 2);
+	TestEqual(TEXT("Oldest after shrink"), Buffer[0], 8);
+	TestEqual(TEXT("Newest after shrink"), Buffer[1], 9);
+
+	Buffer.SetCapacity(100);
+	TestEqual(TEXT("Capacity is clamped"), Buffer.GetCapacity(), 8);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarHitMarkersTest, "ShooterGame.Radar.HitMarkers.ExpiryAndAggregation",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarHitMarkersTest::RunTest(const FString& Parameters)
+{
+	FRadarHitMarkerData HitMarkerData;
+	HitMarkerData.Configure(4, 5.0f);
+
+	// shotgun burst: pellets within few degrees aggregate to one hit marker
+	for (int32 Pellet = 0; Pellet < 8; Pellet++)
+	{
+		const float AngleRad = FMath::DegreesToRadians(Pellet * 0.5f);
+		HitMarkerData.AddHitDirection(FVector(FMath::Cos(AngleRad), FMath::Sin(AngleRad), 0.3f));
+	}
+	HitMarkerData.AddHitDirection(FVector::UpVector);  // no 2D direction, ignored
+	HitMarkerData.AddHitDirection(FVector(0.0f, -1.0f, 0.0f));
+
+	TestEqual(TEXT("Burst is aggregated"), HitMarkerData.GetHitMarkers().Num(), 2);
+	TestEqual(TEXT("Aggregated hits"), HitMarkerData.GetHitMarkers()[0].NumHits, 8);
+
+	// same direction in next frame is new hit marker
+	HitMarkerData.Update(0.4f);
+	HitMarkerData.AddHitDirection(FVector(1.0f, 0.0f, 0.0f));
+	TestEqual(TEXT("Next frame hit is not aggregated"), HitMarkerData.GetHitMarkers().Num(), 3);
+
+	// first two expire, last one stays
+	HitMarkerData.Update(RADAR_HIT_MARKER_DISPLAY_TIME - 0.3f);
+	TestEqual(TEXT("Expired hit markers are removed"), HitMarkerData.GetHitMarkers().Num(), 1);
+	TestEqual(TEXT("Live hit marker show time"), HitMarkerData.GetHitMarkers()[0].ShowTime, RADAR_HIT_MARKER_DISPLAY_TIME - 0.3f);
+
+	HitMarkerData.Update(0.4f);
+	TestTrue(TEXT("All hit markers expired"), HitMarkerData.GetHitMarkers().IsEmpty());
+
+	// more distinct hits then capacity keep newest ones
+	for (int32 Hit = 0; Hit < 6; Hit++)
+	{
+		const float AngleRad = FMath::DegreesToRadians(Hit * 60.0f);
+		HitMarkerData.AddHitDirection(FVector(FMath::Cos(AngleRad), FMath::Sin(AngleRad), 0.0f));
+	}
+	TestEqual(TEXT("Hit markers limited by capacity"), HitMarkerData.GetHitMarkers().Num(), 4);
+	TestTrue(TEXT("Oldest kept hit marker"), HitMarkerData.GetHitMarkers()[0].Direction.Equals(FVector2D(FMath::Cos(PI * 2.0f / 3.0f), FMath::Sin(PI * 2.0f / 3.0f)), KINDA_SMALL_NUMBER));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarSpotScheduleTest, "ShooterGame.Radar.Spotting.RoundRobin",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarSpotScheduleTest::RunTest(const FString& Parameters)
+{
+	const int32 NumSpotters = 4;
+	const int32 NumTargets = 10;
+	const int32 Budget = 7;
+
+	FRadarSpotSchedule Schedule;
+	TArray<int32> TraceCounts;
+	TraceCounts.SetNumZeroed(NumSpotters * NumTargets);
+
+	// 6 frames cover 40 pairs once, no pair is traced twice before every pair got its turn
+	for (int32 Frame = 0; Frame < 6; Frame++)
+	{
+		const int32 NumIssued = Schedule.Schedule(NumSpotters, NumTargets, Budget, [&](int32 SpotterIndex, int32 TargetIndex)
+		{
+			TraceCounts[SpotterIndex * NumTargets + TargetIndex]++;
+			return true;
+		});
+		TestEqual(TEXT("Traces issued per frame"), NumIssued, Budget);
+	}
+
+	for (int32 Pair = 0; Pair < TraceCounts.Num(); Pair++)
+	{
+		TestEqual(TEXT("Pair traced once"), TraceCounts[Pair], Pair < 42 - TraceCounts.Num() ? 2 : 1);
+	}
+
+	// rejected pairs (out of view cone) don't take budget, every pair is visited at most once per frame
+	int32 NumVisited = 0;
+	const int32 NumIssued = Schedule.Schedule(NumSpotters, NumTargets, Budget, [&](int32 SpotterIndex, int32 TargetIndex)
+	{
+		NumVisited++;
+		return TargetIndex == 3;
+	});
+	TestEqual(TEXT("Only accepted pairs are issued"), NumIssued, NumSpotters);
+	TestEqual(TEXT("Pairs visited"), NumVisited, NumSpotters * NumTargets);
+
+	TestEqual(TEXT("Nothing to trace"), Schedule.Schedule(0, NumTargets, Budget, [](int32, int32) { return true; }), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarTimelineSeekTest, "ShooterGame.Radar.Timeline.SeekMatchesFullReplay",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarTimelineSeekTest::RunTest(const FString& Parameters)
+{
+	FRadarTimeline Keyframed;
+	ShooterRadarTests::RecordTimeline(Keyframed, 120.0f, 32, 20.0f, 10.0f);
+
+	FRadarTimeline EventsOnly;
+	ShooterRadarTests::RecordTimeline(EventsOnly, 120.0f, 32, 20.0f, 0.0f);
+
+	TestEqual(TEXT("Keyframes recorded"), Keyframed.NumKeyframes(), 12);
+
+	TArray<FRadarTimelinePoint> SeekPoints;
+	TArray<FRadarTimelinePoint> ReplayPoints;
+	const float SeekTimes[] = { 0.0f, 0.05f, 9.99f, 10.0f, 10.01f, 55.5f, 119.0f, 200.0f };
+	for (const float SeekTime : SeekTimes)
+	{
+		Keyframed.Seek(SeekTime, SeekPoints);
+		EventsOnly.Seek(SeekTime, ReplayPoints);
+		TestTrue(FString::Printf(TEXT("Seek to %.2f matches replay from start"), SeekTime), ShooterRadarTests::PointsMatch(SeekPoints, ReplayPoints));
+	}
+
+	// scrubbing back drops history after seek time, it's recorded again
+	Keyframed.TruncateAfter(55.5f);
+	TestTrue(TEXT("Truncated end time"), Keyframed.GetEndTime() <= 55.5f);
+	TestEqual(TEXT("Keyframes after truncate"), Keyframed.NumKeyframes(), 6);
+
+	Keyframed.Seek(55.5f, SeekPoints);
+	EventsOnly.Seek(55.5f, ReplayPoints);
+	TestTrue(TEXT("Seek to truncate time matches"), ShooterRadarTests::PointsMatch(SeekPoints, ReplayPoints));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarTimelineBenchmark, "ShooterGame.Radar.Timeline.SeekBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterRadarTimelineBenchmark::RunTest(const FString& Parameters)
+{
+	// 20 minutes match: 64 radar actors, 40 radar events per second (shots, pickups)
+	const float Duration = 20.0f * 60.0f;
+
+	FRadarTimeline Keyframed;
+	ShooterRadarTests::RecordTimeline(Keyframed, Duration, 64, 40.0f, 10.0f);
+
+	FRadarTimeline EventsOnly;
+	ShooterRadarTests::RecordTimeline(EventsOnly, Duration, 64, 40.0f, 0.0f);
+
+	FRandomStream Random(20);
+	TArray<FRadarTimelinePoint> Points;
+	const int32 Seeks = 200;
+
+	double StartTime = FPlatformTime::Seconds();
+	double MaxSeekTime = 0.0;
+	for (int32 i = 0; i < Seeks; i++)
+	{
+		const double SeekStartTime = FPlatformTime::Seconds();
+		Keyframed.Seek(Random.FRandRange(0.0f, Duration), Points);
+		MaxSeekTime = FMath::Max(MaxSeekTime, FPlatformTime::Seconds() - SeekStartTime);
+	}
+	const double KeyframedTime = (FPlatformTime::Seconds() - StartTime) / Seeks;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Seeks; i++)
+	{
+		EventsOnly.Seek(Random.FRandRange(0.0f, Duration), Points);
+	}
+	const double ReplayTime = (FPlatformTime::Seconds() - StartTime) / Seeks;
+
+	AddInfo(FString::Printf(TEXT("20 min recording, %d events, %.1f KB: keyframed seek %.2f us (max %.2f us), replay from start %.2f us (x%.1f)"),
+		Keyframed.NumEvents(), Keyframed.GetAllocatedSize() / 1024.0f, KeyframedTime * 1e6, MaxSeekTime * 1e6, ReplayTime * 1e6,
+		KeyframedTime > 0.0 ? ReplayTime / KeyframedTime : 0.0));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRadarMinimapClipTest, "ShooterGame.Radar.Minimap.TileClipping",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRadarMinimapClipTest::RunTest(const FString& Parameters)
+{
+	auto PolygonArea = [](const TArray<FVector2D>& Polygon)
+	{
+		float Area = 0.0f;
+		for (int32 i = 0; i < Polygon.Num(); i++)
+		{
+			Area += Polygon[i] ^ Polygon[(i + 1) % Polygon.Num()];
+		}
+		return 0.5f * Area;
+	};
+
+	const FVector2D Center(1000.0f, -500.0f);
+	const float Radius = 2000.0f;
+	const int32 Segments = 48;
+	TArray<FVector2D> Polygon;
+	TArray<FVector2D> Scratch;
+
+	FRadarMinimap::ClipCircleToRect(Center, Radius, FBox2D(Center - FVector2D(5000.0f, 5000.0f), Center + FVector2D(5000.0f, 5000.0f)), Segments, Polygon, Scratch);
+	TestEqual(TEXT("Circle inside rect is not clipped"), Polygon.Num(), Segments);
+	const float CircleArea = PolygonArea(Polygon);
+
+	// tiles split at circle center cover whole circle
+	float TilesArea = 0.0f;
+	for (int32 Quadrant = 0; Quadrant < 4; Quadrant++)
+	{
+		const FVector2D Offset((Quadrant & 1) ? 5000.0f : -5000.0f, (Quadrant & 2) ? 5000.0f : -5000.0f);
+		FRadarMinimap::ClipCircleToRect(Center, Radius, FBox2D(FVector2D::Min(Center, Center + Offset), FVector2D::Max(Center, Center + Offset)), Segments, Polygon, Scratch);
+		TestTrue(TEXT("Quadrant polygon is counter clockwise"), PolygonArea(Polygon) > 0.0f);
+		TilesArea += PolygonArea(Polygon);
+	}
+	TestEqual(TEXT("Quadrant tiles area"), TilesArea, CircleArea, CircleArea * 1e-4f);
+
+	FRadarMinimap::ClipCircleToRect(Center, Radius, FBox2D(Center + FVector2D(Radius + 10.0f, 0.0f), Center + FVector2D(Radius + 500.0f, 500.0f)), Segments, Polygon, Scratch);
+	TestEqual(TEXT("Rect out of circle"), Polygon.Num(), 0);
+
+	UShooterRadarMinimapData* Data = NewObject<UShooterRadarMinimapData>();
+	Data->WorldOrigin = FVector2D(-8192.0f, -4096.0f);
+	Data->TileWorldSize = 4096.0f;
+	Data->NumTilesX = 4;
+	Data->NumTilesY = 2;
+
+	TestEqual(TEXT("Range in minimap"), Data->GetTileRange(FVector2D(100.0f, 100.0f), 1000.0f), FIntRect(1, 0, 2, 1));
+	TestEqual(TEXT("Range clamped to minimap"), Data->GetTileRange(FVector2D(-9000.0f, 0.0f), 3000.0f), FIntRect(0, 0, 0, 1));
+	const FIntRect OutRange = Data->GetTileRange(FVector2D(20000.0f, 0.0f), 1000.0f);
+	TestTrue(TEXT("Range out of minimap is empty"), OutRange.Max.X < OutRange.Min.X);
+
+	// minimap vertices land where radar points at same location are drawn
+	const ShooterRadarTests::FProjectionTestData ProjectionData(64);
+	TArray<FRadarDrawItem> DrawList;
+	ProjectionData.Project(DrawList);
+	for (const FRadarDrawItem& Item : DrawList)
+	{
+		const FVector2D Location(ProjectionData.PosX[Item.PointIndex], ProjectionData.PosY[Item.PointIndex]);
+		if (FVector2D::Distance(Location, FVector2D(ProjectionData.Params.WorldCenter)) < ProjectionData.Params.WorldRadius * 0.9f)
+		{
+			const FVector2D Screen = ProjectionData.Params.WorldToScreen(Location);
+			TestEqual(TEXT("Screen X"), Screen.X, Item.X, 0.01f);
+			TestEqual(TEXT("Screen Y"), Screen.Y, Item.Y, 0.01f);
+		}
+	}
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
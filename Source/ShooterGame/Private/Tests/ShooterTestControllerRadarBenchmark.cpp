@@ -0,0 +1,272 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#include "ShooterTestControllerRadarBenchmark.h"
+#include "ShooterGame.h"
+#include "Engine/Canvas.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "CanvasTypes.h"
+#include "Misc/FileHelper.h"
+#include "UI/ShooterHUD.h"
+#include "UI/ShooterRadarCollector.h"
+#include "Pickups/ShooterPickup_Health.h"
+#include "Tests/ShooterCountingMalloc.h"
+
+namespace ShooterRadarBenchmark
+{
+	/** Offscreen canvas size radar is drawn to */
+	const int32 CanvasSizeX = 1920;
+	const int32 CanvasSizeY = 1080;
+
+	/** Extra pickups are spread over about two radar world radii around player, so part of them is out of radar border */
+	const float PickupsSpread = 10000.0f;
+
+	struct FStatSummary
+	{
+		double Min = 0.0;
+		double Median = 0.0;
+		double P99 = 0.0;
+		double Max = 0.0;
+	};
+
+	FStatSummary Summarize(TArray<double> Values)
+	{
+		FStatSummary Summary;
+		if (Values.Num() > 0)
+		{
+			Values.Sort();
+			Summary.Min = Values[0];
+			Summary.Median = Values[Values.Num() / 2];
+			Summary.P99 = Values[FMath::Clamp(FMath::CeilToInt(Values.Num() * 0.99f) - 1, 0, Values.Num() - 1)];
+			Summary.Max = Values.Last();
+		}
+		return Summary;
+	}
+}
+
+void UShooterTestControllerRadarBenchmark::OnInit()
+{
+	Super::OnInit();
+
+	NumBots = 16;
+	NumPickups = 200;
+	NumFrames = 1000;
+	NumWarmupFrames = 60;
+	MatchStartTimeout = 300.0f;
+	CsvPath = FPaths::ProjectSavedDir() / TEXT("Profiling") / TEXT("RadarBenchmark.csv");
+
+	FParse::Value(FCommandLine::Get(), TEXT("RadarBenchmarkBots="), NumBots);
+	FParse::Value(FCommandLine::Get(), TEXT("RadarBenchmarkPickups="), NumPickups);
+	FParse::Value(FCommandLine::Get(), TEXT("RadarBenchmarkFrames="), NumFrames);
+	FParse::Value(FCommandLine::Get(), TEXT("RadarBenchmarkCsv="), CsvPath);
+	NumFrames = FMath::Max(NumFrames, 1);
+
+	bHostedGame = false;
+	bSpawnedPickups = false;
+	NumFramesDriven = 0;
+	TimeWaitingForMatch = 0.0f;
+	Samples.Reset(NumFrames);
+}
+
+void UShooterTestControllerRadarBenchmark::OnUserCanPlayOnline(const FUniqueNetId& UserId, EUserPrivileges::Type Privilege, uint32 PrivilegeResults)
+{
+	Super::OnUserCanPlayOnline(UserId, Privilege, PrivilegeResults);
+
+	if (PrivilegeResults == (uint32)IOnlineIdentity::EPrivilegeResults::NoFailures && !bHostedGame)
+	{
+		bHostedGame = true;
+		HostGame();
+	}
+}
+
+void UShooterTestControllerRadarBenchmark::HostGame()
+{
+	UShooterGameInstance* GameInstance = GetGameInstance();
+	ULocalPlayer* PlayerOwner          = GameInstance ? GameInstance->GetFirstGamePlayer() : nullptr;
+
+	if (PlayerOwner)
+	{
+		const FString GameType = TEXT("FFA");
+		const FString StartURL = FString::Printf(TEXT("/Game/Maps/%s?game=%s?%s=%d"), TEXT("Highrise"), *GameType, *AShooterGameMode::GetBotsCountOptionName(), NumBots);
+
+		GameInstance->HostGame(PlayerOwner, GameType, StartURL);
+	}
+	else
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Failed!  Could not find LocalPlayer or GameInstance is null!"));
+		EndTest(-1);
+	}
+}
+
+void UShooterTestControllerRadarBenchmark::OnPostMapChange(UWorld* World)
+{
+	if (IsInGame())
+	{
+		bSpawnedPickups = false;
+		NumFramesDriven = 0;
+		TimeWaitingForMatch = 0.0f;
+		Samples.Reset();
+	}
+}
+
+void UShooterTestControllerRadarBenchmark::OnTick(float TimeDelta)
+{
+	Super::OnTick(TimeDelta);
+
+	if (!IsInGame())
+	{
+		return;
+	}
+
+	AShooterHUD* HUD = GetRadarHUD();
+	if (HUD == nullptr)
+	{
+		TimeWaitingForMatch += TimeDelta;
+		if (TimeWaitingForMatch > MatchStartTimeout)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("Failed!  Match with radar HUD did not start in %.0f seconds!"), MatchStartTimeout);
+			EndTest(-1);
+		}
+		return;
+	}
+
+	if (!bSpawnedPickups)
+	{
+		bSpawnedPickups = true;
+		SpawnPickups();
+
+		// radar is driven by benchmark only from now on
+		HUD->bShowHUD = false;
+		return;
+	}
+
+	MeasureFrame(HUD);
+
+	if (Samples.Num() >= NumFrames)
+	{
+		EndTest(WriteResults() ? 0 : -1);
+	}
+}
+
+AShooterHUD* UShooterTestControllerRadarBenchmark::GetRadarHUD() const
+{
+	const APlayerController* PC = GetFirstPlayerController();
+	AShooterHUD* HUD = PC ? Cast<AShooterHUD>(PC->GetHUD()) : nullptr;
+	if (HUD && HUD->GetRadarCollector() && HUD->GetOwningPawn() && HUD->GetMatchState() == EShooterMatchState::Playing)
+	{
+		return HUD;
+	}
+
+	return nullptr;
+}
+
+void UShooterTestControllerRadarBenchmark::SpawnPickups()
+{
+	const APawn* Pawn = GetFirstPlayerController()->GetPawn();
+	const FVector Center = Pawn->GetActorLocation();
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	FRandomStream Random(NumPickups);
+	for (int32 i = 0; i < NumPickups; i++)
+	{
+		const FVector Location = Center + FVector(
+			Random.FRandRange(-ShooterRadarBenchmark::PickupsSpread, ShooterRadarBenchmark::PickupsSpread),
+			Random.FRandRange(-ShooterRadarBenchmark::PickupsSpread, ShooterRadarBenchmark::PickupsSpread),
+			Random.FRandRange(-500.0f, 500.0f));
+
+		GetWorld()->SpawnActor<AShooterPickup_Health>(AShooterPickup_Health::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+	}
+
+	UE_LOG(LogGauntlet, Display, TEXT("Radar benchmark: %d bots, %d extra pickups, measuring %d frames"), NumBots, NumPickups, NumFrames);
+}
+
+void UShooterTestControllerRadarBenchmark::MeasureFrame(AShooterHUD* HUD)
+{
+	if (BenchmarkCanvas == nullptr)
+	{
+		BenchmarkRenderTarget = NewObject<UTextureRenderTarget2D>(this);
+		BenchmarkRenderTarget->InitAutoFormat(ShooterRadarBenchmark::CanvasSizeX, ShooterRadarBenchmark::CanvasSizeY);
+		BenchmarkRenderTarget->UpdateResourceImmediate(true);
+
+		BenchmarkCanvas = NewObject<UCanvas>(this);
+	}
+
+	UWorld* World = GetWorld();
+
+	// fresh canvas every frame, batched radar items are dropped unflushed, there is nothing to present headless
+	FCanvas RenderCanvas(BenchmarkRenderTarget->GameThread_GetRenderTargetResource(), nullptr, World, World->FeatureLevel);
+	BenchmarkCanvas->Init(ShooterRadarBenchmark::CanvasSizeX, ShooterRadarBenchmark::CanvasSizeY, nullptr, &RenderCanvas);
+	BenchmarkCanvas->Update();
+
+	UCanvas* HUDCanvas = HUD->Canvas;
+	HUD->Canvas = BenchmarkCanvas;
+
+	// proxy counts only measured radar update and draw
+	double StartTime, UpdateEndTime, DrawEndTime;
+	uint64 NumAllocs;
+	{
+		FShooterCountingMallocScope CountingMalloc;
+		const uint64 StartAllocs = CountingMalloc.GetNumGameThreadAllocs();
+		StartTime = FPlatformTime::Seconds();
+
+		HUD->GetRadarCollector()->UpdateRadarTick(World->DeltaTimeSeconds);
+		UpdateEndTime = FPlatformTime::Seconds();
+
+		HUD->DrawRadar();
+		DrawEndTime = FPlatformTime::Seconds();
+
+		NumAllocs = CountingMalloc.GetNumGameThreadAllocs() - StartAllocs;
+	}
+
+	HUD->Canvas = HUDCanvas;
+	BenchmarkCanvas->Canvas = nullptr;
+
+	// first frames after pickups spawn grow radar buffers, steady state is measured
+	if (++NumFramesDriven > NumWarmupFrames)
+	{
+		FFrameSample& Sample = Samples.AddDefaulted_GetRef();
+		Sample.UpdateTime = UpdateEndTime - StartTime;
+		Sample.DrawTime = DrawEndTime - UpdateEndTime;
+		Sample.NumAllocs = NumAllocs;
+	}
+}
+
+bool UShooterTestControllerRadarBenchmark::WriteResults() const
+{
+	TArray<double> UpdateTimes, DrawTimes, TotalTimes, Allocs;
+	FString FramesCsv = TEXT("Frame,UpdateUs,DrawUs,TotalUs,Allocs\n");
+
+	for (int32 i = 0; i < Samples.Num(); i++)
+	{
+		const FFrameSample& Sample = Samples[i];
+		UpdateTimes.Add(Sample.UpdateTime * 1e6);
+		DrawTimes.Add(Sample.DrawTime * 1e6);
+		TotalTimes.Add((Sample.UpdateTime + Sample.DrawTime) * 1e6);
+		Allocs.Add((double)Sample.NumAllocs);
+
+		FramesCsv += FString::Printf(TEXT("%d,%.2f,%.2f,%.2f,%llu\n"), i, UpdateTimes.Last(), DrawTimes.Last(), TotalTimes.Last(), Sample.NumAllocs);
+	}
+
+	FString SummaryCsv = TEXT("Metric,Min,Median,P99,Max,Bots,Pickups,Frames\n");
+	auto AddSummary = [&](const TCHAR* Metric, const TArray<double>& Values)
+	{
+		const ShooterRadarBenchmark::FStatSummary Summary = ShooterRadarBenchmark::Summarize(Values);
+		SummaryCsv += FString::Printf(TEXT("%s,%.2f,%.2f,%.2f,%.2f,%d,%d,%d\n"), Metric, Summary.Min, Summary.Median, Summary.P99, Summary.Max, NumBots, NumPickups, Samples.Num());
+		UE_LOG(LogGauntlet, Display, TEXT("Radar benchmark %s: min %.2f, median %.2f, p99 %.2f, max %.2f"), Metric, Summary.Min, Summary.Median, Summary.P99, Summary.Max);
+	};
+
+	AddSummary(TEXT("UpdateUs"), UpdateTimes);
+	AddSummary(TEXT("DrawUs"), DrawTimes);
+	AddSummary(TEXT("TotalUs"), TotalTimes);
+	AddSummary(TEXT("Allocs"), Allocs);
+
+	const FString FramesCsvPath = FPaths::GetPath(CsvPath) / FPaths::GetBaseFilename(CsvPath) + TEXT("_Frames.csv");
+	if (!FFileHelper::SaveStringToFile(SummaryCsv, *CsvPath) || !FFileHelper::SaveStringToFile(FramesCsv, *FramesCsvPath))
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Failed!  Could not write radar benchmark results to %s"), *CsvPath);
+		return false;
+	}
+
+	UE_LOG(LogGauntlet, Display, TEXT("Radar benchmark results written to %s"), *CsvPath);
+	return true;
+}
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+namespace ShooterTests
+{
+	/** Transient game world to spawn synthetic test actors in */
+	struct FScopedTestWorld
+	{
+		UWorld* World = nullptr;
+
+		FScopedTestWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+		}
+
+		~FScopedTestWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		void SpawnActors(int32 Num, TArray<AActor*>& OutActors)
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+			for (int32 i = 0; i < Num; i++)
+			{
+				OutActors.Add(World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams));
+			}
+		}
+
+		/** Spawn actor with root component, so it can be moved */
+		AActor* SpawnMovableActor(const FVector& Location)
+		{
+			TArray<AActor*> Actors;
+			SpawnActors(1, Actors);
+
+			USceneComponent* Root = NewObject<USceneComponent>(Actors[0]);
+			Actors[0]->SetRootComponent(Root);
+			Root->RegisterComponent();
+			Actors[0]->SetActorLocation(Location);
+			return Actors[0];
+		}
+
+		/** Spawn box blocking all channels, e.g. floor for tracers to bounce from */
+		AActor* SpawnBlockingBox(const FVector& Location, const FVector& Extent)
+		{
+			AActor* Actor = SpawnMovableActor(Location);
+
+			UBoxComponent* Box = NewObject<UBoxComponent>(Actor);
+			Box->SetBoxExtent(Extent);
+			Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+			Box->SetupAttachment(Actor->GetRootComponent());
+			Box->RegisterComponent();
+			return Actor;
+		}
+	};
+}
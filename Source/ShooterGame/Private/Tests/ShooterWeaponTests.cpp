@@ -0,0 +1,608 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ShooterGame.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/ShooterTestWorld.h"
+#include "Weapons/ShooterBallistics.h"
+#include "Weapons/ShooterTracerBudget.h"
+#include "Weapons/ShooterTracerPool.h"
+#include "Weapons/ShooterTracerSimulation.h"
+#include "Weapons/ShooterWeapon_Instant.h"
+#include "Weapons/ShooterWeaponTracerPhysic.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterWeaponTests
+{
+	/** Launch solver as it was done in AShooterWeaponTracerPhysic::ComputeProjectileInitialVelocities */
+	void SolveLegacy(const FVector& Start, const FVector& Target, float Speed, float GravityZ, TArray<FVector>& OutVelocityArray)
+	{
+		float Gravity = GravityZ;
+		float VelMagnitude = Speed;
+		FVector P_Delta = Start - Target;
+
+		if (Gravity == 0.0f)
+		{
+			FVector Velocity_StraightLine = -P_Delta.GetSafeNormal() * VelMagnitude;
+			OutVelocityArray = { Velocity_StraightLine };
+			return;
+		}
+
+		float VelMagnitude_Square = VelMagnitude * VelMagnitude;
+		float Gravity_Square = Gravity * Gravity;
+
+		float B = Gravity * P_Delta.Z - VelMagnitude_Square;
+		float Discriminant = B * B - Gravity_Square * (P_Delta.Z * P_Delta.Z + P_Delta.X * P_Delta.X + P_Delta.Y * P_Delta.Y);
+
+		if (Discriminant < 0.0f)
+		{
+			FVector Velocity_MaxDist(P_Delta.X, P_Delta.Y, 0.0f);
+			Velocity_MaxDist.Normalize();
+			Velocity_MaxDist *= -VelMagnitude * 0.707107f;
+			Velocity_MaxDist.Z = VelMagnitude * 0.707107f;
+
+			OutVelocityArray = { Velocity_MaxDist };
+		}
+		else
+		{
+			float Discriminant_Sqrt = sqrtf(Discriminant);
+
+			float TimeStraight = sqrtf((-B - Discriminant_Sqrt) / (0.5f * Gravity_Square));
+
+			if (TimeStraight == 0.0f)
+			{
+				FVector Velocity_StraightLine = -P_Delta.GetSafeNormal() * VelMagnitude;
+				OutVelocityArray = { Velocity_StraightLine };
+				return;
+			}
+
+			float TimeOverhead = sqrtf((-B + Discriminant_Sqrt) / (0.5f * Gravity_Square));
+
+			FVector Velocity_Straight(-P_Delta.X / TimeStraight, -P_Delta.Y / TimeStraight, -P_Delta.Z / TimeStraight - Gravity * TimeStraight * 0.5f);
+			FVector Velocity_Overhead(-P_Delta.X / TimeOverhead, -P_Delta.Y / TimeOverhead, -P_Delta.Z / TimeOverhead - Gravity * TimeOverhead * 0.5f);
+
+			OutVelocityArray = { Velocity_Straight, Velocity_Overhead };
+		}
+	}
+
+	/** Synthetic launch problems: tracer and rocket speeds, some without gravity, some out of range, first one at start */
+	struct FBallisticTestData
+	{
+		TArray<FVector> Starts;
+		TArray<FVector> Targets;
+		TArray<float> Speeds;
+		TArray<float> Gravities;
+		FShooterBallisticBatch Batch;
+
+		explicit FBallisticTestData(int32 Num)
+		{
+			FRandomStream Random(Num);
+			for (int32 i = 0; i < Num; i++)
+			{
+				const FVector Start(Random.FRandRange(-5000.0f, 5000.0f), Random.FRandRange(-5000.0f, 5000.0f), Random.FRandRange(-500.0f, 500.0f));
+				const FVector Target = i == 0 ? Start : Start + FVector(Random.FRandRange(-20000.0f, 20000.0f), Random.FRandRange(-20000.0f, 20000.0f), Random.FRandRange(-2000.0f, 2000.0f));
+
+				Starts.Add(Start);
+				Targets.Add(Target);
+				Speeds.Add(Random.FRand() < 0.5f ? 30000.0f : Random.FRandRange(200.0f, 2000.0f));
+				Gravities.Add(Random.FRand() < 0.125f ? 0.0f : -980.0f);
+			}
+		}
+
+		void Solve()
+		{
+			Batch.Reset();
+			for (int32 i = 0; i < Starts.Num(); i++)
+			{
+				Batch.Add(Starts[i], Targets[i], Speeds[i], Gravities[i]);
+			}
+			Batch.Solve();
+		}
+	};
+
+	/** Tracer state after some steps */
+	struct FTracerSample
+	{
+		FVector Location;
+		FVector Velocity;
+		bool bIsBounced;
+	};
+
+	/** World with floor and its own tracer simulation, as one client replaying weapon shot */
+	struct FTracerReplayWorld
+	{
+		ShooterTests::FScopedTestWorld TestWorld;
+		UShooterTracerSimulation* Simulation = nullptr;
+		AShooterWeapon_Instant* Weapon = nullptr;
+
+		/** Weapon of WeaponClass is held by pawn at Origin aiming along Aim */
+		FTracerReplayWorld(UClass* WeaponClass, const FVector& Origin, const FRotator& Aim)
+		{
+			TestWorld.SpawnBlockingBox(FVector(0.0f, 0.0f, -50.0f), FVector(50000.0f, 50000.0f, 50.0f));
+			Simulation = TestWorld.World->GetSubsystem<UShooterTracerSimulation>();
+
+			APawn* Shooter = TestWorld.World->SpawnActor<APawn>(APawn::StaticClass(), Origin, Aim);
+			Weapon = TestWorld.World->SpawnActor<AShooterWeapon_Instant>(WeaponClass);
+			Weapon->SetInstigator(Shooter);
+		}
+
+		/** Fire shot with Fire and simulate its tracer until it's removed with frame times from FrameTimes, recording its state per step */
+		void Replay(TFunctionRef<void(AShooterWeapon_Instant*)> Fire, TFunctionRef<float()> FrameTimes, TMap<int32, FTracerSample>& OutSamples)
+		{
+			Fire(Weapon);
+			Simulation->Simulate(0.0f);
+
+			for (int32 Frame = 0; Frame < 10000 && Simulation->Num() > 0; Frame++)
+			{
+				const FShooterTracer& Tracer = Simulation->GetTracer(0);
+				OutSamples.Add(Tracer.NumSteps, { Tracer.Location, Tracer.Velocity, Tracer.bIsBouncedFirstTime != 0 });
+				Simulation->Simulate(FrameTimes());
+			}
+		}
+	};
+
+	/** Set property of class defaults, restored when out of scope */
+	template<typename PropertyType, typename ValueType>
+	struct TScopedDefaultsValue
+	{
+		PropertyType* Property;
+		UObject* Defaults;
+		ValueType OldValue;
+
+		TScopedDefaultsValue(UClass* Class, const TCHAR* PropertyName, ValueType Value)
+			: Property(FindFProperty<PropertyType>(Class, PropertyName))
+			, Defaults(Class->GetDefaultObject())
+		{
+			OldValue = Property->GetPropertyValue_InContainer(Defaults);
+			Property->SetPropertyValue_InContainer(Defaults, Value);
+		}
+
+		~TScopedDefaultsValue()
+		{
+			Property->SetPropertyValue_InContainer(Defaults, OldValue);
+		}
+	};
+
+	/** Set console variable, restored when out of scope */
+	struct FScopedConsoleValue
+	{
+		IConsoleVariable* Variable;
+		FString OldValue;
+
+		FScopedConsoleValue(const TCHAR* Name, const TCHAR* Value)
+			: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+		{
+			OldValue = Variable->GetString();
+			Variable->Set(Value, ECVF_SetByCode);
+		}
+
+		~FScopedConsoleValue()
+		{
+			Variable->Set(*OldValue, ECVF_SetByCode);
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterTracerPoolTest, "ShooterGame.Weapons.TracerPool.Recycle",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterTracerPoolTest::RunTest(const FString& Parameters)
+{
+	ShooterTests::FScopedTestWorld TestWorld;
+
+	UShooterTracerPool* Pool = TestWorld.World->GetSubsystem<UShooterTracerPool>();
+	if (!TestNotNull(TEXT("Tracer pool subsystem"), Pool))
+	{
+		return false;
+	}
+
+	const TSubclassOf<AShooterWeaponTracerPhysic> TracerClass = AShooterWeaponTracerPhysic::StaticClass();
+	AShooterWeapon* Weapon = TestWorld.World->SpawnActor<AShooterWeapon_Instant>();
+	const FVector ImpactPoint(2000.0f, 0.0f, 0.0f);
+
+	Pool->Prewarm(TracerClass, 4);
+	Pool->Prewarm(TracerClass, 4);
+	TestEqual(TEXT("Pre-warm isn't repeated"), Pool->GetNumFree(TracerClass), 4);
+
+	TArray<AShooterWeaponTracerPhysic*> Tracers;
+	for (int32 i = 0; i < 6; i++)
+	{
+		Tracers.Add(Pool->Acquire(TracerClass, Weapon, ImpactPoint));
+	}
+
+	TestEqual(TEXT("Hits served by pre-warmed tracers"), Pool->GetNumHits(), 4u);
+	TestEqual(TEXT("Misses spawn new tracers"), Pool->GetNumMisses(), 2u);
+	TestEqual(TEXT("Peak size"), Pool->GetPeakSize(TracerClass), 6);
+	TestEqual(TEXT("No free tracers while all fly"), Pool->GetNumFree(TracerClass), 0);
+
+	for (AShooterWeaponTracerPhysic* Tracer : Tracers)
+	{
+		TestTrue(TEXT("Launched tracer is visible"), !Tracer->IsHidden() && Tracer->GetActorEnableCollision());
+		TestTrue(TEXT("Launched tracer has lifespan"), Tracer->GetLifeSpan() > 0.0f);
+		TestEqual(TEXT("Launched tracer owner"), Tracer->GetOwner(), (AActor*)Weapon);
+		Pool->Release(Tracer);
+	}
+
+	TestEqual(TEXT("Released tracers are free"), Pool->GetNumFree(TracerClass), 6);
+	for (AShooterWeaponTracerPhysic* Tracer : Tracers)
+	{
+		TestTrue(TEXT("Released tracer is not destroyed"), IsValid(Tracer));
+		TestTrue(TEXT("Released tracer is stopped"), Tracer->IsInPool() && Tracer->IsHidden() && !Tracer->GetActorEnableCollision());
+		TestTrue(TEXT("Released tracer has no lifespan"), Tracer->GetLifeSpan() == 0.0f);
+	}
+
+	// releasing twice doesn't duplicate free tracer
+	Pool->Release(Tracers[0]);
+	TestEqual(TEXT("Double release"), Pool->GetNumFree(TracerClass), 6);
+
+	AShooterWeaponTracerPhysic* Reused = Pool->Acquire(TracerClass, Weapon, ImpactPoint);
+	TestTrue(TEXT("Tracer is reused"), Tracers.Contains(Reused) && !Reused->IsInPool());
+	TestEqual(TEXT("Reuse is a hit"), Pool->GetNumHits(), 5u);
+	TestEqual(TEXT("Peak size after reuse"), Pool->GetPeakSize(TracerClass), 6);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterTracerSimulationHitTest, "ShooterGame.Weapons.TracerSimulation.BounceRules",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterTracerSimulationHitTest::RunTest(const FString& Parameters)
+{
+	FShooterTracerParams Params;
+	AShooterWeaponTracerPhysic::StaticClass()->GetDefaultObject<AShooterWeaponTracerPhysic>()->GetSimulationParams(nullptr, Params);
+
+	auto MakeTracer = [&Params](const FVector& Velocity)
+	{
+		FShooterTracer Tracer;
+		Tracer.Location = FVector::ZeroVector;
+		Tracer.Velocity = Velocity;
+		Tracer.LifeSpan = Params.LifeSpan;
+		Tracer.IgnoreActorIds[0] = Tracer.IgnoreActorIds[1] = 0;
+		Tracer.ClassIndex = 0;
+		Tracer.bIsBouncedFirstTime = false;
+		Tracer.bIsStopped = false;
+		Tracer.NumSteps = 0;
+		Tracer.Random.Initialize(0);
+		return Tracer;
+	};
+
+	const FVector Floor(0.0f, 0.0f, 1.0f);
+
+	// glancing hit bounces like projectile movement: tangential friction scaled by impact angle, restitution along normal
+	FShooterTracer Tracer = MakeTracer(FVector(10000.0f, 0.0f, -1000.0f));
+	TestTrue(TEXT("Glancing hit bounces"), UShooterTracerSimulation::ApplyHit(Tracer, Params, Floor));
+	TestTrue(TEXT("Bounce velocity"), Tracer.Velocity.Equals(FVector(9000.0f, 0.0f, 200.0f), 0.1f));
+	TestEqual(TEXT("Bounce lifespan"), Tracer.LifeSpan, Params.DestroyOnBounceTime);
+	TestTrue(TEXT("Bounce is remembered"), Tracer.bIsBouncedFirstTime && !Tracer.bIsStopped);
+
+	TestFalse(TEXT("Second bounce removes tracer"), UShooterTracerSimulation::ApplyHit(Tracer, Params, Floor));
+
+	Tracer = MakeTracer(FVector(1000.0f, 0.0f, -10000.0f));
+	TestFalse(TEXT("Steep hit removes tracer"), UShooterTracerSimulation::ApplyHit(Tracer, Params, Floor));
+
+	Tracer = MakeTracer(FVector(1000.0f, 0.0f, -100.0f));
+	TestTrue(TEXT("Slow bounce keeps tracer"), UShooterTracerSimulation::ApplyHit(Tracer, Params, Floor));
+	TestTrue(TEXT("Slow bounce stops tracer"), Tracer.bIsStopped && Tracer.Velocity.IsZero());
+
+	FShooterTracerParams Unclamped = Params;
+	Unclamped.bClampBounceAngle = false;
+	Unclamped.bShouldBounce = false;
+	Tracer = MakeTracer(FVector(1000.0f, 0.0f, -10000.0f));
+	TestTrue(TEXT("Unclamped tracer without bounce stays"), UShooterTracerSimulation::ApplyHit(Tracer, Unclamped, Floor));
+	TestTrue(TEXT("Unclamped tracer without bounce stops"), Tracer.bIsStopped);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterTracerClosedFormTest, "ShooterGame.Weapons.TracerSimulation.ClosedFormTrajectory",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterTracerClosedFormTest::RunTest(const FString& Parameters)
+{
+	const float GravityZ = -980.0f;
+	const float Speed = 30000.0f;
+	const FVector Start(100.0f, -200.0f, 150.0f);
+	const FVector Target(6000.0f, 2500.0f, -300.0f);
+
+	FShooterBallisticSolution Solution;
+	FShooterBallistics::Solve(Start, Target, Speed, GravityZ, Solution);
+
+	FShooterTracer Tracer;
+	Tracer.SegmentStart = Start;
+	Tracer.SegmentVelocity = Solution.LowVelocity;
+
+	// closed form at solved flight time lands on target
+	FVector Location, Velocity;
+	UShooterTracerSimulation::EvaluateSegment(Tracer, GravityZ, Solution.LowTime, Location, Velocity);
+	TestTrue(TEXT("Trajectory reaches target"), Location.Equals(Target, 1.0f));
+
+	// and matches per tick velocity Verlet integration of projectile movement
+	const float DeltaTime = 1.0f / 60.0f;
+	FVector StepLocation = Start;
+	FVector StepVelocity = Solution.LowVelocity;
+	for (int32 Step = 1; Step <= 30; Step++)
+	{
+		const FVector NewVelocity = StepVelocity + FVector(0.0f, 0.0f, GravityZ * DeltaTime);
+		StepLocation += (StepVelocity + NewVelocity) * (0.5f * DeltaTime);
+		StepVelocity = NewVelocity;
+
+		UShooterTracerSimulation::EvaluateSegment(Tracer, GravityZ, Step * DeltaTime, Location, Velocity);
+		TestTrue(TEXT("Closed form location matches integration"), Location.Equals(StepLocation, 0.5f));
+		TestTrue(TEXT("Closed form velocity matches integration"), Velocity.Equals(StepVelocity, 0.05f));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterBallisticsTest, "ShooterGame.Weapons.Ballistics.MatchesScalarSolver",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterBallisticsTest::RunTest(const FString& Parameters)
+{
+	// odd count to cover vectorized path tail
+	ShooterWeaponTests::FBallisticTestData Data(1027);
+	Data.Solve();
+
+	if (!TestEqual(TEXT("Solutions count"), Data.Batch.LowX.Num(), Data.Starts.Num()))
+	{
+		return false;
+	}
+
+	int32 NumOutOfRange = 0;
+	int32 NumLofted = 0;
+	TArray<FVector> LegacyVelocities;
+	for (int32 i = 0; i < Data.Starts.Num(); i++)
+	{
+		const float Tolerance = Data.Speeds[i] * 1e-3f;
+		const FVector Delta = Data.Targets[i] - Data.Starts[i];
+		const float GravityZ = Data.Gravities[i];
+
+		FShooterBallisticSolution Solution;
+		FShooterBallistics::Solve(Data.Starts[i], Data.Targets[i], Data.Speeds[i], GravityZ, Solution);
+		ShooterWeaponTests::SolveLegacy(Data.Starts[i], Data.Targets[i], Data.Speeds[i], GravityZ, LegacyVelocities);
+
+		TestTrue(TEXT("Low velocity matches legacy solver"), Solution.LowVelocity.Equals(LegacyVelocities[0], Tolerance));
+		TestTrue(TEXT("High velocity matches legacy solver"), Solution.HighVelocity.Equals(LegacyVelocities.Last(), Tolerance));
+		NumLofted += LegacyVelocities.Num() > 1;
+
+		FShooterBallisticSolution BatchSolution;
+		Data.Batch.GetSolution(i, BatchSolution);
+
+		TestTrue(TEXT("Batch in range"), BatchSolution.bInRange == Solution.bInRange);
+		TestTrue(TEXT("Batch low velocity"), BatchSolution.LowVelocity.Equals(Solution.LowVelocity, Tolerance));
+		TestTrue(TEXT("Batch high velocity"), BatchSolution.HighVelocity.Equals(Solution.HighVelocity, Tolerance));
+		TestEqual(TEXT("Batch low time"), BatchSolution.LowTime, Solution.LowTime, FMath::Max(Solution.LowTime * 1e-3f, 1e-4f));
+		TestEqual(TEXT("Batch high time"), BatchSolution.HighTime, Solution.HighTime, FMath::Max(Solution.HighTime * 1e-3f, 1e-4f));
+
+		if (!Solution.bInRange)
+		{
+			NumOutOfRange++;
+			continue;
+		}
+
+		// both solutions land on target at their flight time
+		const FVector Gravity(0.0f, 0.0f, GravityZ);
+		const FVector LowLanding = (Solution.LowVelocity + Gravity * (0.5f * Solution.LowTime)) * Solution.LowTime;
+		const FVector HighLanding = (Solution.HighVelocity + Gravity * (0.5f * Solution.HighTime)) * Solution.HighTime;
+		TestTrue(TEXT("Low solution lands on target"), LowLanding.Equals(Delta, FMath::Max(Delta.Size() * 1e-3f, 1.0f)));
+		TestTrue(TEXT("High solution lands on target"), HighLanding.Equals(Delta, FMath::Max(Delta.Size() * 1e-3f, 1.0f)));
+	}
+
+	TestTrue(TEXT("Data covers out of range targets"), NumOutOfRange > 0);
+	TestTrue(TEXT("Data covers lofted solutions"), NumLofted > 0);
+	TestTrue(TEXT("Target at start is shot straight"), Data.Batch.LowX[0] == 0.0f && Data.Batch.LowY[0] == 0.0f && Data.Batch.LowZ[0] == 0.0f);
+
+	// problem solved alone gets exactly its solution within batch, including batch tail
+	const int32 SingleIndices[] = { 1, 6, Data.Starts.Num() - 1 };
+	FShooterBallisticBatch Single;
+	for (const int32 Index : SingleIndices)
+	{
+		Single.Reset();
+		Single.Add(Data.Starts[Index], Data.Targets[Index], Data.Speeds[Index], Data.Gravities[Index]);
+		Single.Solve();
+
+		TestTrue(TEXT("Solution doesn't depend on position in batch"), Single.LowX[0] == Data.Batch.LowX[Index] && Single.LowY[0] == Data.Batch.LowY[Index]
+			&& Single.LowZ[0] == Data.Batch.LowZ[Index] && Single.HighZ[0] == Data.Batch.HighZ[Index] && Single.LowTime[0] == Data.Batch.LowTime[Index]);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterBallisticsBenchmark, "ShooterGame.Weapons.Ballistics.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterBallisticsBenchmark::RunTest(const FString& Parameters)
+{
+	const int32 ProblemCounts[] = { 16, 256, 4096 };
+	const int32 Iterations = 500;
+
+	TArray<FVector> LegacyVelocities;
+	for (const int32 ProblemCount : ProblemCounts)
+	{
+		ShooterWeaponTests::FBallisticTestData Data(ProblemCount);
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			for (int32 i = 0; i < ProblemCount; i++)
+			{
+				ShooterWeaponTests::SolveLegacy(Data.Starts[i], Data.Targets[i], Data.Speeds[i], Data.Gravities[i], LegacyVelocities);
+			}
+		}
+		const double LegacyTime = (FPlatformTime::Seconds() - StartTime) / Iterations;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			Data.Solve();
+		}
+		const double BatchTime = (FPlatformTime::Seconds() - StartTime) / Iterations;
+
+		AddInfo(FString::Printf(TEXT("%4d problems: per-problem solver %.2f us, batch solver %.2f us (x%.2f), %.1f M solutions/s"),
+			ProblemCount, LegacyTime * 1e6, BatchTime * 1e6, BatchTime > 0.0 ? LegacyTime / BatchTime : 0.0,
+			BatchTime > 0.0 ? ProblemCount / BatchTime * 1e-6 : 0.0));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterTracerBudgetTest, "ShooterGame.Weapons.TracerBudget.ShotDetail",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterTracerBudgetTest::RunTest(const FString& Parameters)
+{
+	ShooterTests::FScopedTestWorld TestWorld;
+
+	UShooterTracerBudget* Budget = TestWorld.World->GetSubsystem<UShooterTracerBudget>();
+	if (!TestNotNull(TEXT("Tracer budget subsystem"), Budget) || !UShooterTracerBudget::IsEnabled())
+	{
+		return false;
+	}
+
+	IConsoleManager& ConsoleManager = IConsoleManager::Get();
+	const float FullDistance = ConsoleManager.FindConsoleVariable(TEXT("ShooterTracers.Budget.FullDistance"))->GetFloat();
+	const float MaxDistance = ConsoleManager.FindConsoleVariable(TEXT("ShooterTracers.Budget.MaxDistance"))->GetFloat();
+	const int32 FullPerFrame = ConsoleManager.FindConsoleVariable(TEXT("ShooterTracers.Budget.FullPerFrame"))->GetInt();
+	const int32 PerSecond = ConsoleManager.FindConsoleVariable(TEXT("ShooterTracers.Budget.PerSecond"))->GetInt();
+
+	// 90 degree view along X
+	FShooterShotViewer Viewer;
+	Viewer.Location = FVector::ZeroVector;
+	Viewer.Direction = FVector(1.0f, 0.0f, 0.0f);
+	Viewer.ViewConeCos = FMath::Cos(FMath::DegreesToRadians(55.0f));
+	const TArrayView<const FShooterShotViewer> Viewers(&Viewer, 1);
+
+	auto ShotAt = [&](float Distance, bool bLocallyFired = false)
+	{
+		return Budget->EvaluateShot(Viewers, FVector(Distance, 500.0f, 0.0f), FVector(Distance + 500.0f, 0.0f, 0.0f), bLocallyFired);
+	};
+
+	TestTrue(TEXT("Far shot is culled"), ShotAt(MaxDistance * 1.5f) == EShooterShotDetail::None);
+	TestEqual(TEXT("Culled by distance"), Budget->GetNumCulledByDistance(), 1u);
+
+	TestTrue(TEXT("Shot behind viewer is culled"), ShotAt(-FullDistance * 0.5f - 500.0f) == EShooterShotDetail::None);
+	TestEqual(TEXT("Culled by view"), Budget->GetNumCulledByView(), 1u);
+
+	TestTrue(TEXT("Mid range shot is beam"), ShotAt((FullDistance + MaxDistance) * 0.5f) == EShooterShotDetail::Beam);
+
+	const FVector CrossStart(FullDistance * 0.5f, -FullDistance, 0.0f);
+	const FVector CrossEnd(FullDistance * 0.5f, FullDistance, 0.0f);
+	TestTrue(TEXT("Shot crossing view with ends out of it is seen"), Budget->EvaluateShot(Viewers, CrossStart, CrossEnd, false) == EShooterShotDetail::Full);
+
+	// rest of frame budget, then beams
+	for (int32 i = 1; i < FullPerFrame; i++)
+	{
+		TestTrue(TEXT("Near shot within frame budget is full"), ShotAt(FullDistance * 0.5f) == EShooterShotDetail::Full);
+	}
+	TestTrue(TEXT("Near shot over frame budget is beam"), ShotAt(FullDistance * 0.5f) == EShooterShotDetail::Beam);
+	TestEqual(TEXT("Degraded by budget"), Budget->GetNumDegradedByBudget(), 1u);
+	TestTrue(TEXT("Locally fired shot is full over budget"), ShotAt(FullDistance * 0.5f, true) == EShooterShotDetail::Full);
+
+	if (PerSecond > 0)
+	{
+		// world time doesn't pass in test, second budget isn't refilled
+		for (int32 i = 0; i < PerSecond; i++)
+		{
+			ShotAt(FullDistance * 0.5f);
+		}
+		TestTrue(TEXT("Shot over second budget is culled"), ShotAt(FullDistance * 0.5f) == EShooterShotDetail::None);
+		TestTrue(TEXT("Culled by budget"), Budget->GetNumCulledByBudget() > 0);
+		TestTrue(TEXT("Locally fired shot is full over second budget"), ShotAt(FullDistance * 0.5f, true) == EShooterShotDetail::Full);
+	}
+
+	TestEqual(TEXT("Full shots counted"), Budget->GetNumShots(EShooterShotDetail::Full), (uint32)FullPerFrame + (PerSecond > 0 ? 2u : 1u));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterTracerReplayTest, "ShooterGame.Weapons.TracerSimulation.DeterministicReplay",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FShooterTracerReplayTest::RunTest(const FString& Parameters)
+{
+	UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+	UClass* WeaponClass = LoadClass<AShooterWeapon_Instant>(nullptr, TEXT("/Game/Blueprints/Weapons/WeapGun.WeapGun_C"));
+	if (!TestNotNull(TEXT("Tracer mesh"), Mesh) || !TestNotNull(TEXT("Instant weapon class"), WeaponClass))
+	{
+		return false;
+	}
+
+	UClass* TracerClass = AShooterWeaponTracerPhysic::StaticClass();
+	const ShooterWeaponTests::TScopedDefaultsValue<FObjectProperty, UObject*> SimulatedMesh(TracerClass, TEXT("SimulatedMesh"), Mesh);
+	const ShooterWeaponTests::TScopedDefaultsValue<FFloatProperty, float> BounceScatter(TracerClass, TEXT("BounceScatterAngle"), 10.0f);
+	const ShooterWeaponTests::FScopedConsoleValue FixedStep(TEXT("ShooterTracers.FixedStep"), TEXT("0.016667"));
+
+	// grazing shot at floor, tracer bounces once and flies on. Shot origin is away from muzzle of unattached weapon
+	const FVector Origin(0.0f, 0.0f, 200.0f);
+	const FRotator Aim = (FVector(4000.0f, 300.0f, 0.0f) - Origin).Rotation();
+	const int32 Seed = 12345;
+
+	// shooter confirms its own hit, remote clients simulate it from replicated origin and seed
+	auto FireConfirmed = [&Origin, Seed, TracerClass](AShooterWeapon_Instant* Weapon)
+	{
+		Weapon->FireConfirmedShotForTest(TracerClass, Origin, Seed);
+	};
+	auto FireSimulated = [&Origin, TracerClass](int32 RandomSeed)
+	{
+		return [&Origin, RandomSeed, TracerClass](AShooterWeapon_Instant* Weapon)
+		{
+			Weapon->FireSimulatedShotForTest(TracerClass, Origin, RandomSeed);
+		};
+	};
+
+	const TCHAR* Modes[] = { TEXT("0"), TEXT("1") };
+	for (const TCHAR* ClosedForm : Modes)
+	{
+		const ShooterWeaponTests::FScopedConsoleValue ClosedFormValue(TEXT("ShooterTracers.ClosedForm"), ClosedForm);
+
+		// shooter and remote client with different frame rates, and remote one replaying shot with other seed
+		TMap<int32, ShooterWeaponTests::FTracerSample> SamplesA, SamplesB, SamplesOtherSeed;
+		{
+			ShooterWeaponTests::FTracerReplayWorld World(WeaponClass, Origin, Aim);
+			World.Replay(FireConfirmed, []() { return 1.0f / 30.0f; }, SamplesA);
+		}
+		{
+			FRandomStream FrameRandom(7);
+			ShooterWeaponTests::FTracerReplayWorld World(WeaponClass, Origin, Aim);
+			World.Replay(FireSimulated(Seed), [&FrameRandom]() { return FrameRandom.FRandRange(1.0f / 144.0f, 1.0f / 20.0f); }, SamplesB);
+		}
+		{
+			ShooterWeaponTests::FTracerReplayWorld World(WeaponClass, Origin, Aim);
+			World.Replay(FireSimulated(Seed + 1), []() { return 1.0f / 30.0f; }, SamplesOtherSeed);
+		}
+
+		const ShooterWeaponTests::FTracerSample* FirstA = SamplesA.Find(0);
+		const ShooterWeaponTests::FTracerSample* FirstB = SamplesB.Find(0);
+		TestTrue(TEXT("Confirmed shot tracer starts at shot origin"), FirstA && FirstA->Location.Equals(Origin, KINDA_SMALL_NUMBER));
+		TestTrue(TEXT("Simulated shot tracer starts at shot origin"), FirstB && FirstB->Location.Equals(Origin, KINDA_SMALL_NUMBER));
+
+		int32 NumMatched = 0;
+		int32 NumBounced = 0;
+		int32 NumSeedDiffers = 0;
+		for (const TPair<int32, ShooterWeaponTests::FTracerSample>& SampleA : SamplesA)
+		{
+			NumBounced += SampleA.Value.bIsBounced;
+
+			const ShooterWeaponTests::FTracerSample* SampleB = SamplesB.Find(SampleA.Key);
+			if (SampleB)
+			{
+				TestTrue(TEXT("Replayed tracer location is the same"), SampleA.Value.Location.Equals(SampleB->Location, KINDA_SMALL_NUMBER));
+				TestTrue(TEXT("Replayed tracer velocity is the same"), SampleA.Value.Velocity.Equals(SampleB->Velocity, KINDA_SMALL_NUMBER));
+				TestTrue(TEXT("Replayed tracer bounce is the same"), SampleA.Value.bIsBounced == SampleB->bIsBounced);
+				NumMatched++;
+			}
+
+			const ShooterWeaponTests::FTracerSample* OtherSeed = SamplesOtherSeed.Find(SampleA.Key);
+			NumSeedDiffers += OtherSeed && SampleA.Value.bIsBounced && !SampleA.Value.Location.Equals(OtherSeed->Location, 1.0f);
+		}
+
+		AddInfo(FString::Printf(TEXT("ClosedForm %s: %d steps recorded, %d compared, %d after bounce"), ClosedForm, SamplesA.Num(), NumMatched, NumBounced));
+		TestTrue(TEXT("Replays are compared at common steps"), NumMatched > 5);
+		TestTrue(TEXT("Tracer bounces"), NumBounced > 0);
+		TestTrue(TEXT("Bounce scatter follows seed"), NumSeedDiffers > 0);
+	}
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
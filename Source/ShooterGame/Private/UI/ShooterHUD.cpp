@@ -13,9 +13,25 @@
 #include "OnlineSubsystemUtils.h"
 #include "Player/ShooterCharacter.h"
 #include "DrawDebugHelpers.h"
+#include "UI/ShooterRadarSubsystem.h"
+#include "Online/ShooterRadarFeed.h"
 
 #define LOCTEXT_NAMESPACE "ShooterGame.HUD.Menu"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Canvas Items"), STAT_RadarCanvasItems, STATGROUP_ShooterRadar);
+
+int32 CVar_ShooterHUD_RadarBatchedDraw = 1;
+static FAutoConsoleVariableRef CVarShooterHUDRadarBatchedDraw(TEXT("ShooterHUD.RadarBatchedDraw"), CVar_ShooterHUD_RadarBatchedDraw, 
+	TEXT("Submit all radar icons as one canvas item instead of one item per icon, compare with 'stat ShooterRadar' Radar Canvas Items"), ECVF_Default);
+
+float CVar_ShooterHUD_RadarMinimapOpacity = 0.6f;
+static FAutoConsoleVariableRef CVarShooterHUDRadarMinimapOpacity(TEXT("ShooterHUD.RadarMinimapOpacity"), CVar_ShooterHUD_RadarMinimapOpacity,
+	TEXT("Opacity of baked minimap drawn inside radar circle, 0 disables minimap and its tiles streaming"), ECVF_Default);
+
+int32 CVar_ShooterHUD_RadarViewerFloorOnly = 0;
+static FAutoConsoleVariableRef CVarShooterHUDRadarViewerFloorOnly(TEXT("ShooterHUD.RadarViewerFloorOnly"), CVar_ShooterHUD_RadarViewerFloorOnly,
+	TEXT("On maps with radar floors draw only radar points on player floor"), ECVF_Default);
+
 const float AShooterHUD::MinHudScale = 0.5f;
 
 AShooterHUD::AShooterHUD(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -80,15 +96,13 @@ AShooterHUD::AShooterHUD(const FObjectInitializer& ObjectInitializer) : Super(Ob
 	RadarCircleIcon = UCanvas::MakeIcon(HUDRadarTexture, 9, 23, 222, 222);
 	RadarHitIcon = UCanvas::MakeIcon(HUDRadarTexture, 256, 128, 38, 117);
 	
-	RadarHealthIcon =   UCanvas::MakeIcon(HUDRadarTexture, 384, 64, 16, 16);
-	RadarAmmoIcon =     UCanvas::MakeIcon(HUDRadarTexture, 400, 64, 16, 16);
-	RadarGrenadesIcon = UCanvas::MakeIcon(HUDRadarTexture, 416, 64, 16, 16);
-	RadarEnemyIcon =    UCanvas::MakeIcon(HUDRadarTexture, 432, 64, 16, 16);
 	RadarDownFragment = UCanvas::MakeIcon(HUDRadarTexture, 448, 64, 16, 8);
 	RadarUpFragment =   UCanvas::MakeIcon(HUDRadarTexture, 464, 64, 16, 8);
 
 	RadarWorldAreaRadius = 5000.0f; // 50m
 	RadarIconHeightIndicatorTreshold = 200.0f; // 2m
+	RadarHitMarkerCapacity = RADAR_HIT_MARKER_MAX;
+	RadarHitMarkerAggregateAngle = RADAR_HIT_MARKER_AGGREGATE_ANGLE;
 
 	Crosshair[EShooterCrosshairDirection::Left] = UCanvas::MakeIcon(HUDMainTexture, 43, 402, 25, 9); // left
 	Crosshair[EShooterCrosshairDirection::Right] = UCanvas::MakeIcon(HUDMainTexture, 88, 402, 25, 9); // right
@@ -121,6 +135,26 @@ void AShooterHUD::BeginPlay()
 
 	AShooterCharacter* Character = Cast<AShooterCharacter>(GetOwningPawn());
 	RadarCollectorChangeTrackedCharacter(Character);
+
+	if (RadarCollector != nullptr)
+	{
+		RadarCollector->RadarHitMarkerData.Configure(RadarHitMarkerCapacity, RadarHitMarkerAggregateAngle);
+
+		if (UShooterRadarSubsystem* RadarModel = RadarCollector->GetRadarModel())
+		{
+			RadarModel->SetStaticPointsGridCellSize(RadarWorldAreaRadius);  // radar disc overlaps at most 3x3 cells
+
+			const FRadarCategoryTable& Categories = RadarModel->GetCategories();
+			RadarCategoryIcons.Reset(Categories.Num());
+			for (int32 Category = 0; Category < Categories.Num(); Category++)
+			{
+				const FRadarCategoryDef& CategoryDef = Categories.GetCategory(Category);
+				RadarCategoryIcons.Add(UCanvas::MakeIcon(HUDRadarTexture, CategoryDef.IconUV.X, CategoryDef.IconUV.Y, CategoryDef.IconSize.X, CategoryDef.IconSize.Y));
+			}
+		}
+	}
+
+	RadarMinimap.Init(GetWorld());
 }
 
 void AShooterHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -134,6 +168,8 @@ void AShooterHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
 		ShooterPC->SetCinematicMode(false,false,false,true,true);
 	}
 
+	RadarMinimap.Reset();
+
 	Super::EndPlay(EndPlayReason);
 }
 
@@ -417,18 +453,47 @@ void AShooterHUD::DrawCanvasIconWithRot(FCanvasIcon& Icon, float X, float Y, flo
 	}
 }
 
+void AShooterHUD::DrawRadarIcon(FCanvasIcon& Icon, float X, float Y)
+{
+	if (CVar_ShooterHUD_RadarBatchedDraw)
+	{
+		RadarIconBatch.AddIcon(Icon, X, Y, ScaleUI);
+		return;
+	}
+
+	Canvas->DrawIcon(Icon, X, Y, ScaleUI);
+	INC_DWORD_STAT(STAT_RadarCanvasItems);
+}
+
+void AShooterHUD::DrawRadarIconWithRot(FCanvasIcon& Icon, float X, float Y, float RotationDeg, FVector2D Pivot)
+{
+	if (CVar_ShooterHUD_RadarBatchedDraw)
+	{
+		RadarIconBatch.AddRotatedIcon(Icon, X, Y, ScaleUI, RotationDeg, Pivot);
+		return;
+	}
+
+	DrawCanvasIconWithRot(Icon, X, Y, ScaleUI, FRotator(0.0f, RotationDeg, 0.0f), Pivot);
+	INC_DWORD_STAT(STAT_RadarCanvasItems);
+}
+
+void AShooterHUD::FlushRadarIcons()
+{
+	INC_DWORD_STAT_BY(STAT_RadarCanvasItems, RadarIconBatch.Flush(Canvas->Canvas));
+}
+
 void AShooterHUD::DrawRadarHitIndicator(FVector TrackHitCharacterPos, FVector2D RadarCenter, float RadarRadius, float RadarRotRadians)
 {
 	float SinTheta = sinf(RadarRotRadians);
 	float CosTheta = -cosf(RadarRotRadians);
 
-	TArray<FVector> InHitDirections;
-	RadarCollector->RadarHitMarkerData.GetRelevantHitFromDirections(InHitDirections);
+	const FRadarHitMarkerData::FHitMarkers& HitMarkers = RadarCollector->RadarHitMarkerData.GetHitMarkers();
+
+	TArray<FVector2D, TInlineAllocator<RADAR_HIT_MARKER_MAX_CAPACITY>> HitMarkerDots;
 
-	for (FVector& HitDirection : InHitDirections)
+	for (const FRadarHitMarker& HitMarker : HitMarkers)
 	{
-		FVector2D HitDirection2D = FVector2D(HitDirection);
-		HitDirection2D.Normalize();
+		const FVector2D& HitDirection2D = HitMarker.Direction;
 
 		// swap x and y to rotate to 90 deg angle
 		float BasicPointPosX =  HitDirection2D.Y * RadarRadius;
@@ -444,90 +509,110 @@ void AShooterHUD::DrawRadarHitIndicator(FVector TrackHitCharacterPos, FVector2D
 		
 		float IconOffsetX = RadarHitIcon.UL * 0.5f * ScaleUI;
 
-		DrawCanvasIconWithRot(RadarHitIcon, PointPosX - IconOffsetX, PointPosY, ScaleUI, FRotator(0.0f, HItMarkerRotDeg, 0.0f), FVector2D(0.5f, 0.0f));
-		DrawRect(FColor::Magenta, PointPosX - 1.0f, PointPosY - 1.0f, 2.0f, 2.0f);
+		DrawRadarIconWithRot(RadarHitIcon, PointPosX - IconOffsetX, PointPosY, HItMarkerRotDeg, FVector2D(0.5f, 0.0f));
+		HitMarkerDots.Add(FVector2D(PointPosX, PointPosY));
+	}
+
+	// hit marker dots are not textured, draw them on top of batched icons
+	FlushRadarIcons();
+
+	for (const FVector2D& HitMarkerDot : HitMarkerDots)
+	{
+		DrawRect(FColor::Magenta, HitMarkerDot.X - 1.0f, HitMarkerDot.Y - 1.0f, 2.0f, 2.0f);
+		INC_DWORD_STAT(STAT_RadarCanvasItems);
 	}
 }
 
-void AShooterHUD::DrawRadarCollectorPoints(TArray<FRadarPoint>&RadarPoints,
-	FVector RadarWorldCenter, FVector2D RadarCenter, float RadarRadius, float RadarRotRadians,
+void AShooterHUD::DrawRadarCollectorPoints(const FRadarPointRegistry& RadarPoints, const FRadarProjectionParams& ProjectionParams,
+	FCanvasIcon &Icon, bool bShowHeightIndicator, FVector2D HeightIndicatorOffset, bool bHeightIndOffsetUseNegY, int32 ExcludedPointIndex)
+{
+	// Calc Points Icons Positions
+	FShooterRadarProjection::Project(ProjectionParams, RadarPoints, RadarDrawList, RadarProjectionScratch);
+
+	DrawRadarDrawList(Icon, bShowHeightIndicator, HeightIndicatorOffset, bHeightIndOffsetUseNegY, ExcludedPointIndex);
+}
+
+void AShooterHUD::DrawRadarCollectorPoints(const FRadarFeedPoints& RadarPoints, const FRadarProjectionParams& ProjectionParams,
 	FCanvasIcon &Icon, bool bShowHeightIndicator, FVector2D HeightIndicatorOffset, bool bHeightIndOffsetUseNegY)
 {
-	float SinTheta = sinf(RadarRotRadians);
-	float CosTheta = -cosf(RadarRotRadians);
-	
+	// Calc Points Icons Positions
+	FShooterRadarProjection::Project(ProjectionParams, RadarPoints.PosX.GetData(), RadarPoints.PosY.GetData(), RadarPoints.PosZ.GetData(),
+		RadarPoints.Flags.GetData(), RadarPoints.Num(), RadarDrawList);
+
+	if (ProjectionParams.ViewerFloor != INDEX_NONE)
+	{
+		FShooterRadarProjection::ApplyFloors(ProjectionParams, RadarPoints.Floors.GetData(), RadarDrawList);
+	}
+
+	DrawRadarDrawList(Icon, bShowHeightIndicator, HeightIndicatorOffset, bHeightIndOffsetUseNegY, INDEX_NONE);
+}
+
+void AShooterHUD::DrawRadarDrawList(FCanvasIcon &Icon, bool bShowHeightIndicator, FVector2D HeightIndicatorOffset, 
+	bool bHeightIndOffsetUseNegY, int32 ExcludedPointIndex)
+{
 	float IconOffsetX = Icon.UL * 0.5f * ScaleUI;
 	float IconOffsetY = Icon.VL * 0.5f * ScaleUI;
 
-	// Calc Points Icons Positions
-	for (FRadarPoint& RadarPoint : RadarPoints)
+	for (const FRadarDrawItem& DrawItem : RadarDrawList)
 	{
-		if (!RadarPoint.bCanShow)  // check FRadarPoint bCanShow param
+		if (DrawItem.PointIndex == ExcludedPointIndex)
 		{
 			continue;
 		}
 
-		FVector2D PointPosDeltaXY = FVector2D(RadarWorldCenter - RadarPoint.LastPos);
-		float DistRelToRadius = PointPosDeltaXY.Size() / RadarWorldAreaRadius;
+		// Draw Radar Pickup Icon
+		DrawRadarIcon(Icon, DrawItem.X - IconOffsetX, DrawItem.Y - IconOffsetY);
 
-		
-		if (!RadarPoint.bCanShowIfOutRadarBorder && DistRelToRadius > 1.0f)  // check FRadarPoint bCanShowIfOutRadarBorder param
+		if (!bShowHeightIndicator)
 		{
 			continue;
 		}
 
-		FVector2D PointRelDirection = FVector2D(PointPosDeltaXY);
-		PointRelDirection.Normalize();
-
-		float PointNormalizedDist = FMath::Clamp(DistRelToRadius, 0.0f, 1.0f);
-		float PointRadarDist = PointNormalizedDist * RadarRadius;
-
-		// somehow point is 90 deg rotated from start, so we spawn X and Y with each other
-		float BasicPointPosX = PointRadarDist * PointRelDirection.Y;
-		float BasicPointPosY = -(PointRadarDist * PointRelDirection.X);
-
-		float PointRadialOffsetX = BasicPointPosX * CosTheta + BasicPointPosY * SinTheta;
-		float PointRadialOffsetY = -(BasicPointPosX * SinTheta) + BasicPointPosY * CosTheta;
-
-		float PointPosX = RadarCenter.Y + PointRadialOffsetX;
-		float PointPosY = RadarCenter.X + PointRadialOffsetY;
-
-		// Draw Radar Pickup Icon
-		Canvas->DrawIcon(Icon, PointPosX - IconOffsetX, PointPosY - IconOffsetY, ScaleUI);
-
 		// If Higher/Lower then RadarIconHeightIndicatorTreshold Draw Height Indicator Icon
-		float PickupDeltaZ = RadarPoint.LastPos.Z - RadarWorldCenter.Z;
-		if (PickupDeltaZ > RadarIconHeightIndicatorTreshold)
+		if (DrawItem.HeightSign > 0)
 		{
 			float UpIconAnchorOffsetY = bHeightIndOffsetUseNegY ? RadarUpFragment.VL * ScaleUI : 0.0f; // change anchor to bottom if bHeightIndOffsetUseNegY
-			Canvas->DrawIcon(RadarUpFragment, PointPosX + HeightIndicatorOffset.X, PointPosY + HeightIndicatorOffset.Y - UpIconAnchorOffsetY, ScaleUI);
+			DrawRadarIcon(RadarUpFragment, DrawItem.X + HeightIndicatorOffset.X, DrawItem.Y + HeightIndicatorOffset.Y - UpIconAnchorOffsetY);
 		}
-		else if (PickupDeltaZ < -RadarIconHeightIndicatorTreshold)
+		else if (DrawItem.HeightSign < 0)
 		{
 			float OffsetMult = bHeightIndOffsetUseNegY ? -1.0f : 1.0f;  // handle arg bHeightIndOffsetUseNegY
-			Canvas->DrawIcon(RadarDownFragment, PointPosX + HeightIndicatorOffset.X, PointPosY + HeightIndicatorOffset.Y * OffsetMult, ScaleUI);
+			DrawRadarIcon(RadarDownFragment, DrawItem.X + HeightIndicatorOffset.X, DrawItem.Y + HeightIndicatorOffset.Y * OffsetMult);
 		}
-
-		//DrawRect(FColor::Red, PointPosX - 1.0f, PointPosY - 1.0f, 2.0f, 2.0f);
 	}
 }
 
 void AShooterHUD::DrawRadar()
 {
+	// radar is drawn every frame, each reason it can't be is logged once
 	if (RadarCollector == nullptr)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("ShooterHUD::DrawRadar() RadarCollector Is Invalid"));
+		static bool bWarnedNoCollector = false;
+		UE_CLOG(!bWarnedNoCollector, LogShooter, Warning, TEXT("ShooterHUD::DrawRadar() RadarCollector Is Invalid"));
+		bWarnedNoCollector = true;
+		return;
+	}
+
+	const UShooterRadarSubsystem* RadarModel = RadarCollector->GetRadarModel();
+	if (RadarModel == nullptr)
+	{
+		static bool bWarnedNoModel = false;
+		UE_CLOG(!bWarnedNoModel, LogShooter, Warning, TEXT("ShooterHUD::DrawRadar() RadarCollector has no radar model"));
+		bWarnedNoModel = true;
 		return;
 	}
 
 	APawn* OwnedPawn = GetOwningPawn();
 	if (!OwnedPawn)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("ShooterHUD::DrawRadar() HUD::GetOwningPawn() returned NULL"));
+		static bool bWarnedNoPawn = false;
+		UE_CLOG(!bWarnedNoPawn, LogShooter, Warning, TEXT("ShooterHUD::DrawRadar() HUD::GetOwningPawn() returned NULL"));
+		bWarnedNoPawn = true;
 		return;
 	}
 
 	Canvas->SetDrawColor(FColor::White);
+	RadarIconBatch.Reset(HUDRadarTexture, Canvas->DrawColor);
 
 	/** Calc Radar Circle Icon Position */
 	float NorthOffset = RadarNorthIcon.VL * ScaleUI;
@@ -537,7 +622,7 @@ void AShooterHUD::DrawRadar()
 	FVector2D RadarCenter(BasicRadarPos.X + RadarRadius, BasicRadarPos.Y + RadarRadius);
 
 	// Draw Radar Circle Icon
-	Canvas->DrawIcon(RadarCircleIcon, BasicRadarPos.X, BasicRadarPos.Y, ScaleUI);
+	DrawRadarIcon(RadarCircleIcon, BasicRadarPos.X, BasicRadarPos.Y);
 
 	// Calc Radar Rotation
 	float Dot = FVector::DotProduct(OwnedPawn->GetActorForwardVector(), FVector::ForwardVector);
@@ -560,7 +645,7 @@ void AShooterHUD::DrawRadar()
 	float NorthIconPointPosY = RadarCenter.Y + NorthRadialOffsetY - NorthSizeY * 0.5f;
 	
 	// Draw North Icon
-	DrawCanvasIconWithRot(RadarNorthIcon, NorthIconPointPosX, NorthIconPointPosY, ScaleUI, FRotator(0.0f, AngleDeg, 0.0f));
+	DrawRadarIconWithRot(RadarNorthIcon, NorthIconPointPosX, NorthIconPointPosY, AngleDeg, FVector2D(0.5f, 0.5f));
 
 	// Icon offsets
 	float HeightIconOffsetX = -RadarUpFragment.UL * ScaleUI;
@@ -570,24 +655,86 @@ void AShooterHUD::DrawRadar()
 	FVector2D HeightIconUpperOffset =  FVector2D(HeightIconOffsetX * 0.5f, HeightIconOffsetY);
 
 	FVector OwnedPawnLocation = OwnedPawn->GetActorLocation(); // player is radar center pos
-	
-	// Draw Grenades Pickups Radar Points
-	DrawRadarCollectorPoints(RadarCollector->GrenadesPickups, OwnedPawnLocation, RadarCenter, RadarRadius, AngleRad,
-		RadarGrenadesIcon, true, HeightIconUpperOffset, true);
 
-	// Draw Health Pickups Radar Points
-	DrawRadarCollectorPoints(RadarCollector->HealthPickups, OwnedPawnLocation, RadarCenter, RadarRadius, AngleRad,
-		RadarHealthIcon, true, HeightIconUpperOffset, true);
+	FRadarProjectionParams ProjectionParams;
+	ProjectionParams.WorldCenter = OwnedPawnLocation;
+	ProjectionParams.WorldRadius = RadarWorldAreaRadius;
+	ProjectionParams.ScreenCenter = RadarCenter;
+	ProjectionParams.ScreenRadius = RadarRadius;
+	ProjectionParams.HeightThreshold = RadarIconHeightIndicatorTreshold;
+	ProjectionParams.SetRotation(AngleRad);
+
+	// multi-storey maps mark radar points by floor instead of height difference
+	const FRadarFloorBands& FloorBands = RadarModel->GetFloorBands();
+	if (FloorBands.HasFloors())
+	{
+		ProjectionParams.ViewerFloor = FloorBands.GetFloor(OwnedPawnLocation.Z);
+		ProjectionParams.bViewerFloorOnly = CVar_ShooterHUD_RadarViewerFloorOnly != 0;
+	}
+
+	// Draw baked minimap over radar circle and under radar points, streams tiles around player
+	if (CVar_ShooterHUD_RadarMinimapOpacity > 0.0f)
+	{
+		RadarMinimap.UpdateStreaming(OwnedPawnLocation, RadarWorldAreaRadius);
+		if (RadarMinimap.IsAvailable())
+		{
+			FlushRadarIcons();  // radar circle goes below minimap
+			INC_DWORD_STAT_BY(STAT_RadarCanvasItems, RadarMinimap.Draw(Canvas->Canvas, ProjectionParams, FLinearColor(1.0f, 1.0f, 1.0f, CVar_ShooterHUD_RadarMinimapOpacity)));
+		}
+	}
+
+	// Remote player on client draws server radar feed, it has radar points out of player network relevancy
+	AShooterPlayerController* ShooterPC = Cast<AShooterPlayerController>(PlayerOwner);
+	AShooterRadarFeed* RadarFeed = ShooterPC ? ShooterPC->GetRadarFeed() : nullptr;
+	const bool bDrawRadarFeed = RadarFeed && RadarFeed->HasSnapshot();
+	if (bDrawRadarFeed)
+	{
+		RadarFeed->UpdateFeedPoints();
+	}
+
+	// Draw Radar Points of each category, category order is draw order
+	const FRadarCategoryTable& Categories = RadarModel->GetCategories();
+	for (int32 Category = 0; Category < Categories.Num() && Category < RadarCategoryIcons.Num(); Category++)
+	{
+		const ERadarHeightIndicator HeightIndicator = Categories.GetCategory(Category).HeightIndicator;
+		const bool bShowHeightIndicator = HeightIndicator != ERadarHeightIndicator::None;
+		const bool bAboveIcon = HeightIndicator == ERadarHeightIndicator::AboveIcon;
+		const FVector2D HeightIconOffset = bAboveIcon ? HeightIconUpperOffset : HeightIconCenterOffset;
 
-	// Draw Ammo Pickups Radar Points
-	DrawRadarCollectorPoints(RadarCollector->AmmoPickups, OwnedPawnLocation, RadarCenter, RadarRadius, AngleRad,
-		RadarAmmoIcon, true, HeightIconUpperOffset, true);
+		if (bDrawRadarFeed)
+		{
+			DrawRadarCollectorPoints(RadarFeed->GetPoints(Category), ProjectionParams,
+				RadarCategoryIcons[Category], bShowHeightIndicator, HeightIconOffset, bAboveIcon);
+		}
+		else
+		{
+			DrawRadarCollectorPoints(RadarModel->GetRegistry(Category), ProjectionParams,
+				RadarCategoryIcons[Category], bShowHeightIndicator, HeightIconOffset, bAboveIcon, RadarCollector->GetTrackedCharacterPointIndex(Category));
+
+			// enemies spotted by player or its allies are shown only on their radars
+			RadarSpottedPoints.Reset();
+			RadarModel->ForEachSpottedPoint(PlayerOwner, [&](int32 SpotCategory, int32 Index, float ExpireTime)
+			{
+				if (SpotCategory == Category)
+				{
+					const FRadarPointRegistry& Registry = RadarModel->GetRegistry(Category);
+					RadarSpottedPoints.PosX.Add(Registry.PosX[Index]);
+					RadarSpottedPoints.PosY.Add(Registry.PosY[Index]);
+					RadarSpottedPoints.PosZ.Add(Registry.PosZ[Index]);
+					RadarSpottedPoints.Flags.Add((uint8)(Registry.Flags[Index] | ERadarPointFlags::CanShow));
+					RadarSpottedPoints.Floors.Add(Registry.Floors[Index]);
+					RadarSpottedPoints.ExpireTimes.Add(ExpireTime);
+				}
+			});
 
-	// Draw Enemies Radar Points
-	DrawRadarCollectorPoints(RadarCollector->Enemies, OwnedPawnLocation, RadarCenter, RadarRadius, AngleRad,
-		RadarEnemyIcon, true, HeightIconCenterOffset);
+			if (RadarSpottedPoints.Num() > 0)
+			{
+				DrawRadarCollectorPoints(RadarSpottedPoints, ProjectionParams, RadarCategoryIcons[Category], bShowHeightIndicator, HeightIconOffset, bAboveIcon);
+			}
+		}
+	}
 
-	// Draw Character Hit Direction Indicators
+	// Draw Character Hit Direction Indicators, submits batched radar icons
 	DrawRadarHitIndicator(OwnedPawnLocation, RadarCenter, RadarRadius, AngleRad);
 }
 
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UI/ShooterRadarCategories.h"
+
+#include "ShooterGame.h"
+#include "Pickups/ShooterPickup_Ammo.h"
+#include "Weapons/ShooterWeapon.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Category Class Resolves"), STAT_RadarCategoryResolves, STATGROUP_ShooterRadar);
+
+FRadarPoint FRadarCategoryDef::MakePointTemplate() const
+{
+	FRadarPoint PointTemplate;
+	PointTemplate.Flags = ERadarPointFlags::CanShow;
+	PointTemplate.ShowTimeMax = ShowTime;
+
+	if (bShowIfOutRadarBorder)
+	{
+		PointTemplate.Flags |= ERadarPointFlags::CanShowIfOutRadarBorder;
+	}
+	if (bUpdatePosOnShowOnly)
+	{
+		PointTemplate.Flags |= ERadarPointFlags::UpdatePosOnShowOnly | ERadarPointFlags::PosUpdateIsBlocked;
+	}
+	if (bStaticPosition)
+	{
+		PointTemplate.Flags |= ERadarPointFlags::StaticPosition;
+	}
+	else if (!bUpdatePosOnShowOnly)
+	{
+		PointTemplate.Flags |= ERadarPointFlags::Interpolated;  // continuously tracked, smoothed between radar updates
+	}
+
+	return PointTemplate;
+}
+
+bool FRadarCategoryDef::Matches(UClass* Class) const
+{
+	if (ActorClass == nullptr || !Class->IsChildOf(ActorClass))
+	{
+		return false;
+	}
+
+	if (AmmoWeaponClass != nullptr)
+	{
+		// ammo weapon type is class default, so class CDO answers for all instances
+		AShooterPickup_Ammo* AmmoPickupCDO = Cast<AShooterPickup_Ammo>(Class->GetDefaultObject());
+		return AmmoPickupCDO && AmmoPickupCDO->IsForWeapon(AmmoWeaponClass);
+	}
+
+	return true;
+}
+
+void FRadarCategoryTable::Init(const TArray<FRadarCategoryDef>& InCategories)
+{
+	Categories = InCategories;
+	ClassToCategory.Reset();
+
+	if (Categories.Num() > RADAR_CATEGORY_MAX)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("FRadarCategoryTable::Init() %d radar categories, only first %d are used"), Categories.Num(), RADAR_CATEGORY_MAX);
+		Categories.SetNum(RADAR_CATEGORY_MAX);
+	}
+}
+
+int32 FRadarCategoryTable::FindCategory(UClass* Class) const
+{
+	if (Class == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* CachedCategory = ClassToCategory.Find(Class))
+	{
+		return *CachedCategory;
+	}
+
+	INC_DWORD_STAT(STAT_RadarCategoryResolves);
+
+	const int32 Category = Categories.IndexOfByPredicate([Class](const FRadarCategoryDef& Def) { return Def.Matches(Class); });
+	ClassToCategory.Add(Class, Category);
+
+	return Category;
+}
@@ -5,268 +5,496 @@
 #include "GameFramework/Actor.h"
 
 #include "Player/ShooterCharacter.h"
-#include "Pickups/ShooterPickup.h"
-#include "Weapons/ShooterWeapon.h"
-#include "Pickups/ShooterPickup_Health.h"
-#include "Pickups/ShooterPickup_Ammo.h"
-#include "Weapons/ShooterWeapon_Projectile.h"
-
-bool FRadarPoint::Update(float DeltaTime)
+#include "UI/ShooterRadarSubsystem.h"
+#include "UI/ShooterRadarFloors.h"
+#include "EngineUtils.h"
+
+DECLARE_CYCLE_STAT(TEXT("Radar Snapshot Gather"), STAT_RadarSnapshotGather, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Position Reads From Actor"), STAT_RadarPositionActorReads, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Position Reads From Snapshot"), STAT_RadarPositionSnapshotReads, STATGROUP_ShooterRadar);
+DECLARE_CYCLE_STAT(TEXT("Radar Grid Rebuild"), STAT_RadarGridRebuild, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Static Position Reads Skipped"), STAT_RadarPositionStaticSkips, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Point Free Slots"), STAT_RadarPointFreeSlots, STATGROUP_ShooterRadar);
+
+void FRadarPositionSnapshot::Gather(UWorld* World)
 {
-	if (IsRadarPointValid())
-	{
-		if (!bPosUpdateIsBlocked)
-		{
-			LastPos = Actor->GetActorLocation();  // update last location
+	SCOPE_CYCLE_COUNTER(STAT_RadarSnapshotGather);
 
-			if (bUpdatePosOnShowOnly)  // handle bUpdatePosOnShowOnly param
-			{
-				bPosUpdateIsBlocked = true;  // when bUpdatePosOnShowOnly=true pos will update only after Show() func call
-			}
-		}
+	Positions.Reset();
 
-		// update show time
-		ShowTime += DeltaTime;
-		if (ShowTimeMax > 0.0f && ShowTime >= ShowTimeMax)
-		{
-			Show(false);
-			ShowTime = 0.0f;
-		}
-
-		return true;
+	if (World == nullptr)
+	{
+		return;
 	}
-	else
+
+	for (TActorIterator<AShooterCharacter> It(World); It; ++It)
 	{
-		return false;
+		AShooterCharacter* Character = *It;
+		Positions.Add(Character, Character->GetActorLocation());
 	}
 }
 
-FRadarPoint RadarPointPickupBase = { nullptr, true };
-FRadarPoint RadarPointEnemyBase = { nullptr, true, true, true, true , FVector::ZeroVector, 0.0f, RADAR_ENEMY_DISPLAY_TIME };
-
-UShooterRadarCollector::UShooterRadarCollector()
+int32 FRadarPointRegistry::Find(const AActor* Actor) const
 {
-	RadarHitMarkerData = FRadarHitMarkerData();
+	if (Actor == nullptr)
+	{
+		return INDEX_NONE;
+	}
 
-	if (this != StaticClass()->GetDefaultObject())  // if cdo, do not subs to delegate
+	const int32* IndexPtr = KeyToIndex.Find(Actor);
+	if (IndexPtr == nullptr)
 	{
-		// Subs delegates
-		DelegateHandle_CharacterSpawn =               AShooterCharacter::NotifyShooterCharacterSpawn.AddUObject(this, &UShooterRadarCollector::CharacterSpawnedEvent);
-		DelegateHandle_CharacterKill =                AShooterCharacter::NotifyShooterCharacterKill.AddUObject(this, &UShooterRadarCollector::CharacterKilledEvent);
-		DelegateHandle_PickupPick =                   AShooterPickup::NotifyPickupPick.AddUObject(this, &UShooterRadarCollector::PickupPickEvent);
-		DelegateHandle_PickupRespawn =                AShooterPickup::NotifyPickupRespawn.AddUObject(this, &UShooterRadarCollector::PickupRespawnEvent);
-		DelegateHandle_CharacterWeaponShot =          AShooterWeapon::NotifyShooterCharacterWeaponShot.AddUObject(this, &UShooterRadarCollector::CharacterWeaponShotEvent);
+		return INDEX_NONE;
 	}
-}
 
-void UShooterRadarCollector::BeginDestroy()
-{
-	Super::BeginDestroy();
-
-	// Unsubs delegates
-	if (DelegateHandle_CharacterSpawn.IsValid())      AShooterCharacter::NotifyShooterCharacterSpawn.Remove(DelegateHandle_CharacterSpawn);
-	if (DelegateHandle_CharacterKill.IsValid())       AShooterCharacter::NotifyShooterCharacterKill.Remove(DelegateHandle_CharacterKill);
-	if (DelegateHandle_PickupPick.IsValid())          AShooterPickup::NotifyPickupPick.Remove(DelegateHandle_PickupPick);
-	if (DelegateHandle_PickupRespawn.IsValid())       AShooterPickup::NotifyPickupRespawn.Remove(DelegateHandle_PickupRespawn);
-	if (DelegateHandle_CharacterWeaponShot.IsValid()) AShooterWeapon::NotifyShooterCharacterWeaponShot.Remove(DelegateHandle_CharacterWeaponShot);
+	// actor ptr could be reused by new actor before stale radar point is removed in Update()
+	const AActor* PointActor = Actors[*IndexPtr];
+	return PointActor == Actor && IsValid(PointActor) ? *IndexPtr : INDEX_NONE;
 }
 
-void UShooterRadarCollector::AddEnemy(AShooterCharacter* Enemy)
+int32 FRadarPointRegistry::Find(const FRadarPointHandle& Handle) const
 {
-	if (Enemy == nullptr)
+	if (!Generations.IsValidIndex(Handle.Index) || Generations[Handle.Index] != Handle.Generation)
 	{
-		return;
+		return INDEX_NONE;
 	}
 
-	const int32 EnemyRadarPointIndex = GetActorRadarPointArrIndex(Enemies, Enemy);
-	if (EnemyRadarPointIndex == -1)
-	{
-		FRadarPoint Point = RadarPointEnemyBase;
-		Point.Actor = Enemy;
-		Enemies.Add(Point);
-	}
+	return IsValid(Actors[Handle.Index]) ? Handle.Index : INDEX_NONE;
 }
 
-void UShooterRadarCollector::RemoveEnemy(AShooterCharacter* Enemy)
+int32 FRadarPointRegistry::FindOrAdd(AActor* Actor, const FRadarPoint& PointTemplate, bool& bOutAdded)
 {
-	if (Enemy == nullptr)
+	check(Actor);
+
+	if (const int32* IndexPtr = KeyToIndex.Find(Actor))
 	{
-		return;
+		const int32 FoundIndex = *IndexPtr;
+		if (Actors[FoundIndex] == Actor && IsValid(Actors[FoundIndex]))
+		{
+			bOutAdded = false;
+			return FoundIndex;
+		}
+
+		FreeSlot(FoundIndex);  // stale radar point, actor ptr is reused
+	}
+
+	int32 Index;
+	if (FreeSlots.Num() > 0)
+	{
+		Index = FreeSlots.Pop(false);
 	}
-	
-	const int32 EnemyRadarPointIndex = GetActorRadarPointArrIndex(Enemies, Enemy);
-	if (EnemyRadarPointIndex != -1)
+	else
 	{
-		FRadarPoint& Point = Enemies[EnemyRadarPointIndex];
-		Point.Actor = nullptr;  // Pending FRadarPoint element in array to be removed in next Update() call
+		Index = Actors.AddUninitialized();
+		PosX.AddUninitialized();
+		PosY.AddUninitialized();
+		PosZ.AddUninitialized();
+		ShowTimes.AddUninitialized();
+		ShowTimeMaxes.AddUninitialized();
+		Flags.AddUninitialized();
+		PrevSamples.AddUninitialized();
+		NextSamples.AddUninitialized();
+		Floors.AddUninitialized();
+		Generations.Add(0);
+		PointKeys.AddUninitialized();
 	}
+
+	const FVector Location = Actor->GetActorLocation();
+
+	Actors[Index] = Actor;
+	SetDisplayedPosition(Index, Location);
+	ShowTimes[Index] = 0.0f;
+	ShowTimeMaxes[Index] = PointTemplate.ShowTimeMax;
+	Flags[Index] = PointTemplate.Flags & ~ERadarPointFlags::FreeSlot;
+	PrevSamples[Index] = Location;
+	NextSamples[Index] = Location;
+
+	PointKeys[Index] = Actor;
+	KeyToIndex.Add(Actor, Index);
+
+	bGridDirty = true;
+
+	bOutAdded = true;
+	return Index;
 }
 
-void UShooterRadarCollector::ShowEnemy(AShooterCharacter* Enemy)
+void FRadarPointRegistry::Remove(const AActor* Actor)
 {
-	if (Enemy == nullptr)
+	if (Actor == nullptr)
 	{
 		return;
 	}
 
-	const int32 EnemyRadarPointIndex = GetActorRadarPointArrIndex(Enemies, Enemy);
-	if (EnemyRadarPointIndex != -1)
+	int32 Index = INDEX_NONE;
+	if (KeyToIndex.RemoveAndCopyValue(Actor, Index))
 	{
-		FRadarPoint& Point = Enemies[EnemyRadarPointIndex];
-		Point.Show(true);
+		Actors[Index] = nullptr;  // Pending radar point to be removed in next Update() call
+		PointKeys[Index] = nullptr;
 	}
 }
 
-TArray<FRadarPoint>* UShooterRadarCollector::GetProperPickupArr(AShooterPickup* Pickup)
+void FRadarPointRegistry::Show(int32 Index, bool bShowOnRadar)
 {
-	if (Cast<AShooterPickup_Health>(Pickup))
-	{
-		return &HealthPickups;
-	}
-	else if (AShooterPickup_Ammo* PickupAmmo = Cast<AShooterPickup_Ammo>(Pickup))
+	uint8& PointFlags = Flags[Index];
+
+	if (bShowOnRadar && (PointFlags & ERadarPointFlags::UpdatePosOnShowOnly))  // handle UpdatePosOnShowOnly flag
 	{
-		if (PickupAmmo->IsForWeapon(AShooterWeapon_Projectile::StaticClass()))
+		PointFlags &= ~ERadarPointFlags::PosUpdateIsBlocked;  // update pos gate open
+
+		// radar may be updated at lower rate then drawn, so revealed point is placed now instead of showing last seen place until next Update()
+		if (const AActor* Actor = Actors[Index])
 		{
-			return &GrenadesPickups;
+			SetDisplayedPosition(Index, Actor->GetActorLocation());
+			bGridDirty = true;
 		}
-		return &AmmoPickups;
 	}
 
-	return nullptr;
+	ShowTimes[Index] = 0.0f; // reset time count
+
+	if (bShowOnRadar)
+	{
+		PointFlags |= ERadarPointFlags::CanShow;
+	}
+	else
+	{
+		PointFlags &= ~ERadarPointFlags::CanShow;
+	}
 }
 
-void UShooterRadarCollector::AddPickup(AShooterPickup* Pickup)
+bool FRadarPointRegistry::UpdatePoint(int32 Index, float DeltaTime, const FRadarPositionSnapshot& Snapshot)
 {
-	if (Pickup == nullptr)
+	const AActor* Actor = Actors[Index];
+	if (!IsValid(Actor))
 	{
-		return;
+		return false;
 	}
 
-	if (TArray<FRadarPoint>* SelectedPickupArr = GetProperPickupArr(Pickup))
+	uint8& PointFlags = Flags[Index];
+	if (PointFlags & ERadarPointFlags::StaticPosition)
+	{
+		INC_DWORD_STAT(STAT_RadarPositionStaticSkips);  // sampled once in FindOrAdd()
+	}
+	else if (!(PointFlags & ERadarPointFlags::PosUpdateIsBlocked))
 	{
-		TArray<FRadarPoint>& Pickups = *SelectedPickupArr;
-		
-		const int32 PickupRadarPointIndex = GetActorRadarPointArrIndex(Pickups, Pickup);
-		if (PickupRadarPointIndex == -1)
+		// update last location
+		FVector Location;
+		if (const FVector* SnapshotLocation = Snapshot.Find(Actor))
 		{
-			FRadarPoint PointToAdd = RadarPointPickupBase;
-			PointToAdd.Actor = Pickup;
-
-			const uint32 Index = Pickups.Num();
-			Pickups.Add(PointToAdd);
+			INC_DWORD_STAT(STAT_RadarPositionSnapshotReads);
+			Location = *SnapshotLocation;
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_RadarPositionActorReads);
+			Location = Actor->GetActorLocation();
+		}
 
-			FRadarPoint& Point = Pickups[Index];
-			Point.Show(true);
+		if (PointFlags & ERadarPointFlags::Interpolated)
+		{
+			// displayed location is set by Interpolate()
+			PrevSamples[Index] = NextSamples[Index];
+			NextSamples[Index] = Location;
 		}
 		else
 		{
-			FRadarPoint& Point = Pickups[PickupRadarPointIndex];
-			Point.Show(true);
+			SetDisplayedPosition(Index, Location);
+		}
+		bGridDirty = true;
+
+		if (PointFlags & ERadarPointFlags::UpdatePosOnShowOnly)
+		{
+			PointFlags |= ERadarPointFlags::PosUpdateIsBlocked;  // pos will update only after Show() func call
 		}
 	}
+
+	// update show time
+	float& ShowTime = ShowTimes[Index];
+	ShowTime += DeltaTime;
+
+	const float ShowTimeMax = ShowTimeMaxes[Index];
+	if (ShowTimeMax > 0.0f && ShowTime >= ShowTimeMax)
+	{
+		Show(Index, false);
+	}
+
+	return true;
 }
 
-void UShooterRadarCollector::RemovePickup(AShooterPickup* Pickup)
+void FRadarPointRegistry::Update(float DeltaTime, const FRadarPositionSnapshot& Snapshot)
 {
-	if (Pickup == nullptr)
+	for (int32 Index = 0; Index < NumSlots(); Index++)
 	{
-		return;
+		if (!IsFreeSlot(Index) && !UpdatePoint(Index, DeltaTime, Snapshot))
+		{
+			FreeSlot(Index);
+		}
 	}
 
-	if (TArray<FRadarPoint>* SelectedPickupArr = GetProperPickupArr(Pickup))
+	INC_DWORD_STAT_BY(STAT_RadarPointFreeSlots, FreeSlots.Num());
+
+	if (GridCellSize > 0.0f && bGridDirty)
 	{
-		TArray<FRadarPoint>& Pickups = *SelectedPickupArr;
+		RebuildGrid();
+	}
+}
+
+void FRadarPointRegistry::Interpolate(float Alpha)
+{
+	Alpha = FMath::Clamp(Alpha, 0.0f, 1.0f);
 
-		const int32 PickupRadarPointIndex = GetActorRadarPointArrIndex(Pickups, Pickup);
-		if (PickupRadarPointIndex != -1)
+	for (int32 Index = 0; Index < Flags.Num(); Index++)
+	{
+		if (Flags[Index] & ERadarPointFlags::Interpolated)
 		{
-			FRadarPoint& Point = Pickups[PickupRadarPointIndex];
-			Point.Show(false);
+			// grid is not marked dirty every frame, Update() rebuilds it when new samples come
+			SetDisplayedPosition(Index, FMath::Lerp(PrevSamples[Index], NextSamples[Index], Alpha));
 		}
 	}
 }
 
-const int32 UShooterRadarCollector::GetActorRadarPointArrIndex(TArray<FRadarPoint>& RadarPointArr, AActor* Actor)
+void FRadarPointRegistry::Reset()
 {
-	if (Actor == nullptr)
-	{
-		return -1;
-	}
+	Actors.Reset();
+	PosX.Reset();
+	PosY.Reset();
+	PosZ.Reset();
+	ShowTimes.Reset();
+	ShowTimeMaxes.Reset();
+	Flags.Reset();
+	PrevSamples.Reset();
+	NextSamples.Reset();
+	Floors.Reset();
+	Generations.Reset();
+	PointKeys.Reset();
+	KeyToIndex.Reset();
+	FreeSlots.Reset();
+
+	GridCells.Reset();
+	GridPointIndices.Reset();
+	OutOfBorderIndices.Reset();
+	bGridDirty = true;
+}
 
-	for (int32 i = 0; i < RadarPointArr.Num(); i++)
+void FRadarPointRegistry::FreeSlot(int32 Index)
+{
+	const AActor* RemovedKey = PointKeys[Index];
+	if (RemovedKey != nullptr)
 	{
-		if (RadarPointArr[i].IsRadarPointValid() && RadarPointArr[i].Actor == Actor)
+		const int32* IndexPtr = KeyToIndex.Find(RemovedKey);
+		if (IndexPtr && *IndexPtr == Index)
 		{
-			return i;
+			KeyToIndex.Remove(RemovedKey);
 		}
 	}
-	
-	return -1;
+
+	Actors[Index] = nullptr;
+	PointKeys[Index] = nullptr;
+	Flags[Index] = ERadarPointFlags::FreeSlot;
+	Generations[Index]++;
+
+	FreeSlots.Add(Index);  // capacity only grows to max registered radar points count
+
+	bGridDirty = true;
+}
+
+void FRadarPointRegistry::SetDisplayedPosition(int32 Index, const FVector& Location)
+{
+	PosX[Index] = Location.X;
+	PosY[Index] = Location.Y;
+	PosZ[Index] = Location.Z;
+	Floors[Index] = FloorBands ? FloorBands->GetFloor(Location.Z) : 0;
+}
+
+void FRadarPointRegistry::SetPosition(int32 Index, const FVector& Position)
+{
+	SetDisplayedPosition(Index, Position);
+	PrevSamples[Index] = Position;
+	NextSamples[Index] = Position;
+
+	bGridDirty = true;
+}
+
+void FRadarPointRegistry::Restore(int32 Index, uint8 InFlags, float ShowTime)
+{
+	// static position was sampled in FindOrAdd(), other points open pos update gate once
+	Flags[Index] = InFlags & ~ERadarPointFlags::PosUpdateIsBlocked;
+	ShowTimes[Index] = ShowTime;
 }
 
-void UShooterRadarCollector::UpdateRadarPointArr(TArray<FRadarPoint>& RadarPointArr, float DeltaTime)
+void FRadarPointRegistry::SetFloorBands(const FRadarFloorBands* InFloorBands)
 {
-	for (int32 Index = RadarPointArr.Num() - 1; Index >= 0; --Index)
+	FloorBands = InFloorBands;
+
+	for (int32 Index = 0; Index < NumSlots(); Index++)
 	{
-		FRadarPoint& RadarPoint = RadarPointArr[Index];
-		if (!RadarPoint.Update(DeltaTime))
-		{
-			RadarPointArr.RemoveAtSwap(Index, 1, false);
-		}
+		Floors[Index] = FloorBands ? FloorBands->GetFloor(PosZ[Index]) : 0;
 	}
-	
-	RadarPointArr.Shrink();
 }
 
-void UShooterRadarCollector::CharacterSpawnedEvent(AShooterCharacter* Character)
+void FRadarPointRegistry::SetGridCellSize(float CellSize)
 {
-	if (Character == nullptr 
-		|| Character == TrackedCharacter)
+	CellSize = FMath::Max(CellSize, 0.0f);
+	if (CellSize == GridCellSize)
 	{
 		return;
 	}
 
-	AddEnemy(Character);
+	GridCellSize = CellSize;
+	GridCells.Reset();
+	GridPointIndices.Reset();
+	OutOfBorderIndices.Reset();
+	bGridDirty = true;
+
+	if (GridCellSize > 0.0f)
+	{
+		RebuildGrid();
+	}
 }
 
-void UShooterRadarCollector::CharacterKilledEvent(AShooterCharacter* Character)
+void FRadarPointRegistry::RebuildGrid()
 {
-	if (Character == nullptr)
+	SCOPE_CYCLE_COUNTER(STAT_RadarGridRebuild);
+
+	GridCells.Reset();
+	GridPointIndices.Reset();
+	OutOfBorderIndices.Reset();
+	bGridDirty = false;
+
+	const float InvCellSize = 1.0f / GridCellSize;
+
+	// (packed cell, point index), sorted by cell so each cell radar points are contiguous
+	TArray<TPair<int64, int32>>& CellPoints = GridCellPoints;
+	CellPoints.Reset();
+
+	for (int32 Index = 0; Index < NumSlots(); Index++)
 	{
-		return;
+		if (IsFreeSlot(Index))
+		{
+			continue;
+		}
+
+		if (Flags[Index] & ERadarPointFlags::CanShowIfOutRadarBorder)
+		{
+			OutOfBorderIndices.Add(Index);
+			continue;
+		}
+
+		const int32 CellX = FMath::FloorToInt(PosX[Index] * InvCellSize);
+		const int32 CellY = FMath::FloorToInt(PosY[Index] * InvCellSize);
+		CellPoints.Emplace(((int64)CellX << 32) | (uint32)CellY, Index);
 	}
 
-	RemoveEnemy(Character);
+	CellPoints.Sort([](const TPair<int64, int32>& A, const TPair<int64, int32>& B) { return A.Key < B.Key; });
+
+	GridPointIndices.Reserve(CellPoints.Num());
+
+	FIntPoint* CellRange = nullptr;
+	for (int32 i = 0; i < CellPoints.Num(); i++)
+	{
+		const int64 PackedCell = CellPoints[i].Key;
+		if (i == 0 || CellPoints[i - 1].Key != PackedCell)
+		{
+			CellRange = &GridCells.Add(FIntPoint((int32)(PackedCell >> 32), (int32)(uint32)PackedCell), FIntPoint(i, 0));
+		}
+
+		CellRange->Y++;
+		GridPointIndices.Add(CellPoints[i].Value);
+	}
 }
 
-void UShooterRadarCollector::PickupPickEvent(AShooterPickup* Pickup)
+bool FRadarPointRegistry::GatherCandidates(const FVector& Center, float Radius, TArray<int32>& OutIndices) const
 {
-	if (Pickup == nullptr)
+	OutIndices.Reset();
+
+	if (GridCellSize <= 0.0f || bGridDirty)
 	{
-		return;
+		return false;
+	}
+
+	OutIndices.Append(OutOfBorderIndices);
+
+	const float InvCellSize = 1.0f / GridCellSize;
+	const int32 MinCellX = FMath::FloorToInt((Center.X - Radius) * InvCellSize);
+	const int32 MaxCellX = FMath::FloorToInt((Center.X + Radius) * InvCellSize);
+	const int32 MinCellY = FMath::FloorToInt((Center.Y - Radius) * InvCellSize);
+	const int32 MaxCellY = FMath::FloorToInt((Center.Y + Radius) * InvCellSize);
+
+	for (int32 CellX = MinCellX; CellX <= MaxCellX; CellX++)
+	{
+		for (int32 CellY = MinCellY; CellY <= MaxCellY; CellY++)
+		{
+			if (const FIntPoint* CellRange = GridCells.Find(FIntPoint(CellX, CellY)))
+			{
+				OutIndices.Append(GridPointIndices.GetData() + CellRange->X, CellRange->Y);
+			}
+		}
 	}
- 
-	RemovePickup(Pickup);
+
+	return true;
+}
+
+void FRadarHitMarkerData::Configure(int32 Capacity, float AggregateAngleDeg)
+{
+	HitMarkers.SetCapacity(Capacity);
+	NumAddedSinceUpdate = FMath::Min(NumAddedSinceUpdate, HitMarkers.Num());
+	AggregateAngleCos = FMath::Cos(FMath::DegreesToRadians(FMath::Max(AggregateAngleDeg, 0.0f)));
 }
 
-void UShooterRadarCollector::PickupRespawnEvent(AShooterPickup* Pickup)
+void FRadarHitMarkerData::AddHitDirection(const FVector& HitFromDirection)
 {
-	if (Pickup == nullptr)
+	const FVector2D Direction = FVector2D(HitFromDirection).GetSafeNormal();
+	if (Direction.IsZero())
 	{
 		return;
 	}
 
-	AddPickup(Pickup);
+	// same frame hits are newest ones
+	for (int32 i = HitMarkers.Num() - NumAddedSinceUpdate; i < HitMarkers.Num(); i++)
+	{
+		FRadarHitMarker& HitMarker = HitMarkers[i];
+		if ((HitMarker.Direction | Direction) >= AggregateAngleCos)
+		{
+			HitMarker.NumHits++;
+			return;
+		}
+	}
+
+	FRadarHitMarker& HitMarker = HitMarkers.Add(FRadarHitMarker());
+	HitMarker.Direction = Direction;
+	HitMarker.NumHits = 1;
+
+	NumAddedSinceUpdate = FMath::Min(NumAddedSinceUpdate + 1, HitMarkers.Num());
 }
 
-void UShooterRadarCollector::CharacterWeaponShotEvent(AShooterCharacter* Character, AShooterWeapon* Weapon)
+void FRadarHitMarkerData::Update(float DeltaTime)
 {
-	if (Character == nullptr)
+	NumAddedSinceUpdate = 0;
+
+	int32 NumExpired = 0;
+	for (FRadarHitMarker& HitMarker : HitMarkers)
 	{
-		return;
+		HitMarker.ShowTime += DeltaTime;
+
+		// all hit markers have same display time, so they expire in add order
+		if (HitMarker.ShowTime >= RADAR_HIT_MARKER_DISPLAY_TIME)
+		{
+			NumExpired++;
+		}
 	}
-	
-	ShowEnemy(Character);
+
+	HitMarkers.PopOldest(NumExpired);
+}
+
+UShooterRadarSubsystem* UShooterRadarCollector::GetRadarModel() const
+{
+	UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<UShooterRadarSubsystem>() : nullptr;
+}
+
+int32 UShooterRadarCollector::GetTrackedCharacterPointIndex(int32 Category) const
+{
+	const UShooterRadarSubsystem* RadarModel = GetRadarModel();
+	return RadarModel ? RadarModel->GetRegistry(Category).Find(TrackedCharacter) : INDEX_NONE;
 }
 
 void UShooterRadarCollector::AddHitMarker(FVector HitFromDirection)
@@ -286,21 +514,30 @@ void UShooterRadarCollector::TrackedCharacterTakePointDmgEvent(AActor* DamagedAc
 
 void UShooterRadarCollector::UpdateRadarTick(float DeltaTime)
 {
-	// update pickups radar points
-	UpdateRadarPointArr(HealthPickups, DeltaTime);
-	UpdateRadarPointArr(AmmoPickups, DeltaTime);
-	UpdateRadarPointArr(GrenadesPickups, DeltaTime);
+	if (UShooterRadarSubsystem* RadarModel = GetRadarModel())
+	{
+		RadarModel->UpdateRadar();  // shared model is updated once per frame for all viewers
+	}
 
-	UpdateRadarPointArr(Enemies, DeltaTime);  // update enemies radar points
-	
 	RadarHitMarkerData.Update(DeltaTime);     // update radar hit markers
 }
 
 void UShooterRadarCollector::SetTrackedCharacter(AShooterCharacter* ShooterCharacter)
 {
+	if (TrackedCharacter == ShooterCharacter)
+	{
+		return;
+	}
+
+	if (IsValid(TrackedCharacter))
+	{
+		TrackedCharacter->OnTakePointDamage.RemoveDynamic(this, &UShooterRadarCollector::TrackedCharacterTakePointDmgEvent);
+	}
+
+	TrackedCharacter = ShooterCharacter;
+
 	if (ShooterCharacter)
 	{
 		ShooterCharacter->OnTakePointDamage.AddDynamic(this, &UShooterRadarCollector::TrackedCharacterTakePointDmgEvent);
-		TrackedCharacter = ShooterCharacter;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UI/ShooterRadarFloors.h"
+
+#include "ShooterGame.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/PackageName.h"
+
+void FRadarFloorBands::Build(UWorld* World, const TArray<FRadarMapFloors>& MapFloors)
+{
+	Reset();
+
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	TArray<float> FloorHeights;
+
+	const FString MapName = UWorld::RemovePIEPrefix(FPackageName::GetShortName(World->GetOutermost()->GetName()));
+	for (const FRadarMapFloors& Floors : MapFloors)
+	{
+		if (Floors.Map == MapName)
+		{
+			FloorHeights.Append(Floors.FloorHeights);
+		}
+	}
+
+	// level designers may mark floors in map instead of config
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		if (It->ActorHasTag(RADAR_FLOOR_TAG))
+		{
+			FVector Origin, Extent;
+			It->GetActorBounds(false, Origin, Extent);
+			FloorHeights.Add(Origin.Z - Extent.Z);
+		}
+	}
+
+	Init(MoveTemp(FloorHeights));
+
+	if (HasFloors())
+	{
+		UE_LOG(LogShooter, Log, TEXT("FRadarFloorBands::Build() %s has %d radar floors"), *MapName, NumFloors());
+	}
+}
+
+void FRadarFloorBands::Init(TArray<float> FloorHeights)
+{
+	Reset();
+
+	FloorHeights.Sort();
+	for (const float Height : FloorHeights)
+	{
+		if (FloorBottoms.Num() >= RADAR_FLOOR_MAX - 1)
+		{
+			break;
+		}
+		if (FloorBottoms.Num() == 0 || Height - FloorBottoms.Last() >= RADAR_FLOOR_MIN_HEIGHT)
+		{
+			FloorBottoms.Add(Height);
+		}
+	}
+
+	if (FloorBottoms.Num() == 0)
+	{
+		return;
+	}
+
+	// bucket is not taller then smallest floor, so it contains at most one floor bottom
+	float BucketHeight = RADAR_FLOOR_MIN_HEIGHT;
+	for (int32 i = 1; i < FloorBottoms.Num(); i++)
+	{
+		BucketHeight = FMath::Min(BucketHeight, FloorBottoms[i] - FloorBottoms[i - 1]);
+	}
+	InvBucketHeight = 1.0f / BucketHeight;
+
+	const int32 NumBuckets = FMath::FloorToInt((FloorBottoms.Last() - FloorBottoms[0]) * InvBucketHeight) + 1;
+	BucketFloors.SetNumUninitialized(NumBuckets);
+
+	// floor bottom exactly at bucket bottom is left to GetFloor() compare, so Z rounded to neighbour bucket still gets right floor
+	int32 Floor = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets; Bucket++)
+	{
+		const float BucketBottom = FloorBottoms[0] + Bucket * BucketHeight;
+		while (Floor < FloorBottoms.Num() && FloorBottoms[Floor] < BucketBottom)
+		{
+			Floor++;
+		}
+		BucketFloors[Bucket] = (uint8)Floor;
+	}
+}
+
+void FRadarFloorBands::Reset()
+{
+	FloorBottoms.Reset();
+	BucketFloors.Reset();
+	InvBucketHeight = 0.0f;
+}
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UI/ShooterRadarIconBatch.h"
+
+void FRadarIconBatch::Reset(UTexture* InTexture, const FLinearColor& InColor)
+{
+	Texture = InTexture;
+	Color = InColor;
+	Triangles.Reset();
+}
+
+void FRadarIconBatch::AddIcon(const FCanvasIcon& Icon, float X, float Y, float Scale)
+{
+	const float SizeX = Icon.UL * Scale;
+	const float SizeY = Icon.VL * Scale;
+
+	AddQuad(Icon, FVector2D(X, Y), FVector2D(X + SizeX, Y), FVector2D(X + SizeX, Y + SizeY), FVector2D(X, Y + SizeY));
+}
+
+void FRadarIconBatch::AddRotatedIcon(const FCanvasIcon& Icon, float X, float Y, float Scale, float RotationDeg, FVector2D Pivot)
+{
+	const float SizeX = Icon.UL * Scale;
+	const float SizeY = Icon.VL * Scale;
+
+	float Sin, Cos;
+	FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(RotationDeg));
+
+	// corners relative to pivot, rotated same way FCanvasTileItem does: FRotationMatrix(Yaw) around pivot
+	const FVector2D PivotPos(X + SizeX * Pivot.X, Y + SizeY * Pivot.Y);
+	auto Corner = [&](float LocalX, float LocalY)
+	{
+		const float RelX = LocalX - SizeX * Pivot.X;
+		const float RelY = LocalY - SizeY * Pivot.Y;
+		return FVector2D(PivotPos.X + RelX * Cos - RelY * Sin, PivotPos.Y + RelX * Sin + RelY * Cos);
+	};
+
+	AddQuad(Icon, Corner(0.0f, 0.0f), Corner(SizeX, 0.0f), Corner(SizeX, SizeY), Corner(0.0f, SizeY));
+}
+
+void FRadarIconBatch::AddQuad(const FCanvasIcon& Icon, const FVector2D& TopLeft, const FVector2D& TopRight, const FVector2D& BottomRight, const FVector2D& BottomLeft)
+{
+	if (Texture == nullptr)
+	{
+		return;
+	}
+
+	const float InvWidth = 1.0f / Texture->GetSurfaceWidth();
+	const float InvHeight = 1.0f / Texture->GetSurfaceHeight();
+
+	const FVector2D UV0(Icon.U * InvWidth, Icon.V * InvHeight);
+	const FVector2D UV1((Icon.U + Icon.UL) * InvWidth, (Icon.V + Icon.VL) * InvHeight);
+
+	FCanvasUVTri& Tri0 = Triangles.AddDefaulted_GetRef();
+	Tri0.V0_Pos = TopLeft;     Tri0.V0_UV = UV0;                      Tri0.V0_Color = Color;
+	Tri0.V1_Pos = TopRight;    Tri0.V1_UV = FVector2D(UV1.X, UV0.Y);  Tri0.V1_Color = Color;
+	Tri0.V2_Pos = BottomRight; Tri0.V2_UV = UV1;                      Tri0.V2_Color = Color;
+
+	FCanvasUVTri& Tri1 = Triangles.AddDefaulted_GetRef();
+	Tri1.V0_Pos = TopLeft;     Tri1.V0_UV = UV0;                      Tri1.V0_Color = Color;
+	Tri1.V1_Pos = BottomRight; Tri1.V1_UV = UV1;                      Tri1.V1_Color = Color;
+	Tri1.V2_Pos = BottomLeft;  Tri1.V2_UV = FVector2D(UV0.X, UV1.Y);  Tri1.V2_Color = Color;
+}
+
+int32 FRadarIconBatch::Flush(FCanvas* Canvas)
+{
+	if (Triangles.Num() == 0 || Texture == nullptr || Canvas == nullptr)
+	{
+		Triangles.Reset();
+		return 0;
+	}
+
+	FCanvasTriangleItem TriangleItem(Triangles, Texture->Resource);
+	TriangleItem.BlendMode = FCanvas::BlendToSimpleElementBlend(BLEND_Translucent);
+	Canvas->DrawItem(TriangleItem);
+
+	Triangles.Reset();
+	return 1;
+}
@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UI/ShooterRadarMinimap.h"
+
+#include "Engine/Texture2D.h"
+#include "Engine/World.h"
+#include "UI/ShooterRadarCollector.h"
+#include "UI/ShooterRadarProjection.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Minimap Tiles Resident"), STAT_RadarMinimapTilesResident, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Minimap Tiles Drawn"), STAT_RadarMinimapTilesDrawn, STATGROUP_ShooterRadar);
+
+namespace RadarMinimap
+{
+	/** Tiles are requested within this many radar radii around radar center */
+	const float RequestRadiusScale = 1.25f;
+
+	/** Resident tiles are released beyond this many radar radii, more then RequestRadiusScale so tiles don't thrash on border */
+	const float ReleaseRadiusScale = 1.75f;
+
+	/** Radar circle polygon segments */
+	const int32 CircleSegments = 48;
+
+	/** Keep part of Polygon on inner side of axis aligned line, Axis 0 is X, 1 is Y */
+	void ClipPolygon(const TArray<FVector2D>& Polygon, int32 Axis, float Bound, bool bKeepGreater, TArray<FVector2D>& OutPolygon)
+	{
+		OutPolygon.Reset();
+
+		auto IsInside = [&](const FVector2D& Point) { return bKeepGreater ? Point[Axis] >= Bound : Point[Axis] <= Bound; };
+
+		for (int32 i = 0; i < Polygon.Num(); i++)
+		{
+			const FVector2D& Current = Polygon[i];
+			const FVector2D& Next = Polygon[(i + 1) % Polygon.Num()];
+			const bool bCurrentInside = IsInside(Current);
+			const bool bNextInside = IsInside(Next);
+
+			if (bCurrentInside)
+			{
+				OutPolygon.Add(Current);
+			}
+			if (bCurrentInside != bNextInside)
+			{
+				const float Alpha = (Bound - Current[Axis]) / (Next[Axis] - Current[Axis]);
+				OutPolygon.Add(FMath::Lerp(Current, Next, Alpha));
+			}
+		}
+	}
+}
+
+FBox2D UShooterRadarMinimapData::GetTileBounds(int32 X, int32 Y) const
+{
+	const FVector2D Min = WorldOrigin + FVector2D(X, Y) * TileWorldSize;
+	return FBox2D(Min, Min + FVector2D(TileWorldSize, TileWorldSize));
+}
+
+FIntRect UShooterRadarMinimapData::GetTileRange(const FVector2D& Center, float HalfSize) const
+{
+	if (TileWorldSize <= 0.0f || NumTilesX <= 0 || NumTilesY <= 0)
+	{
+		return FIntRect(0, 0, -1, -1);
+	}
+
+	const FVector2D Min = (Center - FVector2D(HalfSize, HalfSize) - WorldOrigin) / TileWorldSize;
+	const FVector2D Max = (Center + FVector2D(HalfSize, HalfSize) - WorldOrigin) / TileWorldSize;
+
+	return FIntRect(
+		FMath::Max(FMath::FloorToInt(Min.X), 0),
+		FMath::Max(FMath::FloorToInt(Min.Y), 0),
+		FMath::Min(FMath::FloorToInt(Max.X), NumTilesX - 1),
+		FMath::Min(FMath::FloorToInt(Max.Y), NumTilesY - 1));
+}
+
+FString UShooterRadarMinimapData::GetPackageDirectory(const FString& MapName)
+{
+	return FString::Printf(TEXT("/Game/Minimaps/%s"), *MapName);
+}
+
+FString UShooterRadarMinimapData::GetPackagePath(const FString& MapName)
+{
+	return FString::Printf(TEXT("%s/DA_%s_Minimap"), *GetPackageDirectory(MapName), *MapName);
+}
+
+void FRadarMinimap::Init(UWorld* World)
+{
+	Reset();
+
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	const FString MapName = UWorld::RemovePIEPrefix(FPackageName::GetShortName(World->GetOutermost()->GetName()));
+	const FString PackagePath = UShooterRadarMinimapData::GetPackagePath(MapName);
+
+	// maps without baked minimap are fine, radar draws only its circle then
+	if (!FPackageName::DoesPackageExist(PackagePath))
+	{
+		return;
+	}
+
+	const FSoftObjectPath DataPath(PackagePath + TEXT(".") + FPackageName::GetShortName(PackagePath));
+	DataHandle = Streamable.RequestAsyncLoad(DataPath);
+}
+
+void FRadarMinimap::Reset()
+{
+	for (TPair<int32, TSharedPtr<FStreamableHandle>>& Tile : TileHandles)
+	{
+		Tile.Value->ReleaseHandle();
+	}
+	TileHandles.Reset();
+
+	if (DataHandle.IsValid())
+	{
+		DataHandle->ReleaseHandle();
+		DataHandle.Reset();
+	}
+}
+
+UShooterRadarMinimapData* FRadarMinimap::GetData() const
+{
+	return DataHandle.IsValid() && DataHandle->HasLoadCompleted() ? Cast<UShooterRadarMinimapData>(DataHandle->GetLoadedAsset()) : nullptr;
+}
+
+void FRadarMinimap::UpdateStreaming(const FVector& WorldCenter, float WorldRadius)
+{
+	const UShooterRadarMinimapData* Data = GetData();
+	if (Data == nullptr)
+	{
+		return;
+	}
+
+	const FVector2D Center(WorldCenter);
+	const FIntRect RequestRange = Data->GetTileRange(Center, WorldRadius * RadarMinimap::RequestRadiusScale);
+	const FIntRect KeepRange = Data->GetTileRange(Center, WorldRadius * RadarMinimap::ReleaseRadiusScale);
+
+	ReleasedTiles.Reset();
+	for (const TPair<int32, TSharedPtr<FStreamableHandle>>& Tile : TileHandles)
+	{
+		const FIntPoint TileCoords(Tile.Key % Data->NumTilesX, Tile.Key / Data->NumTilesX);
+		if (TileCoords.X < KeepRange.Min.X || TileCoords.X > KeepRange.Max.X || TileCoords.Y < KeepRange.Min.Y || TileCoords.Y > KeepRange.Max.Y)
+		{
+			ReleasedTiles.Add(Tile.Key);
+		}
+	}
+	for (const int32 TileIndex : ReleasedTiles)
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		TileHandles.RemoveAndCopyValue(TileIndex, Handle);
+		Handle->ReleaseHandle();
+	}
+
+	for (int32 Y = RequestRange.Min.Y; Y <= RequestRange.Max.Y; Y++)
+	{
+		for (int32 X = RequestRange.Min.X; X <= RequestRange.Max.X; X++)
+		{
+			const int32 TileIndex = Data->GetTileIndex(X, Y);
+			if (!TileHandles.Contains(TileIndex) && Data->Tiles.IsValidIndex(TileIndex) && !Data->Tiles[TileIndex].IsNull())
+			{
+				TileHandles.Add(TileIndex, Streamable.RequestAsyncLoad(Data->Tiles[TileIndex].ToSoftObjectPath()));
+			}
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_RadarMinimapTilesResident, TileHandles.Num());
+}
+
+int32 FRadarMinimap::Draw(FCanvas* Canvas, const FRadarProjectionParams& Params, const FLinearColor& Color)
+{
+	const UShooterRadarMinimapData* Data = GetData();
+	if (Data == nullptr || Canvas == nullptr)
+	{
+		return 0;
+	}
+
+	const FVector2D Center(Params.WorldCenter);
+	const FIntRect DrawRange = Data->GetTileRange(Center, Params.WorldRadius);
+	const float InvTileWorldSize = 1.0f / Data->TileWorldSize;
+
+	int32 NumItems = 0;
+	for (int32 Y = DrawRange.Min.Y; Y <= DrawRange.Max.Y; Y++)
+	{
+		for (int32 X = DrawRange.Min.X; X <= DrawRange.Max.X; X++)
+		{
+			const TSharedPtr<FStreamableHandle>* Handle = TileHandles.Find(Data->GetTileIndex(X, Y));
+			UTexture2D* Texture = Handle && (*Handle)->HasLoadCompleted() ? Cast<UTexture2D>((*Handle)->GetLoadedAsset()) : nullptr;
+			if (Texture == nullptr || Texture->Resource == nullptr)
+			{
+				continue;  // still streaming in
+			}
+
+			const FBox2D TileBounds = Data->GetTileBounds(X, Y);
+			ClipCircleToRect(Center, Params.WorldRadius, TileBounds, RadarMinimap::CircleSegments, ClipPolygon, ClipScratch);
+			if (ClipPolygon.Num() < 3)
+			{
+				continue;
+			}
+
+			// tile texture is placed by world XY of clipped polygon, rotation comes from projection only
+			Triangles.Reset();
+			auto MakeVertex = [&](int32 Index, FVector2D& OutPos, FVector2D& OutUV, FLinearColor& OutColor)
+			{
+				OutPos = Params.WorldToScreen(ClipPolygon[Index]);
+				OutUV = (ClipPolygon[Index] - TileBounds.Min) * InvTileWorldSize;
+				OutColor = Color;
+			};
+
+			// convex polygon fan
+			for (int32 i = 1; i < ClipPolygon.Num() - 1; i++)
+			{
+				FCanvasUVTri& Tri = Triangles.AddDefaulted_GetRef();
+				MakeVertex(0, Tri.V0_Pos, Tri.V0_UV, Tri.V0_Color);
+				MakeVertex(i, Tri.V1_Pos, Tri.V1_UV, Tri.V1_Color);
+				MakeVertex(i + 1, Tri.V2_Pos, Tri.V2_UV, Tri.V2_Color);
+			}
+
+			FCanvasTriangleItem TriangleItem(Triangles, Texture->Resource);
+			TriangleItem.BlendMode = FCanvas::BlendToSimpleElementBlend(BLEND_Translucent);
+			Canvas->DrawItem(TriangleItem);
+			NumItems++;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_RadarMinimapTilesDrawn, NumItems);
+	return NumItems;
+}
+
+void FRadarMinimap::ClipCircleToRect(const FVector2D& Center, float Radius, const FBox2D& Rect, int32 NumSegments,
+	TArray<FVector2D>& OutPolygon, TArray<FVector2D>& Scratch)
+{
+	// circle polygon, counter clockwise
+	OutPolygon.Reset();
+	for (int32 i = 0; i < NumSegments; i++)
+	{
+		float Sin, Cos;
+		FMath::SinCos(&Sin, &Cos, 2.0f * PI * i / NumSegments);
+		OutPolygon.Add(Center + FVector2D(Cos, Sin) * Radius);
+	}
+
+	// clip by each rect side, ping-pong between buffers
+	RadarMinimap::ClipPolygon(OutPolygon, 0, Rect.Min.X, true, Scratch);
+	RadarMinimap::ClipPolygon(Scratch, 0, Rect.Max.X, false, OutPolygon);
+	RadarMinimap::ClipPolygon(OutPolygon, 1, Rect.Min.Y, true, Scratch);
+	RadarMinimap::ClipPolygon(Scratch, 1, Rect.Max.Y, false, OutPolygon);
+
+	if (OutPolygon.Num() < 3)
+	{
+		OutPolygon.Reset();
+	}
+}
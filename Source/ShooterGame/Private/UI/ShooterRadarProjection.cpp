@@ -0,0 +1,207 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UI/ShooterRadarProjection.h"
+
+#include "UI/ShooterRadarCollector.h"
+
+namespace
+{
+	FORCEINLINE int32 GetHeightSign(float DeltaZ, float HeightThreshold)
+	{
+		return DeltaZ > HeightThreshold ? 1 : (DeltaZ < -HeightThreshold ? -1 : 0);
+	}
+}
+
+void FShooterRadarProjection::Project(const FRadarProjectionParams& Params, const FRadarPointRegistry& Registry, 
+	TArray<FRadarDrawItem>& OutDrawList, FRadarProjectionScratch& Scratch)
+{
+	if (!Registry.GatherCandidates(Params.WorldCenter, Params.WorldRadius, Scratch.Indices))
+	{
+		Project(Params, Registry.PosX.GetData(), Registry.PosY.GetData(), Registry.PosZ.GetData(), Registry.Flags.GetData(), Registry.NumSlots(), OutDrawList);
+	}
+	else
+	{
+		ProjectCandidates(Params, Registry, OutDrawList, Scratch);
+	}
+
+	if (Params.ViewerFloor != INDEX_NONE)
+	{
+		ApplyFloors(Params, Registry.Floors.GetData(), OutDrawList);
+	}
+}
+
+void FShooterRadarProjection::ApplyFloors(const FRadarProjectionParams& Params, const uint8* Floors, TArray<FRadarDrawItem>& InOutDrawList)
+{
+	int32 NumKept = 0;
+	for (int32 i = 0; i < InOutDrawList.Num(); i++)
+	{
+		FRadarDrawItem Item = InOutDrawList[i];
+		const int32 FloorDelta = (int32)Floors[Item.PointIndex] - Params.ViewerFloor;
+		if (Params.bViewerFloorOnly && FloorDelta != 0)
+		{
+			continue;
+		}
+
+		Item.HeightSign = FMath::Sign(FloorDelta);
+		InOutDrawList[NumKept++] = Item;
+	}
+	InOutDrawList.SetNum(NumKept, false);
+}
+
+void FShooterRadarProjection::ProjectCandidates(const FRadarProjectionParams& Params, const FRadarPointRegistry& Registry,
+	TArray<FRadarDrawItem>& OutDrawList, FRadarProjectionScratch& Scratch)
+{
+	const int32 Num = Scratch.Indices.Num();
+	Scratch.PosX.SetNumUninitialized(Num, false);
+	Scratch.PosY.SetNumUninitialized(Num, false);
+	Scratch.PosZ.SetNumUninitialized(Num, false);
+	Scratch.Flags.SetNumUninitialized(Num, false);
+
+	for (int32 i = 0; i < Num; i++)
+	{
+		const int32 Index = Scratch.Indices[i];
+		Scratch.PosX[i] = Registry.PosX[Index];
+		Scratch.PosY[i] = Registry.PosY[Index];
+		Scratch.PosZ[i] = Registry.PosZ[Index];
+		Scratch.Flags[i] = Registry.Flags[Index];
+	}
+
+	Project(Params, Scratch.PosX.GetData(), Scratch.PosY.GetData(), Scratch.PosZ.GetData(), Scratch.Flags.GetData(), Num, OutDrawList);
+
+	// remap to registry indices
+	for (FRadarDrawItem& Item : OutDrawList)
+	{
+		Item.PointIndex = Scratch.Indices[Item.PointIndex];
+	}
+}
+
+void FShooterRadarProjection::ProjectScalar(const FRadarProjectionParams& Params,
+	const float* PosX, const float* PosY, const float* PosZ, const uint8* Flags, int32 Num,
+	TArray<FRadarDrawItem>& OutDrawList)
+{
+	OutDrawList.Reset();
+	ProjectScalarRange(Params, PosX, PosY, PosZ, Flags, 0, Num, OutDrawList);
+}
+
+void FShooterRadarProjection::ProjectScalarRange(const FRadarProjectionParams& Params,
+	const float* PosX, const float* PosY, const float* PosZ, const uint8* Flags, int32 StartIndex, int32 Num,
+	TArray<FRadarDrawItem>& OutDrawList)
+{
+	const float InvWorldRadius = 1.0f / Params.WorldRadius;
+
+	for (int32 Index = StartIndex; Index < Num; Index++)
+	{
+		const uint8 PointFlags = Flags[Index];
+		if (!(PointFlags & ERadarPointFlags::CanShow))
+		{
+			continue;
+		}
+
+		const float DeltaX = Params.WorldCenter.X - PosX[Index];
+		const float DeltaY = Params.WorldCenter.Y - PosY[Index];
+		const float DistSquared = DeltaX * DeltaX + DeltaY * DeltaY;
+		const float InvDist = DistSquared > SMALL_NUMBER ? FMath::InvSqrt(DistSquared) : 0.0f;
+		const float DistRelToRadius = DistSquared * InvDist * InvWorldRadius;
+
+		if (!(PointFlags & ERadarPointFlags::CanShowIfOutRadarBorder) && DistRelToRadius > 1.0f)
+		{
+			continue;
+		}
+
+		const float Scale = FMath::Min(DistRelToRadius, 1.0f) * Params.ScreenRadius * InvDist;
+
+		// somehow point is 90 deg rotated from start, so we swap X and Y with each other
+		const float BasicPointPosX = DeltaY * Scale;
+		const float BasicPointPosY = -(DeltaX * Scale);
+
+		const float PointRadialOffsetX = BasicPointPosX * Params.CosTheta + BasicPointPosY * Params.SinTheta;
+		const float PointRadialOffsetY = -(BasicPointPosX * Params.SinTheta) + BasicPointPosY * Params.CosTheta;
+
+		FRadarDrawItem& Item = OutDrawList.AddUninitialized_GetRef();
+		Item.X = Params.ScreenCenter.Y + PointRadialOffsetX;
+		Item.Y = Params.ScreenCenter.X + PointRadialOffsetY;
+		Item.PointIndex = Index;
+		Item.HeightSign = GetHeightSign(PosZ[Index] - Params.WorldCenter.Z, Params.HeightThreshold);
+	}
+}
+
+void FShooterRadarProjection::Project(const FRadarProjectionParams& Params,
+	const float* PosX, const float* PosY, const float* PosZ, const uint8* Flags, int32 Num,
+	TArray<FRadarDrawItem>& OutDrawList)
+{
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+	OutDrawList.Reset();
+
+	const VectorRegister CenterX = VectorSetFloat1(Params.WorldCenter.X);
+	const VectorRegister CenterY = VectorSetFloat1(Params.WorldCenter.Y);
+	const VectorRegister CenterZ = VectorSetFloat1(Params.WorldCenter.Z);
+	const VectorRegister InvWorldRadius = VectorSetFloat1(1.0f / Params.WorldRadius);
+	const VectorRegister ScreenRadius = VectorSetFloat1(Params.ScreenRadius);
+	const VectorRegister SinTheta = VectorSetFloat1(Params.SinTheta);
+	const VectorRegister CosTheta = VectorSetFloat1(Params.CosTheta);
+	const VectorRegister ScreenX = VectorSetFloat1(Params.ScreenCenter.Y);  // radar screen axes are swapped, same as in scalar path
+	const VectorRegister ScreenY = VectorSetFloat1(Params.ScreenCenter.X);
+	const VectorRegister HeightThreshold = VectorSetFloat1(Params.HeightThreshold);
+	const VectorRegister NegHeightThreshold = VectorSetFloat1(-Params.HeightThreshold);
+	const VectorRegister MinDistSquared = VectorSetFloat1(SMALL_NUMBER);
+	const VectorRegister One = GlobalVectorConstants::FloatOne;
+
+	MS_ALIGN(16) float OutX[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float OutY[4] GCC_ALIGN(16);
+
+	const int32 NumVectorized = Num & ~3;
+	for (int32 Index = 0; Index < NumVectorized; Index += 4)
+	{
+		// whole block is hidden, nothing to project
+		if (!((Flags[Index] | Flags[Index + 1] | Flags[Index + 2] | Flags[Index + 3]) & ERadarPointFlags::CanShow))
+		{
+			continue;
+		}
+
+		const VectorRegister DeltaX = VectorSubtract(CenterX, VectorLoad(PosX + Index));
+		const VectorRegister DeltaY = VectorSubtract(CenterY, VectorLoad(PosY + Index));
+		const VectorRegister DeltaZ = VectorSubtract(VectorLoad(PosZ + Index), CenterZ);
+
+		const VectorRegister DistSquared = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiply(DeltaY, DeltaY));
+		const VectorRegister InvDist = VectorSelect(VectorCompareGT(DistSquared, MinDistSquared), VectorReciprocalSqrtAccurate(DistSquared), VectorZero());
+		const VectorRegister DistRelToRadius = VectorMultiply(VectorMultiply(DistSquared, InvDist), InvWorldRadius);
+
+		const VectorRegister Scale = VectorMultiply(VectorMultiply(VectorMin(DistRelToRadius, One), ScreenRadius), InvDist);
+		const VectorRegister BasicPointPosX = VectorMultiply(DeltaY, Scale);
+		const VectorRegister BasicPointPosY = VectorNegate(VectorMultiply(DeltaX, Scale));
+
+		const VectorRegister PointRadialOffsetX = VectorMultiplyAdd(BasicPointPosX, CosTheta, VectorMultiply(BasicPointPosY, SinTheta));
+		const VectorRegister PointRadialOffsetY = VectorSubtract(VectorMultiply(BasicPointPosY, CosTheta), VectorMultiply(BasicPointPosX, SinTheta));
+
+		VectorStoreAligned(VectorAdd(ScreenX, PointRadialOffsetX), OutX);
+		VectorStoreAligned(VectorAdd(ScreenY, PointRadialOffsetY), OutY);
+
+		const int32 OutOfBorderMask = VectorMaskBits(VectorCompareGT(DistRelToRadius, One));
+		const int32 HigherMask = VectorMaskBits(VectorCompareGT(DeltaZ, HeightThreshold));
+		const int32 LowerMask = VectorMaskBits(VectorCompareGT(NegHeightThreshold, DeltaZ));
+
+		// compact visible lanes to draw list
+		for (int32 Lane = 0; Lane < 4; Lane++)
+		{
+			const uint8 PointFlags = Flags[Index + Lane];
+			const int32 LaneBit = 1 << Lane;
+
+			if (!(PointFlags & ERadarPointFlags::CanShow)
+				|| (!(PointFlags & ERadarPointFlags::CanShowIfOutRadarBorder) && (OutOfBorderMask & LaneBit)))
+			{
+				continue;
+			}
+
+			FRadarDrawItem& Item = OutDrawList.AddUninitialized_GetRef();
+			Item.X = OutX[Lane];
+			Item.Y = OutY[Lane];
+			Item.PointIndex = Index + Lane;
+			Item.HeightSign = (HigherMask & LaneBit) ? 1 : ((LowerMask & LaneBit) ? -1 : 0);
+		}
+	}
+
+	ProjectScalarRange(Params, PosX, PosY, PosZ, Flags, NumVectorized, Num, OutDrawList);
+#else
+	ProjectScalar(Params, PosX, PosY, PosZ, Flags, Num, OutDrawList);
+#endif
+}
@@ -0,0 +1,238 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UI/ShooterRadarSpotter.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+
+#include "UI/ShooterRadarCategories.h"
+#include "Online/ShooterGameMode.h"
+#include "Online/ShooterPlayerState.h"
+#include "Player/ShooterCharacter.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Spot Traces Issued"), STAT_RadarSpotTraces, STATGROUP_ShooterRadar);
+
+int32 CVar_ShooterRadar_Spotting = 0;
+static FAutoConsoleVariableRef CVarShooterRadarSpotting(TEXT("ShooterRadar.Spotting"), CVar_ShooterRadar_Spotting,
+	TEXT("Reveal enemies on radar when they are visible in player character view cone, not only when they shoot"), ECVF_Default);
+
+int32 CVar_ShooterRadar_SpottingTraceBudget = 16;
+static FAutoConsoleVariableRef CVarShooterRadarSpottingTraceBudget(TEXT("ShooterRadar.Spotting.TraceBudget"), CVar_ShooterRadar_SpottingTraceBudget,
+	TEXT("Max async visibility traces issued by radar spotting per radar update (ShooterRadar.UpdateRate), pairs over budget wait for their turn"), ECVF_Default);
+
+float CVar_ShooterRadar_SpottingDistance = 5000.f;
+static FAutoConsoleVariableRef CVarShooterRadarSpottingDistance(TEXT("ShooterRadar.Spotting.Distance"), CVar_ShooterRadar_SpottingDistance,
+	TEXT("Enemies further then this from player character are not spotted"), ECVF_Default);
+
+float CVar_ShooterRadar_SpottingViewAngle = 45.f;
+static FAutoConsoleVariableRef CVarShooterRadarSpottingViewAngle(TEXT("ShooterRadar.Spotting.ViewAngle"), CVar_ShooterRadar_SpottingViewAngle,
+	TEXT("Half angle of player character view cone enemies are spotted in, degrees"), ECVF_Default);
+
+int32 FRadarSpotSchedule::Schedule(int32 NumSpotters, int32 NumTargets, int32 Budget, TFunctionRef<bool(int32, int32)> TryTrace)
+{
+	const int32 NumPairs = NumSpotters * NumTargets;
+	if (NumPairs <= 0 || Budget <= 0)
+	{
+		return 0;
+	}
+
+	// spotters or targets count changed since last frame, start over
+	if (Cursor >= NumPairs)
+	{
+		Cursor = 0;
+	}
+
+	int32 NumIssued = 0;
+	for (int32 NumVisited = 0; NumVisited < NumPairs && NumIssued < Budget; NumVisited++)
+	{
+		const int32 Pair = Cursor;
+		Cursor = (Cursor + 1) % NumPairs;
+
+		if (TryTrace(Pair / NumTargets, Pair % NumTargets))
+		{
+			NumIssued++;
+		}
+	}
+
+	return NumIssued;
+}
+
+bool FRadarSpotter::IsEnabled()
+{
+	return CVar_ShooterRadar_Spotting != 0;
+}
+
+void FRadarSpotter::IssueTraces(UWorld* World, const FRadarCategoryTable& Categories, const TArray<FRadarPointRegistry>& Registries,
+	const FRadarPositionSnapshot& Snapshot, const FTraceDelegate& TraceDelegate)
+{
+	const int32 Budget = CVar_ShooterRadar_SpottingTraceBudget;
+
+	// results are delivered at next frame start, traces issued before last update never got them (world paused), forget them
+	UpdateIndex++;
+	for (auto It = PendingTraces.CreateIterator(); It; ++It)
+	{
+		if (It.Value().UpdateIndex + 1 < UpdateIndex)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	const float WorldTime = World->GetTimeSeconds();
+	Spots.RemoveAllSwap([WorldTime](const FRadarSpot& Spot) { return Spot.ExpireTime <= WorldTime || !Spot.Target.IsValid() || !Spot.Spotter.IsValid(); });
+
+	Spotters.Reset();
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		const AShooterCharacter* Character = PC ? Cast<AShooterCharacter>(PC->GetPawn()) : nullptr;
+		if (Character && Character->IsAlive())
+		{
+			FSpotterView& View = Spotters.AddDefaulted_GetRef();
+			FRotator EyesRotation;
+			Character->GetActorEyesViewPoint(View.Location, EyesRotation);
+			View.Direction = EyesRotation.Vector();
+			View.Actor = Character;
+			View.Controller = PC;
+		}
+	}
+
+	Targets.Reset();
+	TargetCategories.Reset();
+	TargetLocations.Reset();
+	for (int32 Category = 0; Category < Categories.Num(); Category++)
+	{
+		if (!Categories.GetCategory(Category).ExpiresOnShow())
+		{
+			continue;  // permanently shown points have nothing to reveal
+		}
+
+		const FRadarPointRegistry& Registry = Registries[Category];
+		for (AActor* Actor : Registry.Actors)
+		{
+			if (IsValid(Actor))
+			{
+				const FVector* SnapshotLocation = Snapshot.Find(Actor);
+				Targets.Add(Actor);
+				TargetCategories.Add(Category);
+				TargetLocations.Add(SnapshotLocation ? *SnapshotLocation : Actor->GetActorLocation());
+			}
+		}
+	}
+
+	const float MaxDistanceSq = FMath::Square(CVar_ShooterRadar_SpottingDistance);
+	const float ViewConeCos = FMath::Cos(FMath::DegreesToRadians(CVar_ShooterRadar_SpottingViewAngle));
+
+	const int32 NumIssued = Schedule.Schedule(Spotters.Num(), Targets.Num(), Budget, [&](int32 SpotterIndex, int32 TargetIndex)
+	{
+		const FSpotterView& View = Spotters[SpotterIndex];
+		AActor* Target = Targets[TargetIndex];
+		if (Target == View.Actor)
+		{
+			return false;
+		}
+
+		// allies aren't spotted, they share what they see
+		const AShooterCharacter* TargetCharacter = Cast<AShooterCharacter>(Target);
+		if (TargetCharacter && !TargetCharacter->IsEnemyFor(View.Controller))
+		{
+			return false;
+		}
+
+		// cheap view cone and distance checks first, only pairs passing them take trace budget
+		const FVector ToTarget = TargetLocations[TargetIndex] - View.Location;
+		const float DistanceSq = ToTarget.SizeSquared();
+		if (DistanceSq > MaxDistanceSq || DistanceSq < KINDA_SMALL_NUMBER)
+		{
+			return false;
+		}
+		if ((ToTarget | View.Direction) < ViewConeCos * FMath::Sqrt(DistanceSq))
+		{
+			return false;
+		}
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(RadarSpotTrace), false);
+		QueryParams.AddIgnoredActor(View.Actor);
+		QueryParams.AddIgnoredActor(Target);
+
+		const uint32 TraceId = NextTraceId++;
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Test, View.Location, TargetLocations[TargetIndex], ECC_Visibility,
+			QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, TraceId);
+
+		const int32 Category = TargetCategories[TargetIndex];
+		PendingTraces.Add(TraceId, { Target, View.Controller, Category, Categories.GetCategory(Category).ShowTime, UpdateIndex });
+
+		return true;
+	});
+
+	INC_DWORD_STAT_BY(STAT_RadarSpotTraces, NumIssued);
+}
+
+bool FRadarSpotter::ConsumeTrace(const FTraceDatum& TraceData, float WorldTime)
+{
+	FPendingTrace Trace;
+	if (!PendingTraces.RemoveAndCopyValue(TraceData.UserData, Trace) || !Trace.Target.IsValid() || !Trace.Spotter.IsValid())
+	{
+		return false;
+	}
+
+	// spotter and target are ignored by trace, any blocking hit is an obstacle in between
+	const bool bBlocked = TraceData.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	if (bBlocked)
+	{
+		return false;
+	}
+
+	// spotted again by the same spotter, keep showing it
+	FRadarSpot* Spot = Spots.FindByPredicate([&Trace](const FRadarSpot& Item) { return Item.Target == Trace.Target && Item.Spotter == Trace.Spotter; });
+	if (Spot == nullptr)
+	{
+		Spot = &Spots.AddDefaulted_GetRef();
+		Spot->Target = Trace.Target;
+		Spot->Spotter = Trace.Spotter;
+	}
+
+	Spot->Category = Trace.Category;
+	Spot->ExpireTime = WorldTime + Trace.ShowTime;
+	return true;
+}
+
+void FRadarSpotter::ForEachSpot(const UWorld* World, const AController* Viewer, TFunctionRef<void(const FRadarSpot&)> Visit) const
+{
+	if (Viewer == nullptr || Spots.Num() == 0)
+	{
+		return;
+	}
+
+	const AGameStateBase* GameState = World->GetGameState();
+	const AShooterGameMode* DefGame = GameState ? GameState->GetDefaultGameMode<AShooterGameMode>() : nullptr;
+	AShooterPlayerState* ViewerPlayerState = Cast<AShooterPlayerState>(Viewer->PlayerState);
+
+	for (const FRadarSpot& Spot : Spots)
+	{
+		const AController* Spotter = Spot.Spotter.Get();
+		if (Spotter == nullptr || !Spot.Target.IsValid())
+		{
+			continue;
+		}
+
+		// same allies rule as damage, every other player is enemy in free for all
+		AShooterPlayerState* SpotterPlayerState = Cast<AShooterPlayerState>(Spotter->PlayerState);
+		const bool bIsAlly = Spotter == Viewer
+			|| (DefGame && ViewerPlayerState && SpotterPlayerState && !DefGame->CanDealDamage(SpotterPlayerState, ViewerPlayerState));
+		if (bIsAlly)
+		{
+			Visit(Spot);
+		}
+	}
+}
+
+void FRadarSpotter::Reset()
+{
+	PendingTraces.Reset();
+	Spots.Reset();
+	Spotters.Reset();
+	Targets.Reset();
+	TargetCategories.Reset();
+	TargetLocations.Reset();
+}
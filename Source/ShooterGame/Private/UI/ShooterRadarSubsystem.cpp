@@ -0,0 +1,384 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UI/ShooterRadarSubsystem.h"
+
+#include "Player/ShooterCharacter.h"
+#include "Pickups/ShooterPickup.h"
+#include "Weapons/ShooterWeapon.h"
+#include "Engine/DemoNetDriver.h"
+
+DECLARE_CYCLE_STAT(TEXT("Radar Update"), STAT_RadarUpdate, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Reveals Generated"), STAT_RadarRevealsGenerated, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Spot Reveals"), STAT_RadarSpotReveals, STATGROUP_ShooterRadar);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Radar Updates Skipped By Rate"), STAT_RadarUpdatesSkipped, STATGROUP_ShooterRadar);
+DECLARE_CYCLE_STAT(TEXT("Radar Timeline Seek"), STAT_RadarTimelineSeek, STATGROUP_ShooterRadar);
+DECLARE_MEMORY_STAT(TEXT("Radar Timeline Memory"), STAT_RadarTimelineMemory, STATGROUP_ShooterRadar);
+
+float CVar_ShooterRadar_UpdateRate = 20.f;
+static FAutoConsoleVariableRef CVarShooterRadarUpdateRate(TEXT("ShooterRadar.UpdateRate"), CVar_ShooterRadar_UpdateRate,
+	TEXT("Radar model updates per second, displayed positions are interpolated between updates. 0 updates radar every frame"), ECVF_Default);
+
+float CVar_ShooterRadar_TimelineKeyframeInterval = 10.f;
+static FAutoConsoleVariableRef CVarShooterRadarTimelineKeyframeInterval(TEXT("ShooterRadar.Timeline.KeyframeInterval"), CVar_ShooterRadar_TimelineKeyframeInterval,
+	TEXT("Seconds between full radar state keyframes of demo playback radar timeline, replay seek applies at most this much of radar events"), ECVF_Default);
+
+bool UShooterRadarSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// dedicated server has no HUD, but still needs the model to build radar feeds for remote players
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && (World->WorldType == EWorldType::Game || World->WorldType == EWorldType::PIE);
+}
+
+void UShooterRadarSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Categories.Init(GetDefault<UShooterRadarSettings>()->Categories);
+	Registries.SetNum(Categories.Num());
+	for (FRadarPointRegistry& Registry : Registries)
+	{
+		Registry.SetFloorBands(&FloorBands);
+	}
+
+	SpotTraceDelegate.BindUObject(this, &UShooterRadarSubsystem::SpotTraceDone);
+
+	// Subs delegates
+	DelegateHandle_CharacterSpawn =               AShooterCharacter::NotifyShooterCharacterSpawn.AddUObject(this, &UShooterRadarSubsystem::CharacterSpawnedEvent);
+	DelegateHandle_CharacterKill =                AShooterCharacter::NotifyShooterCharacterKill.AddUObject(this, &UShooterRadarSubsystem::CharacterKilledEvent);
+	DelegateHandle_PickupPick =                   AShooterPickup::NotifyPickupPick.AddUObject(this, &UShooterRadarSubsystem::PickupPickEvent);
+	DelegateHandle_PickupRespawn =                AShooterPickup::NotifyPickupRespawn.AddUObject(this, &UShooterRadarSubsystem::PickupRespawnEvent);
+	DelegateHandle_CharacterWeaponShot =          AShooterWeapon::NotifyShooterCharacterWeaponShot.AddUObject(this, &UShooterRadarSubsystem::CharacterWeaponShotEvent);
+}
+
+void UShooterRadarSubsystem::Deinitialize()
+{
+	// Unsubs delegates
+	if (DelegateHandle_CharacterSpawn.IsValid())      AShooterCharacter::NotifyShooterCharacterSpawn.Remove(DelegateHandle_CharacterSpawn);
+	if (DelegateHandle_CharacterKill.IsValid())       AShooterCharacter::NotifyShooterCharacterKill.Remove(DelegateHandle_CharacterKill);
+	if (DelegateHandle_PickupPick.IsValid())          AShooterPickup::NotifyPickupPick.Remove(DelegateHandle_PickupPick);
+	if (DelegateHandle_PickupRespawn.IsValid())       AShooterPickup::NotifyPickupRespawn.Remove(DelegateHandle_PickupRespawn);
+	if (DelegateHandle_CharacterWeaponShot.IsValid()) AShooterWeapon::NotifyShooterCharacterWeaponShot.Remove(DelegateHandle_CharacterWeaponShot);
+	if (BoundDemoDriver.IsValid())                    BoundDemoDriver->OnGotoTimeDelegate.Remove(DelegateHandle_DemoGotoTime);
+
+	Registries.Reset();
+	FloorBands.Reset();
+	Spotter.Reset();
+	Timeline.Reset();
+	SET_MEMORY_STAT(STAT_RadarTimelineMemory, 0);
+
+	Super::Deinitialize();
+}
+
+FRadarPointRegistry* UShooterRadarSubsystem::FindRegistry(const AActor* Actor)
+{
+	const int32 Category = Categories.FindCategory(Actor->GetClass());
+	return Category != INDEX_NONE ? &Registries[Category] : nullptr;
+}
+
+void UShooterRadarSubsystem::AddPoint(AActor* Actor, bool bShow)
+{
+	const int32 Category = Categories.FindCategory(Actor->GetClass());
+	if (Category == INDEX_NONE)
+	{
+		return;
+	}
+
+	FRadarPointRegistry& Registry = Registries[Category];
+
+	const FRadarPoint PointTemplate = Categories.GetCategory(Category).MakePointTemplate();
+
+	bool bAdded;
+	const int32 Index = Registry.FindOrAdd(Actor, PointTemplate, bAdded);
+	if (bAdded)
+	{
+		RecordTimelineEvent(Actor, Category, ERadarTimelineEvent::Add, PointTemplate.Flags);
+	}
+
+	if (bShow)
+	{
+		Registry.Show(Index, true);
+		RecordTimelineEvent(Actor, Category, ERadarTimelineEvent::Show);
+	}
+}
+
+void UShooterRadarSubsystem::RemovePoint(const AActor* Actor)
+{
+	const int32 Category = Categories.FindCategory(Actor->GetClass());
+	if (Category != INDEX_NONE)
+	{
+		Registries[Category].Remove(Actor);
+		RecordTimelineEvent(Actor, Category, ERadarTimelineEvent::Remove);
+	}
+}
+
+bool UShooterRadarSubsystem::ShowPoint(const AActor* Actor, bool bShowOnRadar)
+{
+	const int32 Category = Categories.FindCategory(Actor->GetClass());
+	const int32 Index = Category != INDEX_NONE ? Registries[Category].Find(Actor) : INDEX_NONE;
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Registries[Category].Show(Index, bShowOnRadar);
+	RecordTimelineEvent(Actor, Category, bShowOnRadar ? ERadarTimelineEvent::Show : ERadarTimelineEvent::Hide);
+	return true;
+}
+
+// radar events are static and broadcast for actors of every world (PIE clients, listen server, demo world), each model takes its own
+
+void UShooterRadarSubsystem::CharacterSpawnedEvent(AShooterCharacter* Character)
+{
+	if (Character == nullptr || Character->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	AddPoint(Character, false);
+}
+
+void UShooterRadarSubsystem::CharacterKilledEvent(AShooterCharacter* Character)
+{
+	if (Character == nullptr || Character->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	RemovePoint(Character);
+}
+
+void UShooterRadarSubsystem::PickupPickEvent(AShooterPickup* Pickup)
+{
+	if (Pickup == nullptr || Pickup->GetWorld() != GetWorld())
+	{
+		return;
+	}
+ 
+	ShowPoint(Pickup, false);
+}
+
+void UShooterRadarSubsystem::PickupRespawnEvent(AShooterPickup* Pickup)
+{
+	if (Pickup == nullptr || Pickup->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	AddPoint(Pickup, true);
+}
+
+void UShooterRadarSubsystem::CharacterWeaponShotEvent(AShooterCharacter* Character, AShooterWeapon* Weapon)
+{
+	if (Character == nullptr || Character->GetWorld() != GetWorld())
+	{
+		return;
+	}
+	
+	if (ShowPoint(Character, true))
+	{
+		INC_DWORD_STAT(STAT_RadarRevealsGenerated);
+		RevealsGenerated++;
+	}
+}
+
+void UShooterRadarSubsystem::UpdateRadar()
+{
+	if (LastUpdateFrame == GFrameCounter)
+	{
+		return;  // already updated by other viewer this frame
+	}
+	LastUpdateFrame = GFrameCounter;
+
+	SCOPE_CYCLE_COUNTER(STAT_RadarUpdate);
+
+	// model runs at fixed rate regardless of draw rate, frames between updates only blend displayed positions
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	const float UpdateInterval = CVar_ShooterRadar_UpdateRate > 0.0f ? 1.0f / CVar_ShooterRadar_UpdateRate : 0.0f;
+	if (LastUpdateTime >= 0.0f && WorldTime - LastUpdateTime < UpdateInterval)
+	{
+		INC_DWORD_STAT(STAT_RadarUpdatesSkipped);
+		InterpolatePositions((WorldTime - LastUpdateTime) / UpdateInterval);
+		return;
+	}
+
+	// radar feed may update model less often then every frame, so timers use world time instead of frame delta
+	const float DeltaTime = LastUpdateTime < 0.0f ? 0.0f : WorldTime - LastUpdateTime;
+	if (LastUpdateTime < 0.0f)
+	{
+		// tagged floor actors of streamed levels are loaded by now, radar points registered before are bucketed again
+		FloorBands.Build(GetWorld(), GetDefault<UShooterRadarSettings>()->MapFloors);
+		for (FRadarPointRegistry& Registry : Registries)
+		{
+			Registry.SetFloorBands(&FloorBands);
+		}
+	}
+	LastUpdateTime = WorldTime;
+
+	PositionSnapshot.Gather(GetWorld());
+
+	for (FRadarPointRegistry& Registry : Registries)
+	{
+		Registry.Update(DeltaTime, PositionSnapshot);
+	}
+
+	// displayed positions start from previous sample, so they reach the new one by next update
+	InterpolatePositions(UpdateInterval > 0.0f ? 0.0f : 1.0f);
+
+	// bind replay scrubbing when demo playback starts
+	UDemoNetDriver* DemoDriver = GetWorld()->GetDemoNetDriver();
+	if (DemoDriver && DemoDriver != BoundDemoDriver.Get())
+	{
+		if (BoundDemoDriver.IsValid())
+		{
+			BoundDemoDriver->OnGotoTimeDelegate.Remove(DelegateHandle_DemoGotoTime);
+		}
+		DelegateHandle_DemoGotoTime = DemoDriver->OnGotoTimeDelegate.AddUObject(this, &UShooterRadarSubsystem::DemoGotoTimeDone);
+		BoundDemoDriver = DemoDriver;
+	}
+
+	if (IsRecordingTimeline())
+	{
+		const float DemoTime = DemoDriver->GetDemoCurrentTime();
+		if (Timeline.NeedsKeyframe(DemoTime, CVar_ShooterRadar_TimelineKeyframeInterval))
+		{
+			RecordTimelineKeyframe(DemoTime);
+		}
+	}
+
+	// reveals are authoritative, remote clients get spotted enemies by radar feed
+	if (FRadarSpotter::IsEnabled() && GetWorld()->GetNetMode() != NM_Client)
+	{
+		Spotter.IssueTraces(GetWorld(), Categories, Registries, PositionSnapshot, SpotTraceDelegate);
+	}
+}
+
+void UShooterRadarSubsystem::InterpolatePositions(float Alpha)
+{
+	for (FRadarPointRegistry& Registry : Registries)
+	{
+		Registry.Interpolate(Alpha);
+	}
+}
+
+void UShooterRadarSubsystem::SpotTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceData)
+{
+	if (Spotter.ConsumeTrace(TraceData, GetWorld()->GetTimeSeconds()))
+	{
+		INC_DWORD_STAT(STAT_RadarSpotReveals);
+	}
+}
+
+void UShooterRadarSubsystem::ForEachSpottedPoint(const AController* Viewer, TFunctionRef<void(int32, int32, float)> Visit) const
+{
+	// target spotted by several allies is visited once, few spots per viewer so linear search is fine
+	TArray<const AActor*, TInlineAllocator<16>> VisitedTargets;
+	Spotter.ForEachSpot(GetWorld(), Viewer, [&](const FRadarSpot& Spot)
+	{
+		const AActor* Target = Spot.Target.Get();
+		const FRadarPointRegistry& Registry = Registries[Spot.Category];
+		const int32 Index = Registry.Find(Target);
+		if (Index == INDEX_NONE || Registry.CanShow(Index) || VisitedTargets.Contains(Target))
+		{
+			return;  // removed, or already shown to everyone
+		}
+
+		VisitedTargets.Add(Target);
+		Visit(Spot.Category, Index, Spot.ExpireTime);
+	});
+}
+
+bool UShooterRadarSubsystem::IsRecordingTimeline() const
+{
+	// events replayed by scrubbing fast forward are already recorded
+	const UDemoNetDriver* DemoDriver = GetWorld()->GetDemoNetDriver();
+	return DemoDriver && DemoDriver->IsPlaying() && !DemoDriver->IsFastForwarding();
+}
+
+void UShooterRadarSubsystem::RecordTimelineEvent(const AActor* Actor, int32 Category, ERadarTimelineEvent::Type Type, uint8 Flags)
+{
+	if (IsRecordingTimeline())
+	{
+		const float DemoTime = GetWorld()->GetDemoNetDriver()->GetDemoCurrentTime();
+		Timeline.AddEvent(DemoTime, Timeline.FindOrAddKey(Actor->GetFName()), (uint8)Category, Type, Flags);
+	}
+}
+
+void UShooterRadarSubsystem::RecordTimelineKeyframe(float Time)
+{
+	TimelinePoints.Reset();
+
+	for (int32 Category = 0; Category < Registries.Num(); Category++)
+	{
+		const FRadarPointRegistry& Registry = Registries[Category];
+		for (int32 i = 0; i < Registry.NumSlots(); i++)
+		{
+			if (!IsValid(Registry.Actors[i]))
+			{
+				continue;  // removed on next registry update
+			}
+
+			FRadarTimelinePoint& Point = TimelinePoints.AddDefaulted_GetRef();
+			Point.Key = Timeline.FindOrAddKey(Registry.Actors[i]->GetFName());
+			Point.Category = (uint8)Category;
+			Point.Flags = Registry.Flags[i];
+			Point.ShowTime = Registry.ShowTimes[i];
+		}
+	}
+
+	Timeline.AddKeyframe(Time, TimelinePoints);
+	SET_MEMORY_STAT(STAT_RadarTimelineMemory, Timeline.GetAllocatedSize());
+}
+
+void UShooterRadarSubsystem::DemoGotoTimeDone(bool bWasSuccessful)
+{
+	UDemoNetDriver* DemoDriver = BoundDemoDriver.Get();
+	if (!bWasSuccessful || DemoDriver == nullptr)
+	{
+		return;
+	}
+
+	// not recorded yet (seek forward past played time), radar is filled by live events as before
+	const float DemoTime = DemoDriver->GetDemoCurrentTime();
+	if (DemoTime > Timeline.GetEndTime())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_RadarTimelineSeek);
+
+	Timeline.Seek(DemoTime, TimelinePoints);
+	Timeline.TruncateAfter(DemoTime);  // played again from here, so recorded again
+
+	for (FRadarPointRegistry& Registry : Registries)
+	{
+		Registry.Reset();
+	}
+
+	ULevel* Level = GetWorld()->PersistentLevel;
+	for (const FRadarTimelinePoint& Point : TimelinePoints)
+	{
+		// level actors keep names, dynamic actors recreated by scrubbing are registered again by live events
+		AActor* Actor = FindObjectFast<AActor>(Level, Timeline.GetKeyName(Point.Key));
+		if (!IsValid(Actor) || !Registries.IsValidIndex(Point.Category))
+		{
+			continue;
+		}
+
+		FRadarPointRegistry& Registry = Registries[Point.Category];
+
+		bool bAdded;
+		const int32 Index = Registry.FindOrAdd(Actor, Categories.GetCategory(Point.Category).MakePointTemplate(), bAdded);
+		Registry.Restore(Index, Point.Flags, Point.ShowTime);
+	}
+}
+
+void UShooterRadarSubsystem::SetStaticPointsGridCellSize(float CellSize)
+{
+	for (int32 Category = 0; Category < Categories.Num(); Category++)
+	{
+		if (Categories.GetCategory(Category).bStaticPosition)
+		{
+			Registries[Category].SetGridCellSize(CellSize);
+		}
+	}
+}
@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UI/ShooterRadarTimeline.h"
+
+#include "Algo/BinarySearch.h"
+#include "UI/ShooterRadarCollector.h"
+
+int32 FRadarTimeline::FindOrAddKey(FName Name)
+{
+	if (const int32* Key = NameToKey.Find(Name))
+	{
+		return *Key;
+	}
+
+	const int32 Key = KeyNames.Add(Name);
+	NameToKey.Add(Name, Key);
+	return Key;
+}
+
+void FRadarTimeline::AddEvent(float Time, int32 Key, uint8 Category, ERadarTimelineEvent::Type Type, uint8 Flags)
+{
+	FRadarTimelineEvent& Event = Events.AddDefaulted_GetRef();
+	Event.Time = Events.Num() > 1 ? FMath::Max(Time, Events[Events.Num() - 2].Time) : Time;  // keep events sorted for seek
+	Event.Key = Key;
+	Event.Category = Category;
+	Event.Type = Type;
+	Event.Flags = Flags;
+}
+
+bool FRadarTimeline::NeedsKeyframe(float Time, float KeyframeInterval) const
+{
+	return Keyframes.Num() == 0 || Time - Keyframes.Last().Time >= KeyframeInterval;
+}
+
+void FRadarTimeline::AddKeyframe(float Time, const TArray<FRadarTimelinePoint>& Points)
+{
+	const float LastTime = GetEndTime();
+
+	FKeyframe& Keyframe = Keyframes.AddDefaulted_GetRef();
+	Keyframe.Time = FMath::Max(Time, LastTime);  // keep keyframes sorted for seek
+	Keyframe.FirstEvent = Events.Num();
+	Keyframe.FirstPoint = KeyframePoints.Num();
+	Keyframe.NumPoints = Points.Num();
+
+	KeyframePoints.Append(Points);
+}
+
+void FRadarTimeline::ApplyEvent(const FRadarTimelineEvent& Event, float Time, TArray<FRadarTimelinePoint>& Points, TArray<int32>& PointIndices)
+{
+	int32& PointIndex = PointIndices[Event.Key];
+
+	switch (Event.Type)
+	{
+	case ERadarTimelineEvent::Add:
+		if (PointIndex == INDEX_NONE)
+		{
+			PointIndex = Points.Num();
+
+			FRadarTimelinePoint& Point = Points.AddDefaulted_GetRef();
+			Point.Key = Event.Key;
+			Point.Category = Event.Category;
+			Point.Flags = Event.Flags;
+			Point.ShowTime = Time - Event.Time;
+		}
+		break;
+
+	case ERadarTimelineEvent::Remove:
+		if (PointIndex != INDEX_NONE)
+		{
+			// swap remove, patch moved point index
+			const int32 RemovedIndex = PointIndex;
+			Points.RemoveAtSwap(RemovedIndex, 1, false);
+			if (Points.IsValidIndex(RemovedIndex))
+			{
+				PointIndices[Points[RemovedIndex].Key] = RemovedIndex;
+			}
+			PointIndex = INDEX_NONE;
+		}
+		break;
+
+	case ERadarTimelineEvent::Show:
+	case ERadarTimelineEvent::Hide:
+		if (PointIndex != INDEX_NONE)
+		{
+			FRadarTimelinePoint& Point = Points[PointIndex];
+			Point.ShowTime = Time - Event.Time;
+
+			if (Event.Type == ERadarTimelineEvent::Show)
+			{
+				Point.Flags |= ERadarPointFlags::CanShow;
+				Point.Flags &= ~ERadarPointFlags::PosUpdateIsBlocked;
+			}
+			else
+			{
+				Point.Flags &= ~ERadarPointFlags::CanShow;
+			}
+		}
+		break;
+	}
+}
+
+void FRadarTimeline::Seek(float Time, TArray<FRadarTimelinePoint>& OutPoints) const
+{
+	OutPoints.Reset();
+
+	SeekPointIndices.SetNumUninitialized(KeyNames.Num(), false);
+	for (int32& PointIndex : SeekPointIndices)
+	{
+		PointIndex = INDEX_NONE;
+	}
+
+	// last keyframe at or before Time
+	const int32 KeyframeIndex = Algo::UpperBoundBy(Keyframes, Time, &FKeyframe::Time) - 1;
+
+	int32 FirstEvent = 0;
+	if (KeyframeIndex != INDEX_NONE)
+	{
+		const FKeyframe& Keyframe = Keyframes[KeyframeIndex];
+		FirstEvent = Keyframe.FirstEvent;
+
+		OutPoints.Append(KeyframePoints.GetData() + Keyframe.FirstPoint, Keyframe.NumPoints);
+		for (int32 i = 0; i < OutPoints.Num(); i++)
+		{
+			OutPoints[i].ShowTime += Time - Keyframe.Time;
+			SeekPointIndices[OutPoints[i].Key] = i;
+		}
+	}
+
+	for (int32 EventIndex = FirstEvent; EventIndex < Events.Num() && Events[EventIndex].Time <= Time; EventIndex++)
+	{
+		ApplyEvent(Events[EventIndex], Time, OutPoints, SeekPointIndices);
+	}
+}
+
+void FRadarTimeline::TruncateAfter(float Time)
+{
+	const int32 NumKeyframes = Algo::UpperBoundBy(Keyframes, Time, &FKeyframe::Time);
+	if (NumKeyframes < Keyframes.Num())
+	{
+		KeyframePoints.SetNum(Keyframes[NumKeyframes].FirstPoint, false);
+		Keyframes.SetNum(NumKeyframes, false);
+	}
+
+	Events.SetNum(Algo::UpperBoundBy(Events, Time, &FRadarTimelineEvent::Time), false);
+}
+
+void FRadarTimeline::Reset()
+{
+	Events.Reset();
+	Keyframes.Reset();
+	KeyframePoints.Reset();
+	KeyNames.Reset();
+	NameToKey.Reset();
+}
+
+float FRadarTimeline::GetEndTime() const
+{
+	const float EventsEndTime = Events.Num() > 0 ? Events.Last().Time : -1.0f;
+	const float KeyframesEndTime = Keyframes.Num() > 0 ? Keyframes.Last().Time : -1.0f;
+	return FMath::Max(EventsEndTime, KeyframesEndTime);
+}
+
+SIZE_T FRadarTimeline::GetAllocatedSize() const
+{
+	return Events.GetAllocatedSize() + Keyframes.GetAllocatedSize() + KeyframePoints.GetAllocatedSize()
+		+ KeyNames.GetAllocatedSize() + NameToKey.GetAllocatedSize();
+}
@@ -0,0 +1,230 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Weapons/ShooterBallistics.h"
+
+namespace ShooterBallistics
+{
+	/** Cos and sin of 45 degree launch that reaches max distance */
+	const float Cos45 = 0.707107f;
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+	/** Square root of each lane, 0 for lanes not above 0 */
+	FORCEINLINE VectorRegister VectorSqrtSafe(const VectorRegister& X)
+	{
+		return VectorSelect(VectorCompareGT(X, VectorZero()), VectorMultiply(X, VectorReciprocalSqrtAccurate(X)), VectorZero());
+	}
+
+	/** Per lane: max distance value if target is out of range, else straight line value, else solved value */
+	FORCEINLINE VectorRegister SelectSolution(const VectorRegister& OutOfRange, const VectorRegister& Straight,
+		const VectorRegister& Solved, const VectorRegister& StraightValue, const VectorRegister& MaxDistValue)
+	{
+		return VectorSelect(OutOfRange, MaxDistValue, VectorSelect(Straight, StraightValue, Solved));
+	}
+#endif
+}
+
+void FShooterBallisticBatch::Reset()
+{
+	DeltaX.Reset();
+	DeltaY.Reset();
+	DeltaZ.Reset();
+	Speed.Reset();
+	GravityZ.Reset();
+}
+
+int32 FShooterBallisticBatch::Add(const FVector& Start, const FVector& Target, float InSpeed, float InGravityZ)
+{
+	DeltaX.Add(Target.X - Start.X);
+	DeltaY.Add(Target.Y - Start.Y);
+	DeltaZ.Add(Target.Z - Start.Z);
+	Speed.Add(InSpeed);
+	return GravityZ.Add(InGravityZ);
+}
+
+void FShooterBallisticBatch::Solve()
+{
+	FShooterBallistics::SolveBatch(*this);
+}
+
+void FShooterBallisticBatch::GetSolution(int32 Index, FShooterBallisticSolution& OutSolution) const
+{
+	OutSolution.LowVelocity = FVector(LowX[Index], LowY[Index], LowZ[Index]);
+	OutSolution.HighVelocity = FVector(HighX[Index], HighY[Index], HighZ[Index]);
+	OutSolution.LowTime = LowTime[Index];
+	OutSolution.HighTime = HighTime[Index];
+	OutSolution.bInRange = InRange[Index] != 0;
+}
+
+void FShooterBallistics::Solve(const FVector& Start, const FVector& Target, float Speed, float GravityZ, FShooterBallisticSolution& OutSolution)
+{
+	const FVector Delta = Target - Start;
+	const float DistSquared = Delta.SizeSquared();
+	OutSolution.bInRange = true;
+
+	if (GravityZ != 0.0f)
+	{
+		const float GravitySquared = GravityZ * GravityZ;
+		const float B = -GravityZ * Delta.Z - Speed * Speed;
+		const float Discriminant = B * B - GravitySquared * DistSquared;
+
+		if (Discriminant < 0.0f)
+		{
+			// can't reach target, 45 degree launch towards it reaches max distance
+			const FVector Direction = FVector(Delta.X, Delta.Y, 0.0f).GetSafeNormal();
+			OutSolution.LowVelocity = FVector(Direction.X * Speed * ShooterBallistics::Cos45, Direction.Y * Speed * ShooterBallistics::Cos45, Speed * ShooterBallistics::Cos45);
+			OutSolution.HighVelocity = OutSolution.LowVelocity;
+			OutSolution.LowTime = OutSolution.HighTime = 0.0f;
+			OutSolution.bInRange = false;
+			return;
+		}
+
+		const float DiscriminantSqrt = FMath::Sqrt(Discriminant);
+		const float InvHalfGravitySquared = 2.0f / GravitySquared;
+		const float LowTime = FMath::Sqrt(FMath::Max((-B - DiscriminantSqrt) * InvHalfGravitySquared, 0.0f));
+
+		// zero time means target is at start, shoot straight
+		if (LowTime != 0.0f)
+		{
+			const float HighTime = FMath::Sqrt(FMath::Max((-B + DiscriminantSqrt) * InvHalfGravitySquared, 0.0f));
+
+			OutSolution.LowVelocity = FVector(Delta.X / LowTime, Delta.Y / LowTime, Delta.Z / LowTime - GravityZ * LowTime * 0.5f);
+			OutSolution.HighVelocity = FVector(Delta.X / HighTime, Delta.Y / HighTime, Delta.Z / HighTime - GravityZ * HighTime * 0.5f);
+			OutSolution.LowTime = LowTime;
+			OutSolution.HighTime = HighTime;
+			return;
+		}
+	}
+
+	const float InvDist = DistSquared > SMALL_NUMBER ? FMath::InvSqrt(DistSquared) : 0.0f;
+	OutSolution.LowVelocity = Delta * (InvDist * Speed);
+	OutSolution.HighVelocity = OutSolution.LowVelocity;
+	OutSolution.LowTime = OutSolution.HighTime = Speed > 0.0f ? DistSquared * InvDist / Speed : 0.0f;
+}
+
+void FShooterBallistics::SolveBatchScalar(FShooterBallisticBatch& Batch)
+{
+	const int32 Num = Batch.Num();
+	SetNumSolutions(Batch, Num);
+
+	FShooterBallisticSolution Solution;
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		const FVector Delta(Batch.DeltaX[Index], Batch.DeltaY[Index], Batch.DeltaZ[Index]);
+		Solve(FVector::ZeroVector, Delta, Batch.Speed[Index], Batch.GravityZ[Index], Solution);
+
+		Batch.LowX[Index] = Solution.LowVelocity.X;
+		Batch.LowY[Index] = Solution.LowVelocity.Y;
+		Batch.LowZ[Index] = Solution.LowVelocity.Z;
+		Batch.LowTime[Index] = Solution.LowTime;
+		Batch.HighX[Index] = Solution.HighVelocity.X;
+		Batch.HighY[Index] = Solution.HighVelocity.Y;
+		Batch.HighZ[Index] = Solution.HighVelocity.Z;
+		Batch.HighTime[Index] = Solution.HighTime;
+		Batch.InRange[Index] = Solution.bInRange;
+	}
+}
+
+void FShooterBallistics::SetNumProblems(FShooterBallisticBatch& Batch, int32 Num)
+{
+	Batch.DeltaX.SetNumZeroed(Num, false);
+	Batch.DeltaY.SetNumZeroed(Num, false);
+	Batch.DeltaZ.SetNumZeroed(Num, false);
+	Batch.Speed.SetNumZeroed(Num, false);
+	Batch.GravityZ.SetNumZeroed(Num, false);
+}
+
+void FShooterBallistics::SetNumSolutions(FShooterBallisticBatch& Batch, int32 Num)
+{
+	Batch.LowX.SetNumUninitialized(Num, false);
+	Batch.LowY.SetNumUninitialized(Num, false);
+	Batch.LowZ.SetNumUninitialized(Num, false);
+	Batch.LowTime.SetNumUninitialized(Num, false);
+	Batch.HighX.SetNumUninitialized(Num, false);
+	Batch.HighY.SetNumUninitialized(Num, false);
+	Batch.HighZ.SetNumUninitialized(Num, false);
+	Batch.HighTime.SetNumUninitialized(Num, false);
+	Batch.InRange.SetNumUninitialized(Num, false);
+}
+
+void FShooterBallistics::SolveBatch(FShooterBallisticBatch& Batch)
+{
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+	// tail is padded with zero problems and solved by vector path too, instead of scalar path with
+	// its own rounding, so problem gets the same solution wherever it lies in batch
+	const int32 Num = Batch.Num();
+	const int32 NumVectorized = Align(Num, 4);
+	SetNumProblems(Batch, NumVectorized);
+	SetNumSolutions(Batch, NumVectorized);
+
+	const VectorRegister Zero = VectorZero();
+	const VectorRegister Half = VectorSetFloat1(0.5f);
+	const VectorRegister Two = VectorSetFloat1(2.0f);
+	const VectorRegister Cos45 = VectorSetFloat1(ShooterBallistics::Cos45);
+	const VectorRegister MinDistSquared = VectorSetFloat1(SMALL_NUMBER);
+
+	for (int32 Index = 0; Index < NumVectorized; Index += 4)
+	{
+		const VectorRegister DeltaX = VectorLoad(Batch.DeltaX.GetData() + Index);
+		const VectorRegister DeltaY = VectorLoad(Batch.DeltaY.GetData() + Index);
+		const VectorRegister DeltaZ = VectorLoad(Batch.DeltaZ.GetData() + Index);
+		const VectorRegister Speed = VectorLoad(Batch.Speed.GetData() + Index);
+		const VectorRegister GravityZ = VectorLoad(Batch.GravityZ.GetData() + Index);
+
+		const VectorRegister DistSquared2D = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiply(DeltaY, DeltaY));
+		const VectorRegister DistSquared = VectorMultiplyAdd(DeltaZ, DeltaZ, DistSquared2D);
+
+		// straight line, without gravity or with target at start
+		const VectorRegister InvDist = VectorSelect(VectorCompareGT(DistSquared, MinDistSquared), VectorReciprocalSqrtAccurate(DistSquared), Zero);
+		const VectorRegister StraightScale = VectorMultiply(InvDist, Speed);
+		const VectorRegister StraightTime = VectorSelect(VectorCompareGT(Speed, Zero), VectorDivide(VectorMultiply(DistSquared, InvDist), Speed), Zero);
+
+		// 45 degree launch towards unreachable target
+		const VectorRegister InvDist2D = VectorSelect(VectorCompareGT(DistSquared2D, MinDistSquared), VectorReciprocalSqrtAccurate(DistSquared2D), Zero);
+		const VectorRegister MaxDistSpeed = VectorMultiply(Speed, Cos45);
+		const VectorRegister MaxDistScale = VectorMultiply(InvDist2D, MaxDistSpeed);
+
+		// both flight times, lanes without gravity divide by zero and are replaced by straight line
+		const VectorRegister GravitySquared = VectorMultiply(GravityZ, GravityZ);
+		const VectorRegister B = VectorNegate(VectorMultiplyAdd(GravityZ, DeltaZ, VectorMultiply(Speed, Speed)));
+		const VectorRegister Discriminant = VectorSubtract(VectorMultiply(B, B), VectorMultiply(GravitySquared, DistSquared));
+		const VectorRegister DiscriminantSqrt = ShooterBallistics::VectorSqrtSafe(Discriminant);
+		const VectorRegister InvHalfGravitySquared = VectorDivide(Two, GravitySquared);
+
+		const VectorRegister LowTime = ShooterBallistics::VectorSqrtSafe(VectorMultiply(VectorNegate(VectorAdd(B, DiscriminantSqrt)), InvHalfGravitySquared));
+		const VectorRegister HighTime = ShooterBallistics::VectorSqrtSafe(VectorMultiply(VectorSubtract(DiscriminantSqrt, B), InvHalfGravitySquared));
+		const VectorRegister InvLowTime = VectorDivide(GlobalVectorConstants::FloatOne, LowTime);
+		const VectorRegister InvHighTime = VectorDivide(GlobalVectorConstants::FloatOne, HighTime);
+		const VectorRegister HalfGravityZ = VectorMultiply(GravityZ, Half);
+
+		const VectorRegister OutOfRange = VectorCompareGT(Zero, Discriminant);
+		const VectorRegister Straight = VectorBitwiseOr(VectorCompareEQ(GravityZ, Zero), VectorCompareEQ(LowTime, Zero));
+
+		const VectorRegister StraightX = VectorMultiply(DeltaX, StraightScale);
+		const VectorRegister StraightY = VectorMultiply(DeltaY, StraightScale);
+		const VectorRegister StraightZ = VectorMultiply(DeltaZ, StraightScale);
+		const VectorRegister MaxDistX = VectorMultiply(DeltaX, MaxDistScale);
+		const VectorRegister MaxDistY = VectorMultiply(DeltaY, MaxDistScale);
+
+		VectorStore(ShooterBallistics::SelectSolution(OutOfRange, Straight, VectorMultiply(DeltaX, InvLowTime), StraightX, MaxDistX), Batch.LowX.GetData() + Index);
+		VectorStore(ShooterBallistics::SelectSolution(OutOfRange, Straight, VectorMultiply(DeltaY, InvLowTime), StraightY, MaxDistY), Batch.LowY.GetData() + Index);
+		VectorStore(ShooterBallistics::SelectSolution(OutOfRange, Straight, VectorSubtract(VectorMultiply(DeltaZ, InvLowTime), VectorMultiply(HalfGravityZ, LowTime)), StraightZ, MaxDistSpeed), Batch.LowZ.GetData() + Index);
+		VectorStore(ShooterBallistics::SelectSolution(OutOfRange, Straight, LowTime, StraightTime, Zero), Batch.LowTime.GetData() + Index);
+
+		VectorStore(ShooterBallistics::SelectSolution(OutOfRange, Straight, VectorMultiply(DeltaX, InvHighTime), StraightX, MaxDistX), Batch.HighX.GetData() + Index);
+		VectorStore(ShooterBallistics::SelectSolution(OutOfRange, Straight, VectorMultiply(DeltaY, InvHighTime), StraightY, MaxDistY), Batch.HighY.GetData() + Index);
+		VectorStore(ShooterBallistics::SelectSolution(OutOfRange, Straight, VectorSubtract(VectorMultiply(DeltaZ, InvHighTime), VectorMultiply(HalfGravityZ, HighTime)), StraightZ, MaxDistSpeed), Batch.HighZ.GetData() + Index);
+		VectorStore(ShooterBallistics::SelectSolution(OutOfRange, Straight, HighTime, StraightTime, Zero), Batch.HighTime.GetData() + Index);
+
+		const int32 OutOfRangeMask = VectorMaskBits(OutOfRange);
+		for (int32 Lane = 0; Lane < 4; Lane++)
+		{
+			Batch.InRange[Index + Lane] = !(OutOfRangeMask & (1 << Lane));
+		}
+	}
+
+	SetNumProblems(Batch, Num);
+	SetNumSolutions(Batch, Num);
+#else
+	SolveBatchScalar(Batch);
+#endif
+}
@@ -0,0 +1,342 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Weapons/ShooterHitValidation.h"
+
+#include "ShooterGame.h"
+#include "Async/ParallelFor.h"
+#include "Player/ShooterHitboxHistory.h"
+#include "Weapons/ShooterWeapon_Instant.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitbox Record"), STAT_HitboxRecord, STATGROUP_ShooterHitValidation);
+DECLARE_CYCLE_STAT(TEXT("Hit Validation"), STAT_HitValidation, STATGROUP_ShooterHitValidation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hits Validated"), STAT_HitsValidated, STATGROUP_ShooterHitValidation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hits Rejected"), STAT_HitsRejected, STATGROUP_ShooterHitValidation);
+DECLARE_MEMORY_STAT(TEXT("Hitbox History"), STAT_HitboxHistoryMemory, STATGROUP_ShooterHitValidation);
+DECLARE_CYCLE_STAT(TEXT("Hit Queue"), STAT_HitQueue, STATGROUP_ShooterHitValidation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Queue Depth"), STAT_HitQueueDepth, STATGROUP_ShooterHitValidation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Queue Targets"), STAT_HitQueueTargets, STATGROUP_ShooterHitValidation);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Poses Rewound"), STAT_HitPosesRewound, STATGROUP_ShooterHitValidation);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Hit Validation Latency (ms)"), STAT_HitValidationLatency, STATGROUP_ShooterHitValidation);
+
+int32 CVar_ShooterHitValidation_Rewind = 1;
+static FAutoConsoleVariableRef CVarShooterHitValidationRewind(TEXT("ShooterHitValidation.Rewind"), CVar_ShooterHitValidation_Rewind,
+	TEXT("Validate client hits against target hitboxes rewound to shot time, else against current target bounds grown by ClientSideHitLeeway"), ECVF_Default);
+
+float CVar_ShooterHitValidation_HistoryWindow = 0.5f;
+static FAutoConsoleVariableRef CVarShooterHitValidationHistoryWindow(TEXT("ShooterHitValidation.HistoryWindow"), CVar_ShooterHitValidation_HistoryWindow,
+	TEXT("Seconds of hitbox history kept per character, longest rewind of client hit. Clamped to what 128 frames of history cover at ShooterHitValidation.RecordRate"), ECVF_Default);
+
+float CVar_ShooterHitValidation_RecordRate = 60.0f;
+static FAutoConsoleVariableRef CVarShooterHitValidationRecordRate(TEXT("ShooterHitValidation.RecordRate"), CVar_ShooterHitValidation_RecordRate,
+	TEXT("Hitbox history frames recorded per second, at most once per server frame"), ECVF_Default);
+
+float CVar_ShooterHitValidation_Leeway = 10.0f;
+static FAutoConsoleVariableRef CVarShooterHitValidationLeeway(TEXT("ShooterHitValidation.Leeway"), CVar_ShooterHitValidation_Leeway,
+	TEXT("Distance client hit may be outside of rewound hitbox"), ECVF_Default);
+
+float CVar_ShooterHitValidation_ViewDelay = 0.05f;
+static FAutoConsoleVariableRef CVarShooterHitValidationViewDelay(TEXT("ShooterHitValidation.ViewDelay"), CVar_ShooterHitValidation_ViewDelay,
+	TEXT("Seconds client draws other characters behind their replicated state, added to round trip when rewinding"), ECVF_Default);
+
+int32 CVar_ShooterHitValidation_Batch = 1;
+static FAutoConsoleVariableRef CVarShooterHitValidationBatch(TEXT("ShooterHitValidation.Batch"), CVar_ShooterHitValidation_Batch,
+	TEXT("Queue client hits and validate them in one batch at end of frame, else validate each hit when it arrives"), ECVF_Default);
+
+int32 CVar_ShooterHitValidation_MinParallelTargets = 4;
+static FAutoConsoleVariableRef CVarShooterHitValidationMinParallelTargets(TEXT("ShooterHitValidation.MinParallelTargets"), CVar_ShooterHitValidation_MinParallelTargets,
+	TEXT("Targets in batch needed to validate them on worker threads, smaller batches run on game thread"), ECVF_Default);
+
+bool UShooterHitValidation::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// net mode isn't known yet, characters register only when world is server
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && (World->WorldType == EWorldType::Game || World->WorldType == EWorldType::PIE) && !IsRunningClientOnly();
+}
+
+void UShooterHitValidation::Deinitialize()
+{
+	if (NumValidated + NumRejected > 0)
+	{
+		UE_LOG(LogShooterWeapon, Log, TEXT("Hit validation: %u hits validated, %u rejected, %u poses rewound, queue depth max %d, latency avg %.2f ms max %.2f ms"),
+			NumValidated, NumRejected, NumPosesRewound, MaxQueueDepth, GetAverageLatency() * 1000.0, MaxLatency * 1000.0);
+	}
+
+	// claims of ending world have no verdict
+	Claims.Reset();
+	Characters.Reset();
+	SET_MEMORY_STAT(STAT_HitboxHistoryMemory, 0);
+
+	Super::Deinitialize();
+}
+
+void UShooterHitValidation::Tick(float DeltaTime)
+{
+	// claims are validated before recording, against history they were rewound in
+	ProcessQueue();
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now < NextRecordTime)
+	{
+		return;
+	}
+
+	// keep cadence when frames jitter around record interval, don't catch up after long frame
+	const float RecordInterval = 1.0f / FMath::Max(CVar_ShooterHitValidation_RecordRate, 1.0f);
+	NextRecordTime = FMath::Max(NextRecordTime + RecordInterval, Now);
+
+	RecordCharacters();
+}
+
+ETickableTickType UShooterHitValidation::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UShooterHitValidation::IsTickable() const
+{
+	// history is kept while rewind is disabled, so it's valid as soon as it's enabled again
+	return Characters.Num() > 0 || Claims.Num() > 0;
+}
+
+TStatId UShooterHitValidation::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterHitValidation, STATGROUP_Tickables);
+}
+
+bool UShooterHitValidation::IsEnabled()
+{
+	return CVar_ShooterHitValidation_Rewind != 0;
+}
+
+float UShooterHitValidation::GetHistoryWindow()
+{
+	// history can't keep more frames, longer window would rewind past its oldest frame
+	const float RecordRate = FMath::Max(CVar_ShooterHitValidation_RecordRate, 1.0f);
+	return FMath::Min(CVar_ShooterHitValidation_HistoryWindow, (FShooterHitboxHistory::MaxFrames - 1) / RecordRate);
+}
+
+int32 UShooterHitValidation::GetHistoryFrames()
+{
+	// one more frame, so whole window is between oldest and newest frame
+	const float RecordRate = FMath::Max(CVar_ShooterHitValidation_RecordRate, 1.0f);
+	return FMath::Min(FMath::CeilToInt(GetHistoryWindow() * RecordRate) + 1, FShooterHitboxHistory::MaxFrames);
+}
+
+void UShooterHitValidation::RegisterCharacter(AShooterCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+void UShooterHitValidation::UnregisterCharacter(AShooterCharacter* Character)
+{
+	Characters.RemoveSwap(Character);
+}
+
+void UShooterHitValidation::RecordCharacters()
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitboxRecord);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	const int32 NumFrames = GetHistoryFrames();
+
+	SIZE_T HistoryMemory = 0;
+	for (AShooterCharacter* Character : Characters)
+	{
+		Character->RecordHitboxes(Now, NumFrames);
+		HistoryMemory += Character->GetHitboxHistory().GetAllocatedSize();
+	}
+
+	SET_MEMORY_STAT(STAT_HitboxHistoryMemory, HistoryMemory);
+}
+
+float UShooterHitValidation::GetShotTime(const AController* Shooter) const
+{
+	// shot took half round trip to arrive, and client saw targets as replicated half round trip before it fired
+	const APlayerState* PlayerState = Shooter ? Shooter->PlayerState : nullptr;
+	const float RoundTrip = PlayerState ? PlayerState->ExactPing * 0.001f : 0.0f;
+	const float RewindTime = FMath::Min(RoundTrip + CVar_ShooterHitValidation_ViewDelay, GetHistoryWindow());
+
+	return GetWorld()->GetTimeSeconds() - RewindTime;
+}
+
+bool UShooterHitValidation::HasHistory(const AActor* Target) const
+{
+	const AShooterCharacter* Character = Cast<AShooterCharacter>(Target);
+	return Character && IsEnabled() && Characters.Contains(Character) && !Character->GetHitboxHistory().IsEmpty();
+}
+
+bool UShooterHitValidation::ValidateHit(const AActor* Target, const FVector& Location, float ShotTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitValidation);
+
+	const AShooterCharacter* Character = CastChecked<AShooterCharacter>(Target);
+	const bool bIsValid = Character->GetHitboxHistory().ValidateHit(ShotTime, Location, CVar_ShooterHitValidation_Leeway);
+
+	CountHit(bIsValid);
+	return bIsValid;
+}
+
+void UShooterHitValidation::CountHit(bool bIsValid)
+{
+	if (bIsValid)
+	{
+		NumValidated++;
+		INC_DWORD_STAT(STAT_HitsValidated);
+	}
+	else
+	{
+		NumRejected++;
+		INC_DWORD_STAT(STAT_HitsRejected);
+	}
+}
+
+bool UShooterHitValidation::IsBatchEnabled()
+{
+	return CVar_ShooterHitValidation_Batch != 0;
+}
+
+bool UShooterHitValidation::IsInScaledBounds(const FBox& Bounds, const FVector& Location, float BoundsScale)
+{
+	// calculate the box extent, and increase by a leeway
+	FVector BoxExtent = Bounds.GetExtent() * BoundsScale;
+
+	// avoid precision errors with really thin objects
+	BoxExtent.X = FMath::Max(20.0f, BoxExtent.X);
+	BoxExtent.Y = FMath::Max(20.0f, BoxExtent.Y);
+	BoxExtent.Z = FMath::Max(20.0f, BoxExtent.Z);
+
+	const FVector BoxCenter = Bounds.GetCenter();
+	return FMath::Abs(Location.Z - BoxCenter.Z) < BoxExtent.Z &&
+		FMath::Abs(Location.X - BoxCenter.X) < BoxExtent.X &&
+		FMath::Abs(Location.Y - BoxCenter.Y) < BoxExtent.Y;
+}
+
+void UShooterHitValidation::QueueHit(const FShooterHitClaim& Claim)
+{
+	Claims.Add(Claim);
+}
+
+void UShooterHitValidation::ProcessQueue()
+{
+	if (Claims.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_HitQueue);
+	SET_DWORD_STAT(STAT_HitQueueDepth, Claims.Num());
+	MaxQueueDepth = FMath::Max(MaxQueueDepth, Claims.Num());
+
+	GroupClaims();
+	SET_DWORD_STAT(STAT_HitQueueTargets, NumGroups);
+
+	// groups only read histories and write their own verdicts, and nothing records while batch runs
+	ClaimResults.SetNumZeroed(Claims.Num());
+	ParallelFor(NumGroups, [this](int32 GroupIndex)
+	{
+		ValidateGroup(Groups[GroupIndex]);
+	}, NumGroups < CVar_ShooterHitValidation_MinParallelTargets);
+
+	int32 NumPoses = 0;
+	for (int32 i = 0; i < NumGroups; i++)
+	{
+		NumPoses += Groups[i].NumPoses;
+	}
+	NumPosesRewound += NumPoses;
+	INC_DWORD_STAT_BY(STAT_HitPosesRewound, NumPoses);
+
+	// weapons are told verdicts in arrival order, claims on removed targets are dropped
+	const double Now = FPlatformTime::Seconds();
+	double BatchMaxLatency = 0.0;
+	for (int32 i = 0; i < Claims.Num(); i++)
+	{
+		const FShooterHitClaim& Claim = Claims[i];
+		if (Claim.Impact.GetActor())
+		{
+			const bool bIsValid = ClaimResults[i] != 0;
+			CountHit(bIsValid);
+
+			AShooterWeapon_Instant* Weapon = Claim.Weapon.Get();
+			if (Weapon)
+			{
+				Weapon->OnClientHitValidated(Claim, bIsValid);
+			}
+		}
+
+		const double Latency = Now - Claim.QueueTime;
+		TotalLatency += Latency;
+		BatchMaxLatency = FMath::Max(BatchMaxLatency, Latency);
+		NumLatencies++;
+	}
+
+	MaxLatency = FMath::Max(MaxLatency, BatchMaxLatency);
+	SET_FLOAT_STAT(STAT_HitValidationLatency, BatchMaxLatency * 1000.0);
+
+	Claims.Reset();
+	TargetGroups.Reset();
+}
+
+void UShooterHitValidation::GroupClaims()
+{
+	NumGroups = 0;
+	TargetGroups.Reset();
+
+	for (int32 i = 0; i < Claims.Num(); i++)
+	{
+		const AActor* Target = Claims[i].Impact.GetActor();
+		if (Target == nullptr)
+		{
+			continue;
+		}
+
+		int32* GroupIndex = TargetGroups.Find(Target);
+		if (GroupIndex == nullptr)
+		{
+			if (NumGroups == Groups.Num())
+			{
+				Groups.AddDefaulted();
+			}
+
+			FTargetGroup& Group = Groups[NumGroups];
+			Group.History = HasHistory(Target) ? &CastChecked<AShooterCharacter>(Target)->GetHitboxHistory() : nullptr;
+			Group.Bounds = Group.History ? FBox(ForceInit) : Target->GetComponentsBoundingBox();
+			Group.ClaimIndices.Reset();
+			Group.NumPoses = 0;
+
+			GroupIndex = &TargetGroups.Add(Target, NumGroups);
+			NumGroups++;
+		}
+
+		Groups[*GroupIndex].ClaimIndices.Add(i);
+	}
+}
+
+void UShooterHitValidation::ValidateGroup(FTargetGroup& Group)
+{
+	if (Group.History == nullptr)
+	{
+		for (const int32 ClaimIndex : Group.ClaimIndices)
+		{
+			const FShooterHitClaim& Claim = Claims[ClaimIndex];
+			ClaimResults[ClaimIndex] = IsInScaledBounds(Group.Bounds, Claim.Impact.Location, Claim.BoundsScale);
+		}
+		return;
+	}
+
+	// claims of one shooter arriving together have the same shot time and share pose
+	Group.ClaimIndices.Sort([this](int32 A, int32 B) { return Claims[A].ShotTime < Claims[B].ShotTime; });
+
+	float PoseTime = 0.0f;
+	for (const int32 ClaimIndex : Group.ClaimIndices)
+	{
+		const FShooterHitClaim& Claim = Claims[ClaimIndex];
+		if (Group.NumPoses == 0 || Claim.ShotTime != PoseTime)
+		{
+			Group.History->Rewind(Claim.ShotTime, Group.Pose);
+			PoseTime = Claim.ShotTime;
+			Group.NumPoses++;
+		}
+
+		ClaimResults[ClaimIndex] = Group.History->IsInPose(Group.Pose, Claim.Impact.Location, CVar_ShooterHitValidation_Leeway);
+	}
+}
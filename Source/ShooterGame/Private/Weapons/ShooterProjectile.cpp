@@ -63,6 +63,12 @@ void AShooterProjectile::InitVelocity(FVector& ShootDirection)
 	}
 }
 
+void AShooterProjectile::GetBallisticParams(const UWorld* World, float& OutSpeed, float& OutGravityZ) const
+{
+	OutSpeed = MovementComp ? MovementComp->InitialSpeed : 0.0f;
+	OutGravityZ = MovementComp && World ? World->GetGravityZ() * MovementComp->ProjectileGravityScale : 0.0f;
+}
+
 void AShooterProjectile::OnImpact(const FHitResult& HitResult)
 {
 	if (GetLocalRole() == ROLE_Authority && !bExploded)
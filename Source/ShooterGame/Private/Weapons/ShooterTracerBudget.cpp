@@ -0,0 +1,237 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Weapons/ShooterTracerBudget.h"
+
+#include "ShooterGame.h"
+#include "Weapons/ShooterTracerPool.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shots Full"), STAT_TracerBudgetFull, STATGROUP_ShooterTracers);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shots Beam"), STAT_TracerBudgetBeam, STATGROUP_ShooterTracers);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shots Culled"), STAT_TracerBudgetCulled, STATGROUP_ShooterTracers);
+
+int32 CVar_ShooterTracers_Budget = 1;
+static FAutoConsoleVariableRef CVarShooterTracersBudget(TEXT("ShooterTracers.Budget"), CVar_ShooterTracers_Budget,
+	TEXT("Choose weapon shot effects detail by distance, view and budget, else every shot spawns all effects"), ECVF_Default);
+
+float CVar_ShooterTracers_BudgetFullDistance = 4000.0f;
+static FAutoConsoleVariableRef CVarShooterTracersBudgetFullDistance(TEXT("ShooterTracers.Budget.FullDistance"), CVar_ShooterTracers_BudgetFullDistance,
+	TEXT("Shots farther than this from nearest local viewer get beam instead of physic tracer"), ECVF_Default);
+
+float CVar_ShooterTracers_BudgetMaxDistance = 12000.0f;
+static FAutoConsoleVariableRef CVarShooterTracersBudgetMaxDistance(TEXT("ShooterTracers.Budget.MaxDistance"), CVar_ShooterTracers_BudgetMaxDistance,
+	TEXT("Shots farther than this from nearest local viewer aren't drawn"), ECVF_Default);
+
+float CVar_ShooterTracers_BudgetViewMargin = 10.0f;
+static FAutoConsoleVariableRef CVarShooterTracersBudgetViewMargin(TEXT("ShooterTracers.Budget.ViewMargin"), CVar_ShooterTracers_BudgetViewMargin,
+	TEXT("Degrees added to view cone, shots outside of it aren't drawn"), ECVF_Default);
+
+int32 CVar_ShooterTracers_BudgetFullPerFrame = 8;
+static FAutoConsoleVariableRef CVarShooterTracersBudgetFullPerFrame(TEXT("ShooterTracers.Budget.FullPerFrame"), CVar_ShooterTracers_BudgetFullPerFrame,
+	TEXT("Physic tracers spawned per frame, shots over it get beam"), ECVF_Default);
+
+int32 CVar_ShooterTracers_BudgetPerSecond = 120;
+static FAutoConsoleVariableRef CVarShooterTracersBudgetPerSecond(TEXT("ShooterTracers.Budget.PerSecond"), CVar_ShooterTracers_BudgetPerSecond,
+	TEXT("Shots drawn per second, shots over it aren't drawn. 0 is unlimited"), ECVF_Default);
+
+namespace ShooterTracerBudget
+{
+	/** Aspect ratio of view without viewport */
+	const float DefaultAspectRatio = 16.0f / 9.0f;
+}
+
+bool UShooterTracerBudget::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// shot effects are cosmetic, dedicated server never spawns them
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && (World->WorldType == EWorldType::Game || World->WorldType == EWorldType::PIE) && !IsRunningDedicatedServer();
+}
+
+void UShooterTracerBudget::Deinitialize()
+{
+	UE_LOG(LogShooterWeapon, Log, TEXT("Tracer budget: %u full, %u beam, %u culled (%u by distance, %u by view, %u by budget), %u degraded by budget"),
+		NumShots[(int32)EShooterShotDetail::Full], NumShots[(int32)EShooterShotDetail::Beam], NumShots[(int32)EShooterShotDetail::None],
+		NumCulledByDistance, NumCulledByView, NumCulledByBudget, NumDegradedByBudget);
+
+	Super::Deinitialize();
+}
+
+bool UShooterTracerBudget::IsEnabled()
+{
+	return CVar_ShooterTracers_Budget != 0;
+}
+
+bool UShooterTracerBudget::GetViewer(const APlayerController* PlayerController, FShooterShotViewer& OutViewer)
+{
+	if (PlayerController == nullptr || PlayerController->PlayerCameraManager == nullptr)
+	{
+		return false;
+	}
+
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(OutViewer.Location, ViewRotation);
+	OutViewer.Direction = ViewRotation.Vector();
+
+	int32 ViewportSizeX = 0;
+	int32 ViewportSizeY = 0;
+	PlayerController->GetViewportSize(ViewportSizeX, ViewportSizeY);
+	const float AspectRatio = ViewportSizeX > 0 && ViewportSizeY > 0 ? (float)ViewportSizeX / ViewportSizeY : ShooterTracerBudget::DefaultAspectRatio;
+
+	// FOV is horizontal, cone around frustum goes through its corners
+	const float HalfFOVTan = FMath::Tan(FMath::DegreesToRadians(PlayerController->PlayerCameraManager->GetFOVAngle() * 0.5f));
+	const float HalfDiagonalAngle = FMath::RadiansToDegrees(FMath::Atan(HalfFOVTan * FMath::Sqrt(1.0f + 1.0f / FMath::Square(AspectRatio))));
+	OutViewer.ViewConeCos = FMath::Cos(FMath::DegreesToRadians(FMath::Min(HalfDiagonalAngle + CVar_ShooterTracers_BudgetViewMargin, 180.0f)));
+
+	return true;
+}
+
+void UShooterTracerBudget::UpdateViewers()
+{
+	if (ViewersFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	ViewersFrame = GFrameCounter;
+	Viewers.Reset();
+
+	// split screen has viewer per local player
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		FShooterShotViewer Viewer;
+		if (PlayerController && PlayerController->IsLocalController() && GetViewer(PlayerController, Viewer))
+		{
+			Viewers.Add(Viewer);
+		}
+	}
+}
+
+EShooterShotDetail UShooterTracerBudget::EvaluateShot(const FVector& Origin, const FVector& EndPoint, bool bLocallyFired)
+{
+	UpdateViewers();
+	return EvaluateShot(Viewers, Origin, EndPoint, bLocallyFired);
+}
+
+EShooterShotDetail UShooterTracerBudget::EvaluateShot(TArrayView<const FShooterShotViewer> InViewers, const FVector& Origin, const FVector& EndPoint, bool bLocallyFired)
+{
+	if (!IsEnabled() || InViewers.Num() == 0)
+	{
+		return CountShot(EShooterShotDetail::Full);
+	}
+
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		FullShotsInFrame = 0;
+	}
+
+	// own shots are feedback to player, they take budget from others but aren't cut
+	if (bLocallyFired)
+	{
+		ConsumeSecondBudget();
+		FullShotsInFrame++;
+		return CountShot(EShooterShotDetail::Full);
+	}
+
+	float MinDistSquared = MAX_flt;
+	bool bIsInView = false;
+	for (const FShooterShotViewer& Viewer : InViewers)
+	{
+		const FVector ClosestPoint = FMath::ClosestPointOnSegment(Viewer.Location, Origin, EndPoint);
+		MinDistSquared = FMath::Min(MinDistSquared, FVector::DistSquared(Viewer.Location, ClosestPoint));
+
+		if (!bIsInView)
+		{
+			// shot is seen if its point closest to view axis is in view cone, ends are checked for shots behind viewer
+			const FVector ViewAxisEnd = Viewer.Location + Viewer.Direction * CVar_ShooterTracers_BudgetMaxDistance;
+			FVector ViewAxisPoint, ShotPoint;
+			FMath::SegmentDistToSegmentSafe(Viewer.Location, ViewAxisEnd, Origin, EndPoint, ViewAxisPoint, ShotPoint);
+
+			const FVector ShotPoints[] = { ShotPoint, Origin, EndPoint };
+			for (const FVector& Point : ShotPoints)
+			{
+				const FVector ToPoint = Point - Viewer.Location;
+				const float DistSquared = ToPoint.SizeSquared();
+				if (DistSquared < KINDA_SMALL_NUMBER || FVector::DotProduct(ToPoint, Viewer.Direction) >= Viewer.ViewConeCos * FMath::Sqrt(DistSquared))
+				{
+					bIsInView = true;
+					break;
+				}
+			}
+		}
+	}
+
+	if (MinDistSquared > FMath::Square(CVar_ShooterTracers_BudgetMaxDistance))
+	{
+		NumCulledByDistance++;
+		return CountShot(EShooterShotDetail::None);
+	}
+
+	if (!bIsInView)
+	{
+		NumCulledByView++;
+		return CountShot(EShooterShotDetail::None);
+	}
+
+	if (!ConsumeSecondBudget())
+	{
+		NumCulledByBudget++;
+		return CountShot(EShooterShotDetail::None);
+	}
+
+	if (MinDistSquared > FMath::Square(CVar_ShooterTracers_BudgetFullDistance))
+	{
+		return CountShot(EShooterShotDetail::Beam);
+	}
+
+	if (FullShotsInFrame >= CVar_ShooterTracers_BudgetFullPerFrame)
+	{
+		NumDegradedByBudget++;
+		return CountShot(EShooterShotDetail::Beam);
+	}
+
+	FullShotsInFrame++;
+	return CountShot(EShooterShotDetail::Full);
+}
+
+bool UShooterTracerBudget::ConsumeSecondBudget()
+{
+	const float PerSecond = (float)CVar_ShooterTracers_BudgetPerSecond;
+	if (PerSecond <= 0.0f)
+	{
+		return true;
+	}
+
+	// token bucket holding one second of shots, full at start
+	const double Now = GetWorld()->GetRealTimeSeconds();
+	BudgetTokens = BudgetTokens < 0.0f ? PerSecond : FMath::Min(BudgetTokens + (float)(Now - BudgetRefillTime) * PerSecond, PerSecond);
+	BudgetRefillTime = Now;
+
+	if (BudgetTokens < 1.0f)
+	{
+		return false;
+	}
+
+	BudgetTokens -= 1.0f;
+	return true;
+}
+
+EShooterShotDetail UShooterTracerBudget::CountShot(EShooterShotDetail Detail)
+{
+	NumShots[(int32)Detail]++;
+
+	switch (Detail)
+	{
+	case EShooterShotDetail::Full:
+		INC_DWORD_STAT(STAT_TracerBudgetFull);
+		break;
+	case EShooterShotDetail::Beam:
+		INC_DWORD_STAT(STAT_TracerBudgetBeam);
+		break;
+	default:
+		INC_DWORD_STAT(STAT_TracerBudgetCulled);
+		break;
+	}
+
+	return Detail;
+}
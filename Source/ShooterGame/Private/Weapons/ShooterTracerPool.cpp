@@ -0,0 +1,186 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Weapons/ShooterTracerPool.h"
+
+#include "ShooterGame.h"
+#include "Weapons/ShooterWeapon.h"
+#include "Weapons/ShooterWeaponTracerPhysic.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tracer Pool Hits"), STAT_TracerPoolHits, STATGROUP_ShooterTracers);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tracer Pool Misses"), STAT_TracerPoolMisses, STATGROUP_ShooterTracers);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Tracers Pooled"), STAT_TracerPoolTracers, STATGROUP_ShooterTracers);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Tracers Free In Pool"), STAT_TracerPoolFree, STATGROUP_ShooterTracers);
+
+int32 CVar_ShooterTracers_Pool = 1;
+static FAutoConsoleVariableRef CVarShooterTracersPool(TEXT("ShooterTracers.Pool"), CVar_ShooterTracers_Pool,
+	TEXT("Recycle physic weapon tracers through world tracer pool instead of spawning and destroying actor per shot"), ECVF_Default);
+
+int32 CVar_ShooterTracers_PoolPrewarm = 16;
+static FAutoConsoleVariableRef CVarShooterTracersPoolPrewarm(TEXT("ShooterTracers.PoolPrewarm"), CVar_ShooterTracers_PoolPrewarm,
+	TEXT("Tracers of weapon tracer class spawned to pool when weapon is spawned"), ECVF_Default);
+
+int32 CVar_ShooterTracers_PoolMaxFree = 64;
+static FAutoConsoleVariableRef CVarShooterTracersPoolMaxFree(TEXT("ShooterTracers.PoolMaxFree"), CVar_ShooterTracers_PoolMaxFree,
+	TEXT("Max free tracers kept per tracer class, tracers returned over it are destroyed"), ECVF_Default);
+
+bool UShooterTracerPool::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// tracers are cosmetic, dedicated server never spawns them
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && (World->WorldType == EWorldType::Game || World->WorldType == EWorldType::PIE) && !IsRunningDedicatedServer();
+}
+
+void UShooterTracerPool::Deinitialize()
+{
+	for (const TPair<UClass*, FShooterTracerPoolBucket>& Bucket : Buckets)
+	{
+		UE_LOG(LogShooterWeapon, Log, TEXT("Tracer pool %s: peak %d tracers"), *GetNameSafe(Bucket.Key), Bucket.Value.PeakTracers);
+		DEC_DWORD_STAT_BY(STAT_TracerPoolTracers, Bucket.Value.NumTracers);
+		DEC_DWORD_STAT_BY(STAT_TracerPoolFree, Bucket.Value.FreeTracers.Num());
+	}
+	UE_LOG(LogShooterWeapon, Log, TEXT("Tracer pool: %u hits, %u misses"), NumHits, NumMisses);
+
+	// world is torn down with all tracers, free and active
+	Buckets.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UShooterTracerPool::IsEnabled()
+{
+	return CVar_ShooterTracers_Pool != 0;
+}
+
+int32 UShooterTracerPool::GetPrewarmCount()
+{
+	return CVar_ShooterTracers_PoolPrewarm;
+}
+
+AShooterWeaponTracerPhysic* UShooterTracerPool::Acquire(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, AShooterWeapon* Weapon, const FVector& ImpactPoint)
+{
+	if (TracerClass == nullptr || Weapon == nullptr)
+	{
+		return nullptr;
+	}
+
+	FShooterTracerPoolBucket& Bucket = Buckets.FindOrAdd(TracerClass);
+
+	AShooterWeaponTracerPhysic* Tracer = nullptr;
+	while (Tracer == nullptr && Bucket.FreeTracers.Num() > 0)
+	{
+		Tracer = Bucket.FreeTracers.Pop(false);
+		DEC_DWORD_STAT(STAT_TracerPoolFree);
+
+		// free tracer destroyed from outside, e.g. by level streaming
+		if (!IsValid(Tracer))
+		{
+			Tracer = nullptr;
+			Bucket.NumTracers--;
+			DEC_DWORD_STAT(STAT_TracerPoolTracers);
+		}
+	}
+
+	if (Tracer)
+	{
+		NumHits++;
+		INC_DWORD_STAT(STAT_TracerPoolHits);
+	}
+	else
+	{
+		Tracer = SpawnTracer(TracerClass, Bucket);
+		if (Tracer == nullptr)
+		{
+			return nullptr;
+		}
+
+		NumMisses++;
+		INC_DWORD_STAT(STAT_TracerPoolMisses);
+	}
+
+	Tracer->Launch(Weapon, ImpactPoint);
+	return Tracer;
+}
+
+void UShooterTracerPool::Release(AShooterWeaponTracerPhysic* Tracer)
+{
+	if (Tracer == nullptr || Tracer->IsInPool())
+	{
+		return;
+	}
+
+	FShooterTracerPoolBucket* Bucket = Buckets.Find(Tracer->GetClass());
+	if (Bucket == nullptr || Bucket->FreeTracers.Num() >= CVar_ShooterTracers_PoolMaxFree)
+	{
+		if (Bucket)
+		{
+			Bucket->NumTracers--;
+			DEC_DWORD_STAT(STAT_TracerPoolTracers);
+		}
+
+		Tracer->OwningPool = nullptr;
+		Tracer->Destroy();
+		return;
+	}
+
+	Tracer->ResetForPool();
+	Bucket->FreeTracers.Add(Tracer);
+	INC_DWORD_STAT(STAT_TracerPoolFree);
+}
+
+void UShooterTracerPool::Prewarm(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, int32 Count)
+{
+	if (TracerClass == nullptr)
+	{
+		return;
+	}
+
+	FShooterTracerPoolBucket& Bucket = Buckets.FindOrAdd(TracerClass);
+	Count = FMath::Min(Count, CVar_ShooterTracers_PoolMaxFree);
+
+	while (Bucket.NumTracers < Count)
+	{
+		AShooterWeaponTracerPhysic* Tracer = SpawnTracer(TracerClass, Bucket);
+		if (Tracer == nullptr)
+		{
+			break;
+		}
+
+		Bucket.FreeTracers.Add(Tracer);
+		INC_DWORD_STAT(STAT_TracerPoolFree);
+	}
+}
+
+int32 UShooterTracerPool::GetPeakSize(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass) const
+{
+	const FShooterTracerPoolBucket* Bucket = Buckets.Find(TracerClass);
+	return Bucket ? Bucket->PeakTracers : 0;
+}
+
+int32 UShooterTracerPool::GetNumFree(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass) const
+{
+	const FShooterTracerPoolBucket* Bucket = Buckets.Find(TracerClass);
+	return Bucket ? Bucket->FreeTracers.Num() : 0;
+}
+
+AShooterWeaponTracerPhysic* UShooterTracerPool::SpawnTracer(UClass* TracerClass, FShooterTracerPoolBucket& Bucket)
+{
+	UWorld* World = GetWorld();
+	const FTransform Transform = FTransform::Identity;
+
+	AShooterWeaponTracerPhysic* Tracer = World->SpawnActorDeferred<AShooterWeaponTracerPhysic>(TracerClass, Transform);
+	if (Tracer == nullptr)
+	{
+		return nullptr;
+	}
+
+	// pooled tracer isn't launched by BeginPlay, it's left stopped until acquired
+	Tracer->OwningPool = this;
+	Tracer->FinishSpawning(Transform);
+	Tracer->ResetForPool();
+
+	Bucket.NumTracers++;
+	Bucket.PeakTracers = FMath::Max(Bucket.PeakTracers, Bucket.NumTracers);
+	INC_DWORD_STAT(STAT_TracerPoolTracers);
+
+	return Tracer;
+}
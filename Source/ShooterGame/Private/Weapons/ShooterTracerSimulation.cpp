@@ -0,0 +1,484 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Weapons/ShooterTracerSimulation.h"
+
+#include "ShooterGame.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Weapons/ShooterTracerPool.h"
+#include "Weapons/ShooterWeapon.h"
+#include "Weapons/ShooterWeaponTracerPhysic.h"
+
+DECLARE_CYCLE_STAT(TEXT("Tracer Simulation"), STAT_TracerSimulation, STATGROUP_ShooterTracers);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tracers Simulated"), STAT_TracersSimulated, STATGROUP_ShooterTracers);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tracer Sweeps"), STAT_TracerSweeps, STATGROUP_ShooterTracers);
+
+int32 CVar_ShooterTracers_Simulate = 1;
+static FAutoConsoleVariableRef CVarShooterTracersSimulate(TEXT("ShooterTracers.Simulate"), CVar_ShooterTracers_Simulate,
+	TEXT("Simulate tracer classes with SimulatedMesh as plain data in world tracer simulation instead of spawning tracer actors"), ECVF_Default);
+
+float CVar_ShooterTracers_FixedStep = 1.0f / 60.0f;
+static FAutoConsoleVariableRef CVarShooterTracersFixedStep(TEXT("ShooterTracers.FixedStep"), CVar_ShooterTracers_FixedStep,
+	TEXT("Seconds simulated tracers advance by per step, so they move the same on every client and replay. 0 steps by frame time"), ECVF_Default);
+
+int32 CVar_ShooterTracers_ClosedForm = 1;
+static FAutoConsoleVariableRef CVarShooterTracersClosedForm(TEXT("ShooterTracers.ClosedForm"), CVar_ShooterTracers_ClosedForm,
+	TEXT("Move simulated tracers along precomputed trajectory, sweeping only at spawn and after bounce instead of every tick"), ECVF_Default);
+
+namespace ShooterTracerSimulation
+{
+	/** Tracer is moved this far off surface it bounced from, so next sweep doesn't start penetrating it */
+	const float BounceSurfaceOffset = 0.1f;
+
+	/** Spawn segment is swept a bit past solved target, so tracer sphere surely touches surface target lies on */
+	const float SpawnSegmentTimeScale = 1.1f;
+
+	/** Chords of trajectory swept after bounce, bounced tracer has no solved target and its path curves */
+	const int32 BounceSegmentChords = 4;
+
+	/** Fixed steps simulated per frame at most, frame time over it is dropped after hitch */
+	const int32 MaxStepsPerFrame = 8;
+}
+
+bool UShooterTracerSimulation::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// tracers are cosmetic, dedicated server never spawns them
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && (World->WorldType == EWorldType::Game || World->WorldType == EWorldType::PIE) && !IsRunningDedicatedServer();
+}
+
+void UShooterTracerSimulation::Deinitialize()
+{
+	for (UInstancedStaticMeshComponent* Instances : ClassInstances)
+	{
+		if (Instances)
+		{
+			Instances->DestroyComponent();
+		}
+	}
+
+	Classes.Reset();
+	ClassParams.Reset();
+	ClassInstances.Reset();
+	ClassTransforms.Reset();
+	Tracers.Reset();
+	PendingTracers.Reset();
+	PendingLaunches.Reset();
+
+	Super::Deinitialize();
+}
+
+void UShooterTracerSimulation::Tick(float DeltaTime)
+{
+	Simulate(DeltaTime);
+}
+
+ETickableTickType UShooterTracerSimulation::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UShooterTracerSimulation::IsTickable() const
+{
+	// one more tick after last tracer is removed clears its instance
+	return Tracers.Num() > 0 || PendingTracers.Num() > 0 || bHasInstances;
+}
+
+TStatId UShooterTracerSimulation::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterTracerSimulation, STATGROUP_Tickables);
+}
+
+bool UShooterTracerSimulation::IsEnabled()
+{
+	return CVar_ShooterTracers_Simulate != 0;
+}
+
+bool UShooterTracerSimulation::CanSimulate(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass)
+{
+	return TracerClass && TracerClass->GetDefaultObject<AShooterWeaponTracerPhysic>()->GetSimulatedMesh() != nullptr;
+}
+
+bool UShooterTracerSimulation::Spawn(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, AShooterWeapon* Weapon, const FVector& Origin, const FVector& ImpactPoint, int32 RandomSeed)
+{
+	if (Weapon == nullptr)
+	{
+		return false;
+	}
+
+	const int32 ClassIndex = FindOrAddClass(TracerClass);
+	if (ClassIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FShooterTracerParams& Params = ClassParams[ClassIndex];
+	PendingLaunches.Add(Origin, ImpactPoint, Params.InitialSpeed, Params.GravityZ);
+
+	FShooterTracer& Tracer = PendingTracers.AddUninitialized_GetRef();
+	Tracer.Location = Origin;
+	Tracer.Velocity = FVector::ZeroVector;
+	Tracer.LifeSpan = Params.LifeSpan;
+	Tracer.NumSteps = 0;
+	Tracer.Random.Initialize(RandomSeed);
+	Tracer.IgnoreActorIds[0] = Weapon->GetUniqueID();
+	Tracer.IgnoreActorIds[1] = Weapon->GetOwner() ? Weapon->GetOwner()->GetUniqueID() : Weapon->GetUniqueID();
+	Tracer.ClassIndex = (uint16)ClassIndex;
+	Tracer.bIsBouncedFirstTime = false;
+	Tracer.bIsStopped = false;
+	Tracer.bIsClosedForm = CVar_ShooterTracers_ClosedForm != 0;
+
+	return true;
+}
+
+void UShooterTracerSimulation::LaunchPendingTracers()
+{
+	if (PendingTracers.Num() == 0)
+	{
+		return;
+	}
+
+	PendingLaunches.Solve();
+
+	FShooterBallisticSolution Solution;
+	for (int32 Index = 0; Index < PendingTracers.Num(); Index++)
+	{
+		PendingLaunches.GetSolution(Index, Solution);
+
+		FShooterTracer& Tracer = Tracers.Add_GetRef(PendingTracers[Index]);
+		Tracer.Velocity = Solution.LowVelocity;
+
+		if (Tracer.bIsClosedForm)
+		{
+			// unreachable target has no flight time, its trajectory curves through whole lifespan
+			const FShooterTracerParams& Params = ClassParams[Tracer.ClassIndex];
+			if (Solution.bInRange)
+			{
+				StartSegment(Tracer, Params, FMath::Min(Solution.LowTime * ShooterTracerSimulation::SpawnSegmentTimeScale, Params.LifeSpan), 1);
+			}
+			else
+			{
+				StartSegment(Tracer, Params, Params.LifeSpan, ShooterTracerSimulation::BounceSegmentChords);
+			}
+		}
+	}
+
+	PendingTracers.Reset();
+	PendingLaunches.Reset();
+}
+
+void UShooterTracerSimulation::Simulate(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TracerSimulation);
+
+	LaunchPendingTracers();
+	INC_DWORD_STAT_BY(STAT_TracersSimulated, Tracers.Num());
+
+	int32 NumSteps = 1;
+	float StepTime = DeltaTime;
+
+	const float FixedStep = GetFixedStep();
+	if (FixedStep > 0.0f)
+	{
+		StepTime = FixedStep;
+		StepAccumulator += DeltaTime;
+		NumSteps = FMath::Min(FMath::FloorToInt(StepAccumulator / FixedStep), ShooterTracerSimulation::MaxStepsPerFrame);
+		StepAccumulator = FMath::Min(StepAccumulator - NumSteps * FixedStep, FixedStep);
+	}
+
+	// tracers are independent, each one takes all its steps at once
+	for (int32 Index = 0; Index < Tracers.Num(); )
+	{
+		bool bKeep = true;
+		for (int32 Step = 0; Step < NumSteps && bKeep; Step++)
+		{
+			bKeep = StepTracer(Tracers[Index], StepTime);
+		}
+
+		if (!bKeep)
+		{
+			Tracers.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		Index++;
+	}
+
+	UpdateInstances(FixedStep > 0.0f ? StepAccumulator : 0.0f);
+}
+
+float UShooterTracerSimulation::GetFixedStep()
+{
+	return FMath::Max(CVar_ShooterTracers_FixedStep, 0.0f);
+}
+
+bool UShooterTracerSimulation::StepTracer(FShooterTracer& Tracer, float StepTime)
+{
+	Tracer.LifeSpan -= StepTime;
+	Tracer.NumSteps++;
+
+	const FShooterTracerParams& Params = ClassParams[Tracer.ClassIndex];
+	const bool bMoved = Tracer.bIsClosedForm ? MoveTracerClosedForm(Tracer, Params, StepTime) : MoveTracer(Tracer, Params, StepTime);
+
+	return bMoved && Tracer.LifeSpan > 0.0f;
+}
+
+bool UShooterTracerSimulation::ApplyHit(FShooterTracer& Tracer, const FShooterTracerParams& Params, const FVector& ImpactNormal)
+{
+	const float NormalAndVelocityDot = FVector::DotProduct(-Tracer.Velocity.GetSafeNormal(), ImpactNormal);
+	const bool bBounce = Params.bClampBounceAngle ? NormalAndVelocityDot <= Params.BounceAngleCos : Params.bShouldBounce;
+
+	if (!bBounce)
+	{
+		// steep hit removes clamped tracer, unclamped one stops like projectile movement does without bounce
+		if (Params.bClampBounceAngle)
+		{
+			return false;
+		}
+
+		Tracer.Velocity = FVector::ZeroVector;
+		Tracer.bIsStopped = true;
+		return true;
+	}
+
+	if (Params.DestroyOnBounceTime <= 0.0f || (Params.bShouldDestroyOnSecondBounce && Tracer.bIsBouncedFirstTime))
+	{
+		return false;
+	}
+
+	Tracer.LifeSpan = Params.DestroyOnBounceTime;
+	Tracer.bIsBouncedFirstTime = true;
+
+	// UProjectileMovementComponent::ComputeBounceDelta with bBounceAngleAffectsFriction
+	const float VelocityDotNormal = FVector::DotProduct(Tracer.Velocity, ImpactNormal);
+	if (VelocityDotNormal < 0.0f)
+	{
+		const FVector ProjectedNormal = ImpactNormal * -VelocityDotNormal;
+		Tracer.Velocity += ProjectedNormal;
+
+		const float ScaledFriction = FMath::Clamp(-VelocityDotNormal / Tracer.Velocity.Size(), 0.0f, 1.0f) * Params.Friction;
+		Tracer.Velocity *= FMath::Clamp(1.0f - ScaledFriction, 0.0f, 1.0f);
+		Tracer.Velocity += ProjectedNormal * FMath::Max(Params.Bounciness, 0.0f);
+	}
+
+	if (Params.BounceScatterAngle > 0.0f)
+	{
+		// scattered direction is kept off the surface
+		const float Speed = Tracer.Velocity.Size();
+		FVector Direction = Tracer.Random.VRandCone(Tracer.Velocity.GetSafeNormal(), FMath::DegreesToRadians(Params.BounceScatterAngle));
+		const float DirectionDotNormal = FVector::DotProduct(Direction, ImpactNormal);
+		if (DirectionDotNormal < 0.0f)
+		{
+			Direction -= ImpactNormal * (2.0f * DirectionDotNormal);
+		}
+		Tracer.Velocity = Direction * Speed;
+	}
+
+	if (Tracer.Velocity.SizeSquared() < FMath::Square(Params.StopSimulatingSpeed))
+	{
+		Tracer.Velocity = FVector::ZeroVector;
+		Tracer.bIsStopped = true;
+	}
+
+	return true;
+}
+
+void UShooterTracerSimulation::EvaluateSegment(const FShooterTracer& Tracer, float GravityZ, float Time, FVector& OutLocation, FVector& OutVelocity)
+{
+	const FVector Gravity(0.0f, 0.0f, GravityZ);
+	OutLocation = Tracer.SegmentStart + (Tracer.SegmentVelocity + Gravity * (0.5f * Time)) * Time;
+	OutVelocity = Tracer.SegmentVelocity + Gravity * Time;
+}
+
+FCollisionQueryParams UShooterTracerSimulation::MakeQueryParams(const FShooterTracer& Tracer)
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterTracerSweep), false);
+	QueryParams.AddIgnoredActor(Tracer.IgnoreActorIds[0]);
+	QueryParams.AddIgnoredActor(Tracer.IgnoreActorIds[1]);
+	return QueryParams;
+}
+
+int32 UShooterTracerSimulation::FindOrAddClass(UClass* TracerClass)
+{
+	const int32 Found = Classes.IndexOfByKey(TracerClass);
+	if (Found != INDEX_NONE)
+	{
+		return Found;
+	}
+
+	if (!CanSimulate(TracerClass) || Classes.Num() > MAX_uint16)
+	{
+		return INDEX_NONE;
+	}
+
+	FShooterTracerParams Params;
+	TracerClass->GetDefaultObject<AShooterWeaponTracerPhysic>()->GetSimulationParams(GetWorld(), Params);
+
+	UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>(this);
+	Instances->SetStaticMesh(Params.Mesh);
+	Instances->SetMobility(EComponentMobility::Movable);
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetCastShadow(false);
+	Instances->RegisterComponentWithWorld(GetWorld());
+
+	Classes.Add(TracerClass);
+	ClassParams.Add(Params);
+	ClassInstances.Add(Instances);
+	ClassTransforms.AddDefaulted();
+
+	return Classes.Num() - 1;
+}
+
+bool UShooterTracerSimulation::MoveTracer(FShooterTracer& Tracer, const FShooterTracerParams& Params, float DeltaTime)
+{
+	if (Tracer.bIsStopped)
+	{
+		return true;
+	}
+
+	// velocity Verlet step, same as projectile movement
+	const FVector OldVelocity = Tracer.Velocity;
+	FVector NewVelocity = OldVelocity + FVector(0.0f, 0.0f, Params.GravityZ * DeltaTime);
+	if (Params.MaxSpeed > 0.0f && NewVelocity.SizeSquared() > FMath::Square(Params.MaxSpeed))
+	{
+		NewVelocity = NewVelocity.GetUnsafeNormal() * Params.MaxSpeed;
+	}
+
+	const FVector Delta = (OldVelocity + NewVelocity) * (0.5f * DeltaTime);
+	const FVector End = Tracer.Location + Delta;
+	Tracer.Velocity = NewVelocity;
+
+	SweepHits.Reset();
+	GetWorld()->SweepMultiByProfile(SweepHits, Tracer.Location, End, FQuat::Identity, TRACER_PROFILE_NAME, FCollisionShape::MakeSphere(Params.Radius), MakeQueryParams(Tracer));
+	INC_DWORD_STAT(STAT_TracerSweeps);
+
+	// overlaps come first, blocking hit if any is last
+	for (const FHitResult& Hit : SweepHits)
+	{
+		if (!Hit.bBlockingHit)
+		{
+			if (Params.bShouldDestroyOnOverlap)
+			{
+				return false;
+			}
+			continue;
+		}
+
+		Tracer.Location = Hit.Location + Hit.Normal * ShooterTracerSimulation::BounceSurfaceOffset;
+		return ApplyHit(Tracer, Params, Hit.ImpactNormal);
+	}
+
+	Tracer.Location = End;
+	return true;
+}
+
+bool UShooterTracerSimulation::MoveTracerClosedForm(FShooterTracer& Tracer, const FShooterTracerParams& Params, float DeltaTime)
+{
+	if (Tracer.bIsStopped)
+	{
+		return true;
+	}
+
+	Tracer.SegmentTime += DeltaTime;
+	if (Tracer.SegmentTime < Tracer.ImpactTime)
+	{
+		EvaluateSegment(Tracer, Params.GravityZ, Tracer.SegmentTime, Tracer.Location, Tracer.Velocity);
+		return true;
+	}
+
+	// rest of frame after impact is dropped, bounce starts next frame
+	FVector ImpactTrajectoryLocation;
+	EvaluateSegment(Tracer, Params.GravityZ, Tracer.ImpactTime, ImpactTrajectoryLocation, Tracer.Velocity);
+	Tracer.Location = Tracer.ImpactLocation;
+
+	if (Tracer.bImpactRemoves || !ApplyHit(Tracer, Params, Tracer.ImpactNormal))
+	{
+		return false;
+	}
+
+	if (!Tracer.bIsStopped)
+	{
+		StartSegment(Tracer, Params, Tracer.LifeSpan, ShooterTracerSimulation::BounceSegmentChords);
+	}
+	return true;
+}
+
+void UShooterTracerSimulation::StartSegment(FShooterTracer& Tracer, const FShooterTracerParams& Params, float Duration, int32 NumChords)
+{
+	Tracer.SegmentStart = Tracer.Location;
+	Tracer.SegmentVelocity = Tracer.Velocity;
+	Tracer.SegmentTime = 0.0f;
+	Tracer.ImpactTime = MAX_flt;
+	Tracer.bImpactRemoves = false;
+
+	const FCollisionQueryParams QueryParams = MakeQueryParams(Tracer);
+	const FCollisionShape Shape = FCollisionShape::MakeSphere(Params.Radius);
+
+	float ChordStartTime = 0.0f;
+	FVector ChordStart = Tracer.SegmentStart;
+	for (int32 Chord = 1; Chord <= NumChords; Chord++)
+	{
+		const float ChordEndTime = Duration * Chord / NumChords;
+		FVector ChordEnd, ChordEndVelocity;
+		EvaluateSegment(Tracer, Params.GravityZ, ChordEndTime, ChordEnd, ChordEndVelocity);
+
+		SweepHits.Reset();
+		GetWorld()->SweepMultiByProfile(SweepHits, ChordStart, ChordEnd, FQuat::Identity, TRACER_PROFILE_NAME, Shape, QueryParams);
+		INC_DWORD_STAT(STAT_TracerSweeps);
+
+		// overlaps come first, blocking hit if any is last
+		for (const FHitResult& Hit : SweepHits)
+		{
+			if (!Hit.bBlockingHit && !Params.bShouldDestroyOnOverlap)
+			{
+				continue;
+			}
+
+			// horizontal motion is uniform, so fraction along chord is fraction of chord time
+			Tracer.ImpactTime = FMath::Lerp(ChordStartTime, ChordEndTime, Hit.Time);
+			Tracer.bImpactRemoves = !Hit.bBlockingHit;
+			Tracer.ImpactLocation = Hit.bBlockingHit ? Hit.Location + Hit.Normal * ShooterTracerSimulation::BounceSurfaceOffset : Hit.Location;
+			Tracer.ImpactNormal = Hit.ImpactNormal;
+			return;
+		}
+
+		ChordStartTime = ChordEndTime;
+		ChordStart = ChordEnd;
+	}
+}
+
+void UShooterTracerSimulation::UpdateInstances(float ExtrapolationTime)
+{
+	for (TArray<FTransform>& Transforms : ClassTransforms)
+	{
+		Transforms.Reset();
+	}
+
+	for (const FShooterTracer& Tracer : Tracers)
+	{
+		const FShooterTracerParams& Params = ClassParams[Tracer.ClassIndex];
+		ClassTransforms[Tracer.ClassIndex].Emplace(Tracer.Velocity.Rotation(), Tracer.Location + Tracer.Velocity * ExtrapolationTime, Params.MeshScale);
+	}
+
+	bHasInstances = false;
+	for (int32 ClassIndex = 0; ClassIndex < ClassInstances.Num(); ClassIndex++)
+	{
+		UInstancedStaticMeshComponent* Instances = ClassInstances[ClassIndex];
+		const TArray<FTransform>& Transforms = ClassTransforms[ClassIndex];
+
+		// instances are interchangeable, only their count follows tracers
+		while (Instances->GetInstanceCount() > Transforms.Num())
+		{
+			Instances->RemoveInstance(Instances->GetInstanceCount() - 1);
+		}
+		while (Instances->GetInstanceCount() < Transforms.Num())
+		{
+			Instances->AddInstance(FTransform::Identity);
+		}
+
+		if (Transforms.Num() > 0)
+		{
+			Instances->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+			bHasInstances = true;
+		}
+	}
+}
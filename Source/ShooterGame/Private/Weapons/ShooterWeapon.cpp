@@ -7,6 +7,8 @@
 #include "Bots/ShooterAIController.h"
 #include "Online/ShooterPlayerState.h"
 #include "UI/ShooterHUD.h"
+#include "Weapons/ShooterTracerPool.h"
+#include "Weapons/ShooterTracerSimulation.h"
 #include "Camera/CameraShake.h"
 
 FOnShooterCharacterWeaponShot AShooterWeapon::NotifyShooterCharacterWeaponShot;
@@ -66,6 +68,14 @@ void AShooterWeapon::PostInitializeComponents()
 	}
 
 	DetachMeshFromPawn();
+
+	// tracers of first shots come from pool too, simulated tracers have no actors to pool
+	UShooterTracerPool* TracerPool = GetWorld()->GetSubsystem<UShooterTracerPool>();
+	const bool bSimulatedTracers = UShooterTracerSimulation::IsEnabled() && UShooterTracerSimulation::CanSimulate(TracerPhysicClass);
+	if (TracerPhysicClass && TracerPool && UShooterTracerPool::IsEnabled() && !bSimulatedTracers)
+	{
+		TracerPool->Prewarm(TracerPhysicClass, UShooterTracerPool::GetPrewarmCount());
+	}
 }
 
 void AShooterWeapon::Destroyed()
@@ -437,6 +447,11 @@ void AShooterWeapon::HandleFiring()
 		{
 			SimulateWeaponFire();
 		}
+		else
+		{
+			// SimulateWeaponFire() notifies shot, dedicated server still needs it for radar feed
+			NotifyShooterCharacterWeaponShot.Broadcast(MyPawn, this);
+		}
 
 		if (MyPawn && MyPawn->IsLocallyControlled())
 		{
@@ -10,6 +10,9 @@
 #include "Kismet/GameplayStatics.h"
 
 #include "Weapons/ShooterWeapon.h"
+#include "Weapons/ShooterBallistics.h"
+#include "Weapons/ShooterTracerPool.h"
+#include "Weapons/ShooterTracerSimulation.h"
 #include "ShooterGame.h"
 
 AShooterWeaponTracerPhysic::AShooterWeaponTracerPhysic()
@@ -52,18 +55,36 @@ AShooterWeaponTracerPhysic::AShooterWeaponTracerPhysic()
 	bShouldDestroyOnOverlap = true;
 	DestroyOnBounceTime = 0.2f;
 	bShouldDestroyOnSecondBounce = true;
+	bIsBouncedFirstTime = false;
+	bIsInPool = false;
 	BounceAngleToNormalMin = 75.0f;
 	BounceAngleCos = cosf(FMath::DegreesToRadians(BounceAngleToNormalMin));  // initialize reflect cos angle
+	SimulatedMesh = nullptr;
+	SimulatedMeshScale = FVector::OneVector;
+	BounceScatterAngle = 0.0f;
 }
 
-AShooterWeaponTracerPhysic* AShooterWeaponTracerPhysic::SpawnFromWeapon(AShooterWeapon* Weapon, TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, const FHitResult& HitResult)
+AShooterWeaponTracerPhysic* AShooterWeaponTracerPhysic::SpawnFromWeapon(AShooterWeapon* Weapon, TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, const FVector& Origin,
+	const FHitResult& HitResult, int32 RandomSeed)
 {
 	if (Weapon == nullptr)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Can't spawn AShooterWeaponTracerPhysic, weapon %s instance is NULL)"), *AShooterWeapon::StaticClass()->GetName());
+		UE_LOG(LogShooterWeapon, Warning, TEXT("Can't spawn AShooterWeaponTracerPhysic, weapon %s instance is NULL)"), *AShooterWeapon::StaticClass()->GetName());
 		return nullptr;
 	}
 
+	UShooterTracerSimulation* Simulation = Weapon->GetWorld()->GetSubsystem<UShooterTracerSimulation>();
+	if (Simulation && UShooterTracerSimulation::IsEnabled() && Simulation->Spawn(TracerClass, Weapon, Origin, HitResult.ImpactPoint, RandomSeed))
+	{
+		return nullptr;
+	}
+
+	UShooterTracerPool* Pool = Weapon->GetWorld()->GetSubsystem<UShooterTracerPool>();
+	if (Pool && UShooterTracerPool::IsEnabled())
+	{
+		return Pool->Acquire(TracerClass, Weapon, HitResult.ImpactPoint);
+	}
+
 	FVector MuzzleLoc = Weapon->GetMuzzleLocation();
 	FVector ImpactPoint = HitResult.ImpactPoint;
 
@@ -92,19 +113,102 @@ void AShooterWeaponTracerPhysic::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (OwningPool.IsValid())
+	{
+		// pooled tracer is launched by pool, but may begin play while it's free in pool (pre-warmed before world BeginPlay)
+		if (bIsInPool)
+		{
+			SetLifeSpan(0.0f);
+		}
+		return;
+	}
+
 	//DbgTestAdjustInitialVelocityToHitTarget();
 
-	TArray<FVector> Velocities;
-	ComputeProjectileInitialVelocitiesToHitTarget(TargetDestination, Velocities);
+	LaunchToTarget();
+}
+
+void AShooterWeaponTracerPhysic::LifeSpanExpired()
+{
+	Recycle();
+}
+
+void AShooterWeaponTracerPhysic::Launch(AShooterWeapon* Weapon, const FVector& ImpactPoint)
+{
+	const FVector MuzzleLoc = Weapon->GetMuzzleLocation();
+	const FVector ShotDirection = (ImpactPoint - MuzzleLoc).GetSafeNormal();
+
+	// move while collision is still off, so old location doesn't get overlaps
+	SetOwner(Weapon);
+	SetActorLocationAndRotation(MuzzleLoc, ShotDirection.Rotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	TargetDestination = ImpactPoint;
+	SphereComp->MoveIgnoreActors.Reset();
+	SphereComp->MoveIgnoreActors.Add(Weapon);
+	SphereComp->MoveIgnoreActors.Add(Weapon->GetOwner());
+
+	// SetLifeSpan() and OnHit() of previous flight overwrite class defaults
+	const AShooterWeaponTracerPhysic* Defaults = GetClass()->GetDefaultObject<AShooterWeaponTracerPhysic>();
+	bIsInPool = false;
+	bIsBouncedFirstTime = false;
+	ProjectileComp->bShouldBounce = Defaults->ProjectileComp->bShouldBounce;
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	ParticleSystemComp->Activate(true);  // reset trail of previous flight
+
+	LaunchToTarget();
+	SetLifeSpan(Defaults->InitialLifeSpan);
+}
+
+void AShooterWeaponTracerPhysic::LaunchToTarget()
+{
+	FShooterBallisticSolution Solution;
+	ComputeProjectileInitialVelocitiesToHitTarget(TargetDestination, Solution);
 
 	// debug
 	//if (GEngine)
-	//	for (auto& Vel : Velocities)
-	//		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Orange, *Vel.ToString(), false);
+	//	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Orange, *Solution.LowVelocity.ToString(), false);
+
+	// simulation stopped on previous flight clears updated component
+	ProjectileComp->SetUpdatedComponent(SphereComp);
+	ProjectileComp->Velocity = Solution.LowVelocity;
+
+	ProjectileComp->Activate(true);
+}
+
+void AShooterWeaponTracerPhysic::ResetForPool()
+{
+	bIsInPool = true;
+	SetLifeSpan(0.0f);
 
-	ProjectileComp->Velocity = (Velocities[0]);
+	// may be called from projectile movement hit callback, stopped simulation ends its move loop
+	ProjectileComp->StopSimulating(FHitResult());
+	ProjectileComp->Deactivate();
+	ParticleSystemComp->Deactivate();
 
-	ProjectileComp->Activate();
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	SphereComp->MoveIgnoreActors.Reset();
+	SetOwner(nullptr);
+}
+
+void AShooterWeaponTracerPhysic::Recycle()
+{
+	if (bIsInPool)
+	{
+		return;
+	}
+
+	if (UShooterTracerPool* Pool = OwningPool.Get())
+	{
+		Pool->Release(this);
+	}
+	else
+	{
+		Destroy();
+	}
 }
 
 void AShooterWeaponTracerPhysic::OnProjectileBounce(const FHitResult& ImpactResult, const FVector& ImpactVelocity)
@@ -113,7 +217,7 @@ void AShooterWeaponTracerPhysic::OnProjectileBounce(const FHitResult& ImpactResu
 
 	if (bShouldDestroyOnSecondBounce && bIsBouncedFirstTime)
 	{
-		Destroy();
+		Recycle();
 		return;
 	}
 
@@ -133,7 +237,7 @@ void AShooterWeaponTracerPhysic::OnOverlapBegin(UPrimitiveComponent* OverlappedC
 
 	if (bShouldDestroyOnOverlap)
 	{
-		Destroy();
+		Recycle();
 	}
 }
 
@@ -178,66 +282,35 @@ void AShooterWeaponTracerPhysic::OnHit(UPrimitiveComponent* HitComponent, AActor
 		}
 		else
 		{
-			Destroy();
+			Recycle();
 		}
 	}
 }
 
-void AShooterWeaponTracerPhysic::ComputeProjectileInitialVelocitiesToHitTarget(FVector ImpactPoint, TArray<FVector>& OutVelocityArray)
+void AShooterWeaponTracerPhysic::GetSimulationParams(UWorld* World, FShooterTracerParams& OutParams) const
 {
-	float Gravity = ProjectileComp->GetGravityZ();
-	float VelMagnitude = ProjectileComp->InitialSpeed;
-	FVector P_Delta = GetActorLocation() - ImpactPoint;
-
-	if (Gravity == 0.0f)  // need to shoot straight line
-	{
-		FVector Velocity_StraightLine = -P_Delta.GetSafeNormal() * VelMagnitude;
-		OutVelocityArray = { Velocity_StraightLine };
-		return;
-	}
-
-	float VelMagnitude_Square = VelMagnitude * VelMagnitude;
-	float Gravity_Square = Gravity * Gravity;
-
-	float B = Gravity * P_Delta.Z - VelMagnitude_Square;
-	float Discriminant = B * B - Gravity_Square * (P_Delta.Z * P_Delta.Z + P_Delta.X * P_Delta.X + P_Delta.Y * P_Delta.Y);
-
-	if (Discriminant < 0.0f) // no solution, can't reach target, then add 45degree to reach max distance
-	{
-
-		FVector Velocity_MaxDist(P_Delta.X, P_Delta.Y, 0.0f);
-		Velocity_MaxDist.Normalize();
-		Velocity_MaxDist *= -VelMagnitude * 0.707107f;
-		Velocity_MaxDist.Z = VelMagnitude * 0.707107f;
-
-		OutVelocityArray = { Velocity_MaxDist };
-	}
-	else
-	{
-		float Discriminant_Sqrt = sqrtf(Discriminant);
-
-		float TimeStraight = sqrtf((-B - Discriminant_Sqrt) / (0.5f * Gravity_Square));
-
-		if (TimeStraight == 0.0f) // need to shot straight line
-		{
-			FVector Velocity_StraightLine = -P_Delta.GetSafeNormal() * VelMagnitude;
-			OutVelocityArray = { Velocity_StraightLine };
-			return;
-		}
-
-		float TimeOverhead = sqrtf((-B + Discriminant_Sqrt) / (0.5f * Gravity_Square));
-
-		// debug
-		//FString msg = FString::Printf(TEXT("Gravity=%f, P_Delta.Z=%f, B=%f, sqrt(D)=%f, T1=%f T2=%f"), Gravity, P_Delta.Z, B, Discriminant_Sqrt, TimeStraight, TimeOverhead);
-		//if (GEngine)
-		//	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Red, *msg);
-		
-
-		FVector Velocity_Straight(-P_Delta.X / TimeStraight, -P_Delta.Y / TimeStraight, -P_Delta.Z / TimeStraight - Gravity * TimeStraight * 0.5f);
-		FVector Velocity_Overhead(-P_Delta.X / TimeOverhead, -P_Delta.Y / TimeOverhead, -P_Delta.Z / TimeOverhead - Gravity * TimeOverhead * 0.5f);
+	OutParams.Radius = SphereComp->GetUnscaledSphereRadius();
+	OutParams.GravityZ = (World ? World->GetGravityZ() : 0.0f) * ProjectileComp->ProjectileGravityScale;
+	OutParams.InitialSpeed = ProjectileComp->InitialSpeed;
+	OutParams.MaxSpeed = ProjectileComp->MaxSpeed;
+	OutParams.Bounciness = ProjectileComp->Bounciness;
+	OutParams.Friction = ProjectileComp->Friction;
+	OutParams.StopSimulatingSpeed = ProjectileComp->BounceVelocityStopSimulatingThreshold;
+	OutParams.LifeSpan = InitialLifeSpan;
+	OutParams.DestroyOnBounceTime = DestroyOnBounceTime;
+	OutParams.BounceAngleCos = FMath::Cos(FMath::DegreesToRadians(BounceAngleToNormalMin));  // BounceAngleCos is constructor value, blueprint may change angle
+	OutParams.bClampBounceAngle = BounceAngleToNormalMin > 0.0f;
+	OutParams.bShouldBounce = ProjectileComp->bShouldBounce;
+	OutParams.bShouldDestroyOnSecondBounce = bShouldDestroyOnSecondBounce;
+	OutParams.bShouldDestroyOnOverlap = bShouldDestroyOnOverlap;
+	OutParams.BounceScatterAngle = BounceScatterAngle;
+	OutParams.Mesh = SimulatedMesh;
+	OutParams.MeshScale = SimulatedMeshScale;
+}
 
-		OutVelocityArray = { Velocity_Straight, Velocity_Overhead };
-	}
+void AShooterWeaponTracerPhysic::ComputeProjectileInitialVelocitiesToHitTarget(FVector ImpactPoint, FShooterBallisticSolution& OutSolution)
+{
+	FShooterBallistics::Solve(GetActorLocation(), ImpactPoint, ProjectileComp->InitialSpeed, ProjectileComp->GetGravityZ(), OutSolution);
 }
 
 void AShooterWeaponTracerPhysic::DbgTestAdjustInitialVelocityToHitTarget()
@@ -6,6 +6,8 @@
 #include "Effects/ShooterImpactEffect.h"
 
 #include "ShooterWeaponTracerPhysic.h"
+#include "Weapons/ShooterHitValidation.h"
+#include "Weapons/ShooterTracerBudget.h"
 
 AShooterWeapon_Instant::AShooterWeapon_Instant(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -33,20 +35,20 @@ void AShooterWeapon_Instant::FireWeapon()
 	CurrentFiringSpread = FMath::Min(InstantConfig.FiringSpreadMax, CurrentFiringSpread + InstantConfig.FiringSpreadIncrement);
 }
 
-bool AShooterWeapon_Instant::ServerNotifyHit_Validate(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+bool AShooterWeapon_Instant::ServerNotifyHit_Validate(const FHitResult& Impact, FVector_NetQuantize Origin, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
 {
 	return true;
 }
 
-void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_NetQuantize ClientOrigin, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
 {
 	const float WeaponAngleDot = FMath::Abs(FMath::Sin(ReticleSpread * PI / 180.f));
 
 	// if we have an instigator, calculate dot between the view and the shot
 	if (GetInstigator() && (Impact.GetActor() || Impact.bBlockingHit))
 	{
-		const FVector Origin = GetMuzzleLocation();
-		const FVector ViewDir = (Impact.Location - Origin).GetSafeNormal();
+		const FVector ViewDir = (Impact.Location - GetMuzzleLocation()).GetSafeNormal();
+		const FVector Origin = GetClientShotOrigin(ClientOrigin);
 
 		// is the angle between the hit and the view within allowed limits (limit + weapon max angle)
 		const float ViewDotHitDir = FVector::DotProduct(GetInstigator()->GetViewRotation().Vector(), ViewDir);
@@ -69,32 +71,7 @@ void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Im
 				}
 				else
 				{
-					// Get the component bounding box
-					const FBox HitBox = Impact.GetActor()->GetComponentsBoundingBox();
-
-					// calculate the box extent, and increase by a leeway
-					FVector BoxExtent = 0.5 * (HitBox.Max - HitBox.Min);
-					BoxExtent *= InstantConfig.ClientSideHitLeeway;
-
-					// avoid precision errors with really thin objects
-					BoxExtent.X = FMath::Max(20.0f, BoxExtent.X);
-					BoxExtent.Y = FMath::Max(20.0f, BoxExtent.Y);
-					BoxExtent.Z = FMath::Max(20.0f, BoxExtent.Z);
-
-					// Get the box center
-					const FVector BoxCenter = (HitBox.Min + HitBox.Max) * 0.5;
-
-					// if we are within client tolerance
-					if (FMath::Abs(Impact.Location.Z - BoxCenter.Z) < BoxExtent.Z &&
-						FMath::Abs(Impact.Location.X - BoxCenter.X) < BoxExtent.X &&
-						FMath::Abs(Impact.Location.Y - BoxCenter.Y) < BoxExtent.Y)
-					{
-						ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
-					}
-					else
-					{
-						UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side hit of %s (outside bounding box tolerance)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()));
-					}
+					ValidateClientHit(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
 				}
 			}
 		}
@@ -109,14 +86,64 @@ void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Im
 	}
 }
 
-bool AShooterWeapon_Instant::ServerNotifyMiss_Validate(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+bool AShooterWeapon_Instant::IsClientHitInTolerance(const FHitResult& Impact) const
+{
+	// characters are checked against their hitboxes at the time client fired
+	UShooterHitValidation* HitValidation = GetWorld()->GetSubsystem<UShooterHitValidation>();
+	if (HitValidation && HitValidation->HasHistory(Impact.GetActor()))
+	{
+		return HitValidation->ValidateHit(Impact.GetActor(), Impact.Location, HitValidation->GetShotTime(GetInstigatorController()));
+	}
+
+	return UShooterHitValidation::IsInScaledBounds(Impact.GetActor()->GetComponentsBoundingBox(), Impact.Location, InstantConfig.ClientSideHitLeeway);
+}
+
+void AShooterWeapon_Instant::ValidateClientHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread)
+{
+	UShooterHitValidation* HitValidation = GetWorld()->GetSubsystem<UShooterHitValidation>();
+
+	// shot time and muzzle are taken now, when hit arrives
+	FShooterHitClaim Claim;
+	Claim.Weapon = this;
+	Claim.Impact = Impact;
+	Claim.Origin = Origin;
+	Claim.ShootDir = ShootDir;
+	Claim.RandomSeed = RandomSeed;
+	Claim.ReticleSpread = ReticleSpread;
+	Claim.ShotTime = HitValidation ? HitValidation->GetShotTime(GetInstigatorController()) : 0.0f;
+	Claim.BoundsScale = InstantConfig.ClientSideHitLeeway;
+	Claim.QueueTime = FPlatformTime::Seconds();
+
+	if (HitValidation && UShooterHitValidation::IsBatchEnabled())
+	{
+		HitValidation->QueueHit(Claim);
+	}
+	else
+	{
+		OnClientHitValidated(Claim, IsClientHitInTolerance(Impact));
+	}
+}
+
+void AShooterWeapon_Instant::OnClientHitValidated(const FShooterHitClaim& Claim, bool bIsValid)
+{
+	if (bIsValid)
+	{
+		ProcessInstantHit_Confirmed(Claim.Impact, Claim.Origin, Claim.ShootDir, Claim.RandomSeed, Claim.ReticleSpread);
+	}
+	else
+	{
+		UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side hit of %s (outside hitbox tolerance)"), *GetNameSafe(this), *GetNameSafe(Claim.Impact.GetActor()));
+	}
+}
+
+bool AShooterWeapon_Instant::ServerNotifyMiss_Validate(FVector_NetQuantize Origin, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
 {
 	return true;
 }
 
-void AShooterWeapon_Instant::ServerNotifyMiss_Implementation(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+void AShooterWeapon_Instant::ServerNotifyMiss_Implementation(FVector_NetQuantize ClientOrigin, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
 {
-	const FVector Origin = GetMuzzleLocation();
+	const FVector Origin = GetClientShotOrigin(ClientOrigin);
 
 	// play FX on remote clients
 	HitNotify.Origin = Origin;
@@ -127,10 +154,20 @@ void AShooterWeapon_Instant::ServerNotifyMiss_Implementation(FVector_NetQuantize
 	if (GetNetMode() != NM_DedicatedServer)
 	{
 		const FVector EndTrace = Origin + ShootDir * InstantConfig.WeaponRange;
-		SpawnTrailEffect(EndTrace);
+		if (GetShotDetail(EndTrace) != EShooterShotDetail::None)
+		{
+			SpawnTrailEffect(EndTrace);
+		}
 	}
 }
 
+FVector AShooterWeapon_Instant::GetClientShotOrigin(const FVector& ClientOrigin) const
+{
+	// origin is only cosmetic, client shoots from its camera ahead of the pawn, which is near the muzzle
+	const FVector MuzzleLocation = GetMuzzleLocation();
+	return FVector::DistSquared(ClientOrigin, MuzzleLocation) <= FMath::Square(InstantConfig.ClientShotOriginTolerance) ? ClientOrigin : MuzzleLocation;
+}
+
 void AShooterWeapon_Instant::ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread)
 {
 	if (MyPawn && MyPawn->IsLocallyControlled() && GetNetMode() == NM_Client)
@@ -139,19 +176,19 @@ void AShooterWeapon_Instant::ProcessInstantHit(const FHitResult& Impact, const F
 		if (Impact.GetActor() && Impact.GetActor()->GetRemoteRole() == ROLE_Authority)
 		{
 			// notify the server of the hit
-			ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread);
+			ServerNotifyHit(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
 		}
 		else if (Impact.GetActor() == NULL)
 		{
 			if (Impact.bBlockingHit)
 			{
 				// notify the server of the hit
-				ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread);
+				ServerNotifyHit(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
 			}
 			else
 			{
 				// notify server of the miss
-				ServerNotifyMiss(ShootDir, RandomSeed, ReticleSpread);
+				ServerNotifyMiss(Origin, ShootDir, RandomSeed, ReticleSpread);
 			}
 		}
 	}
@@ -168,10 +205,13 @@ void AShooterWeapon_Instant::ProcessInstantHit_Confirmed(const FHitResult& Impac
 		DealDamage(Impact, ShootDir);
 	}
 
+	// tracer starts at shot origin remote clients replay it from, rounded as ServerNotifyHit/Miss send it
+	const FVector TracerOrigin = Origin.GridSnap(1.0f);
+
 	// play FX on remote clients
 	if (GetLocalRole() == ROLE_Authority)
 	{
-		HitNotify.Origin = Origin;
+		HitNotify.Origin = TracerOrigin;
 		HitNotify.RandomSeed = RandomSeed;
 		HitNotify.ReticleSpread = ReticleSpread;
 	}
@@ -182,9 +222,8 @@ void AShooterWeapon_Instant::ProcessInstantHit_Confirmed(const FHitResult& Impac
 		const FVector EndTrace = Origin + ShootDir * InstantConfig.WeaponRange;
 		const FVector EndPoint = Impact.GetActor() ? Impact.ImpactPoint : EndTrace;
 
-		SpawnTrailEffect(EndPoint);
-		SpawnImpactEffects(Impact);
-		SpawnTracerPhysic(Impact);
+		// muzzle is only used by trail
+		SpawnShotEffects(Impact, EndPoint, TracerOrigin, RandomSeed);
 	}
 }
 
@@ -212,7 +251,9 @@ void AShooterWeapon_Instant::DealDamage(const FHitResult& Impact, const FVector&
 	PointDmg.ShotDirection = ShootDir;
 	PointDmg.Damage = InstantConfig.HitDamage;
 
-	Impact.GetActor()->TakeDamage(PointDmg.Damage, PointDmg, MyPawn->Controller, this);
+	// weapon may be unequipped by the time queued hit is confirmed
+	AController* InstigatorController = (MyPawn != NULL) ? MyPawn->Controller : NULL;
+	Impact.GetActor()->TakeDamage(PointDmg.Damage, PointDmg, InstigatorController, this);
 }
 
 void AShooterWeapon_Instant::OnBurstFinished()
@@ -259,16 +300,44 @@ void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32
 	FHitResult Impact = WeaponTrace(StartTrace, EndTrace);
 	if (Impact.bBlockingHit)
 	{
-		SpawnImpactEffects(Impact);
-		SpawnTrailEffect(Impact.ImpactPoint);
-		SpawnTracerPhysic(Impact);
+		SpawnShotEffects(Impact, Impact.ImpactPoint, ShotOrigin, RandomSeed);
 	}
-	else
+	else if (GetShotDetail(EndTrace) != EShooterShotDetail::None)
 	{
 		SpawnTrailEffect(EndTrace);
 	}
 }
 
+EShooterShotDetail AShooterWeapon_Instant::GetShotDetail(const FVector& EndPoint) const
+{
+	UShooterTracerBudget* Budget = GetWorld()->GetSubsystem<UShooterTracerBudget>();
+	if (Budget == nullptr)
+	{
+		return EShooterShotDetail::Full;
+	}
+
+	// bots on listen server are local too, only player's own shots are exempt from budget
+	const bool bLocallyFired = MyPawn && MyPawn->IsLocallyControlled() && MyPawn->IsPlayerControlled();
+	return Budget->EvaluateShot(GetMuzzleLocation(), EndPoint, bLocallyFired);
+}
+
+void AShooterWeapon_Instant::SpawnShotEffects(const FHitResult& Impact, const FVector& EndPoint, const FVector& TracerOrigin, int32 RandomSeed)
+{
+	const EShooterShotDetail Detail = GetShotDetail(EndPoint);
+	if (Detail == EShooterShotDetail::None)
+	{
+		return;
+	}
+
+	SpawnTrailEffect(EndPoint);
+	SpawnImpactEffects(Impact);
+
+	if (Detail == EShooterShotDetail::Full)
+	{
+		SpawnTracerPhysic(Impact, TracerOrigin, RandomSeed);
+	}
+}
+
 void AShooterWeapon_Instant::SpawnImpactEffects(const FHitResult& Impact)
 {
 	if (ImpactTemplate && Impact.bBlockingHit)
@@ -294,11 +363,11 @@ void AShooterWeapon_Instant::SpawnImpactEffects(const FHitResult& Impact)
 	}
 }
 
-void AShooterWeapon_Instant::SpawnTracerPhysic(const FHitResult& Impact)
+void AShooterWeapon_Instant::SpawnTracerPhysic(const FHitResult& Impact, const FVector& Origin, int32 RandomSeed)
 {
 	if (TracerPhysicClass)
 	{
-		AShooterWeaponTracerPhysic::SpawnFromWeapon(this, TracerPhysicClass, Impact);
+		AShooterWeaponTracerPhysic::SpawnFromWeapon(this, TracerPhysicClass, Origin, Impact, RandomSeed);
 	}
 }
 
@@ -321,4 +390,19 @@ void AShooterWeapon_Instant::GetLifetimeReplicatedProps( TArray< FLifetimeProper
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 
 	DOREPLIFETIME_CONDITION( AShooterWeapon_Instant, HitNotify, COND_SkipOwner );
-}
\ No newline at end of file
+}
+#if WITH_DEV_AUTOMATION_TESTS
+void AShooterWeapon_Instant::FireConfirmedShotForTest(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, const FVector& Origin, int32 RandomSeed)
+{
+	TracerPhysicClass = TracerClass;
+	const FVector ShootDir = GetAdjustedAim();
+	const FHitResult Impact = WeaponTrace(Origin, Origin + ShootDir * InstantConfig.WeaponRange);
+	ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, 0.0f);
+}
+
+void AShooterWeapon_Instant::FireSimulatedShotForTest(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, const FVector& Origin, int32 RandomSeed)
+{
+	TracerPhysicClass = TracerClass;
+	SimulateInstantHit(Origin, RandomSeed, 0.0f);
+}
+#endif
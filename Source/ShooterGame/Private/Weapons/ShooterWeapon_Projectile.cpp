@@ -3,6 +3,13 @@
 #include "ShooterGame.h"
 #include "Weapons/ShooterWeapon_Projectile.h"
 #include "Weapons/ShooterProjectile.h"
+#include "Weapons/ShooterBallistics.h"
+
+namespace ShooterWeaponProjectile
+{
+	/** Refinements of lead aim point, each re-solves flight time to previous aim point */
+	const int32 LeadAimIterations = 2;
+}
 
 AShooterWeapon_Projectile::AShooterWeapon_Projectile(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -25,7 +32,7 @@ void AShooterWeapon_Projectile::FireWeapon()
 	// and adjust directions to hit that actor
 	if (Impact.bBlockingHit)
 	{
-		const FVector AdjustedDir = (Impact.ImpactPoint - Origin).GetSafeNormal();
+		const FVector AdjustedDir = GetLaunchDirection(Origin, Impact.ImpactPoint);
 		bool bWeaponPenetration = false;
 
 		const float DirectionDot = FVector::DotProduct(AdjustedDir, ShootDir);
@@ -64,6 +71,44 @@ void AShooterWeapon_Projectile::FireWeapon()
 	ServerFireProjectile(Origin, ShootDir);
 }
 
+FVector AShooterWeapon_Projectile::GetLaunchDirection(const FVector& Origin, const FVector& Target) const
+{
+	FShooterBallisticSolution Solution;
+	SolveLaunch(Origin, Target, Solution);
+
+	// projectile without launch speed has nothing to solve
+	const FVector Direction = Solution.LowVelocity.GetSafeNormal();
+	return Direction.IsZero() ? (Target - Origin).GetSafeNormal() : Direction;
+}
+
+FVector AShooterWeapon_Projectile::GetLeadDirection(const FVector& Origin, const FVector& Target, const FVector& TargetVelocity) const
+{
+	FShooterBallisticSolution Solution;
+	SolveLaunch(Origin, Target, Solution);
+
+	FVector AimPoint = Target;
+	for (int32 Iteration = 0; Iteration < ShooterWeaponProjectile::LeadAimIterations && Solution.bInRange; Iteration++)
+	{
+		AimPoint = Target + TargetVelocity * Solution.LowTime;
+		SolveLaunch(Origin, AimPoint, Solution);
+	}
+
+	const FVector Direction = Solution.LowVelocity.GetSafeNormal();
+	return Direction.IsZero() ? (AimPoint - Origin).GetSafeNormal() : Direction;
+}
+
+void AShooterWeapon_Projectile::SolveLaunch(const FVector& Origin, const FVector& Target, FShooterBallisticSolution& OutSolution) const
+{
+	float Speed = 0.0f;
+	float GravityZ = 0.0f;
+	if (ProjectileConfig.ProjectileClass)
+	{
+		GetDefault<AShooterProjectile>(ProjectileConfig.ProjectileClass)->GetBallisticParams(GetWorld(), Speed, GravityZ);
+	}
+
+	FShooterBallistics::Solve(Origin, Target, Speed, GravityZ, OutSolution);
+}
+
 bool AShooterWeapon_Projectile::ServerFireProjectile_Validate(FVector Origin, FVector_NetQuantizeNormal ShootDir)
 {
 	return true;
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ShooterRadarMinimapCommandlet.generated.h"
+
+class UWorld;
+class UTexture2D;
+
+/**
+ * Bakes top-down radar minimap of maps to tiled textures and UShooterRadarMinimapData, see UShooterRadarMinimapData::GetPackagePath().
+ * Level collision is rasterized by vertical traces, one per texel: shade is floor height, steep surfaces (walls) are darkened,
+ * texels with no collision are transparent.
+ *
+ * Run with: UE4Editor-Cmd ShooterWG.uproject -run=ShooterRadarMinimap -Map=/Game/Maps/Highrise [-TileResolution=256] [-TileWorldSize=4096]
+ * Several maps may be given as comma separated list.
+ */
+UCLASS()
+class UShooterRadarMinimapCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UShooterRadarMinimapCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+#if WITH_EDITOR
+	/** Bake minimap of map package MapPackageName, returns false on failure */
+	bool BakeMap(const FString& MapPackageName);
+
+	/** Load map with its sublevels and collision, nullptr if map is not found */
+	UWorld* LoadMapWorld(const FString& MapPackageName);
+
+	/*
+	 * Rasterize collision of tile into BGRA texels
+	 *
+	 * @param	TileBounds		World XY bounds of tile
+	 * @param	HeightRange		World Z range of map, texel shade is relative height in it
+	 */
+	void RasterizeTile(UWorld* World, const FBox2D& TileBounds, const FVector2D& HeightRange, TArray<FColor>& OutTexels) const;
+
+	/** Create tile texture asset and save its package, nullptr on failure */
+	UTexture2D* SaveTileTexture(const FString& PackageName, const TArray<FColor>& Texels) const;
+
+	/** Save package of Asset to disk */
+	bool SaveAssetPackage(UObject* Asset) const;
+#endif
+
+	/** Texels per tile side */
+	int32 TileResolution = 256;
+
+	/** World units per tile side */
+	float TileWorldSize = 4096.0f;
+};
@@ -34,6 +34,9 @@ class AShooterGameMode : public AGameMode
 	/** starts match warmup */
 	virtual void PostLogin(APlayerController* NewPlayer) override;
 
+	/** [server] setup of player on login and seamless travel */
+	virtual void GenericPlayerInitialization(AController* C) override;
+
 	/** Tries to spawn the player's pawn */
 	virtual void RestartPlayer(AController* NewPlayer) override;
 
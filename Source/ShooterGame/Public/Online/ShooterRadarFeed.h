@@ -0,0 +1,280 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "UI/ShooterRadarCollector.h"
+#include "UI/ShooterRadarCategories.h"
+#include "ShooterRadarFeed.generated.h"
+
+class UShooterRadarSubsystem;
+
+/** World units per radar feed X/Y position step, int16 covers +-262km */
+#define RADAR_FEED_POS_QUANTIZATION 8.0f
+/** World units per radar feed Z position step, int8 covers +-8km, enough for height indicator */
+#define RADAR_FEED_HEIGHT_QUANTIZATION 64.0f
+/** Seconds per radar feed expire time step */
+#define RADAR_FEED_TIME_QUANTIZATION 0.1f
+/** Radar feed entries limit, rest are dropped on server */
+#define RADAR_FEED_MAX_ENTRIES 512
+
+/*
+ * One radar point in radar feed, quantized for network
+ */
+struct FShooterRadarFeedEntry
+{
+	/** Position in RADAR_FEED_POS_QUANTIZATION / RADAR_FEED_HEIGHT_QUANTIZATION steps */
+	int16 X = 0;
+	int16 Y = 0;
+	int8 Z = 0;
+
+	/** Radar category id of radar point, less then RADAR_CATEGORY_MAX */
+	uint8 Category = 0;
+
+	/** Radar point stops showing at ExpireTime */
+	bool bExpires = false;
+
+	/** Radar point is drawn on radar border if out of radar range */
+	bool bShowIfOutRadarBorder = false;
+
+	/** Server world time in RADAR_FEED_TIME_QUANTIZATION steps (wrapped) radar point stops showing at, used if bExpires */
+	uint16 ExpireTime = 0;
+
+	bool operator==(const FShooterRadarFeedEntry& Other) const
+	{
+		return X == Other.X && Y == Other.Y && Z == Other.Z && Category == Other.Category
+			&& bExpires == Other.bExpires && bShowIfOutRadarBorder == Other.bShowIfOutRadarBorder
+			&& (!bExpires || ExpireTime == Other.ExpireTime);
+	}
+};
+
+/*
+ * Radar points visible to one player, built by server and replicated to owning connection only
+ */
+USTRUCT()
+struct FShooterRadarFeedSnapshot
+{
+	GENERATED_BODY()
+
+	TArray<FShooterRadarFeedEntry> Entries;
+
+	/** Compact custom serialization, 6 bytes per entry + 2 bytes for expiring ones */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	/** Bytes NetSerialize() writes, computed from entries without serializing */
+	int32 GetSerializedSize() const;
+
+	/** Used by replication to skip sending unchanged snapshot */
+	bool Identical(const FShooterRadarFeedSnapshot* Other, uint32 PortFlags) const { return Entries == Other->Entries; }
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterRadarFeedSnapshot> : public TStructOpsTypeTraitsBase2<FShooterRadarFeedSnapshot>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdentical = true,
+	};
+};
+
+/*
+ * Reveal ping of radar point with expiring category (enemies), delta replicated: item is sent only when it's added, removed or changed
+ */
+USTRUCT()
+struct FShooterRadarPingItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/** Position in RADAR_FEED_POS_QUANTIZATION / RADAR_FEED_HEIGHT_QUANTIZATION steps */
+	UPROPERTY()
+	int16 X = 0;
+	UPROPERTY()
+	int16 Y = 0;
+	UPROPERTY()
+	int8 Z = 0;
+
+	/** Radar category id of revealed radar point */
+	UPROPERTY()
+	uint8 Category = 0;
+
+	/** Server world time in RADAR_FEED_TIME_QUANTIZATION steps (wrapped) ping stops showing at */
+	UPROPERTY()
+	uint16 ExpireTime = 0;
+
+	/** [server] Revealed actor, used only as key to find ping of actor */
+	const AActor* Actor = nullptr;
+};
+
+/*
+ * Reveal pings of one radar feed
+ */
+USTRUCT()
+struct FShooterRadarPingArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FShooterRadarPingItem> Items;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FShooterRadarPingItem, FShooterRadarPingArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterRadarPingArray> : public TStructOpsTypeTraitsBase2<FShooterRadarPingArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/*
+ * Radar feed radar points of one category decoded on client, laid out same as FRadarPointRegistry for projection
+ */
+struct FRadarFeedPoints
+{
+	TArray<float> PosX;
+	TArray<float> PosY;
+	TArray<float> PosZ;
+
+	/** ERadarPointFlags bitmask for each radar point */
+	TArray<uint8> Flags;
+
+	/** Floor band of each radar point, see FRadarPointRegistry::Floors */
+	TArray<uint8> Floors;
+
+	/** Client world time radar point stops showing at, 0.0 if it's shown permanently */
+	TArray<float> ExpireTimes;
+
+	void Reset();
+
+	int32 Num() const { return Flags.Num(); }
+};
+
+/**
+ * Server authoritative radar feed of one remote player. Server builds snapshot of radar points owner can see,
+ * so radar keeps working for enemies out of owner network relevancy and client doesn't get more then it should see.
+ * Replicated to owner only, via UShooterReplicationGraphNode_RadarFeed_ForConnection at ShooterRepGraph.RadarFeed.Rate.
+ * Expiring categories (enemies) are revealed on every shot, so they go to separate Pings stream which coalesces reveals
+ * of same actor and sends only changed pings, see UpdatePings().
+ */
+UCLASS()
+class SHOOTERGAME_API AShooterRadarFeed : public AInfo
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	/*
+	 * [server] Rebuild snapshot from world radar model, called once per feed net update
+	 *
+	 * @return	true if snapshot is changed and will be sent to owner
+	 */
+	bool BuildSnapshot();
+
+	/** [client] Hide expired radar points, should be called before radar draw */
+	void UpdateFeedPoints();
+
+	/** [client] Is any snapshot recieved from server */
+	bool HasSnapshot() const { return bHasSnapshot; }
+
+	/** [client] Decoded radar points of radar category id, empty if there are no points of Category */
+	const FRadarFeedPoints& GetPoints(int32 Category) const;
+
+	/** [server] Radar feed payload sent to owner, averaged over last second */
+	float GetBytesPerSecond() const { return BytesPerSecond; }
+
+	/** [server] Number of reveal pings sent to owner (new or changed ones) */
+	uint32 GetPingsTransmitted() const { return PingsTransmitted; }
+
+	/*
+	 * Should NewPing of same actor be sent or it's coalesced with already sent SentPing
+	 *
+	 * @param	ShowTime	Ping category display time
+	 * @return	true if actor moved further then ShooterRadarFeed.PingMoveThreshold or SentPing expires in less then half of display time
+	 */
+	static bool ShouldResendPing(const FShooterRadarPingItem& SentPing, const FShooterRadarPingItem& NewPing, float ShowTime);
+
+protected:
+	/** Radar points visible to owner */
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_Snapshot)
+	FShooterRadarFeedSnapshot Snapshot;
+
+	/** Decode Snapshot to Points */
+	UFUNCTION()
+	void OnRep_Snapshot();
+
+	/** Reveal pings visible to owner */
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_Pings)
+	FShooterRadarPingArray Pings;
+
+	/** Decode Pings to expiring categories Points */
+	UFUNCTION()
+	void OnRep_Pings();
+
+	/*
+	 * Sync Pings with revealed radar points of expiring categories. Ping is dirtied only when actor is revealed first time,
+	 * moved more then ShooterRadarFeed.PingMoveThreshold or when sent ping expires in less then half of display time,
+	 * so reveals by every shot of automatic fire are coalesced. Enemies spotted by owner or its allies are pinged too.
+	 * Like snapshot entries, pings further then CullDistanceSq from ViewLocation are not sent unless shown on radar border,
+	 * and at most RADAR_FEED_MAX_ENTRIES are kept.
+	 *
+	 * @return	estimated bytes of pings changes to send
+	 */
+	int32 UpdatePings(const UShooterRadarSubsystem& RadarModel, const AController* OwnerController, const AActor* Viewer,
+		const FVector& ViewLocation, float CullDistanceSq, uint16 ServerTimeQuantized);
+
+	/*
+	 * Add or update ping of radar point Index of Category registry
+	 *
+	 * @param	TimeLeft	Seconds until ping stops showing
+	 * @return	true if ping is dirtied
+	 */
+	bool UpdatePing(const FRadarPointRegistry& Registry, int32 Index, int32 Category, float ShowTime, float TimeLeft, uint16 ServerTimeQuantized);
+
+	/** Add Registry showable radar points to Snapshot, skipping points out of CullDistance and Viewer own radar point */
+	void AddRegistryEntries(const UShooterRadarSubsystem& RadarModel, int32 Category, const AActor* Viewer,
+		const FVector& ViewLocation, float CullDistanceSq, uint16 ServerTimeQuantized);
+
+	/** [client] Current server world time in RADAR_FEED_TIME_QUANTIZATION steps */
+	uint16 GetServerTimeQuantized() const;
+
+	/** Count bytes sent to owner for BytesPerSecond */
+	void AddSentBytes(int32 NumBytes);
+
+	/*
+	 * [client] Reset decoded Points of categories with ExpiresOnShow() equal to bExpiring, sized to local radar categories.
+	 *
+	 * @return	local radar categories, nullptr if world has no radar model
+	 */
+	const FRadarCategoryTable* ResetPoints(bool bExpiring);
+
+	/** Decoded snapshot radar points per radar category id */
+	TArray<FRadarFeedPoints> Points;
+
+	/** True after first OnRep_Snapshot() or OnRep_Pings() */
+	bool bHasSnapshot = false;
+
+	/** Bytes sent since BytesWindowStartTime */
+	int32 BytesInWindow = 0;
+
+	/** World time current bytes measurement window started */
+	float BytesWindowStartTime = 0.0f;
+
+	/** Last complete measurement window result */
+	float BytesPerSecond = 0.0f;
+
+	/** Pings dirtied since feed spawn */
+	uint32 PingsTransmitted = 0;
+
+	/** [server] Revealed actors found in last UpdatePings() call, kept to avoid per build allocation */
+	TSet<const AActor*> RevealedActors;
+
+	/** [server] Snapshot entries of previous BuildSnapshot() call, swapped with Snapshot entries to reuse both allocations */
+	TArray<FShooterRadarFeedEntry> PrevSnapshotEntries;
+};
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "ShooterTypes.h"
+#include "Player/ShooterHitboxHistory.h"
 #include "ShooterCharacter.generated.h"
 
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnShooterCharacterEquipWeapon, AShooterCharacter*, AShooterWeapon* /* new */);
@@ -20,6 +21,9 @@ protected:
 
 	virtual void BeginPlay() override;
 
+	/** [server] stop recording hitbox history */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 
 	virtual void BeginDestroy() override;
@@ -281,11 +285,27 @@ public:
 
 	/** Update the team color of all player meshes. */
 	void UpdateTeamColorsAllMIDs();
+
+	/**
+	* [server] record current pose of 3rd person mesh into hitbox history
+	*
+	* @param	NumFrames	Frames history keeps
+	*/
+	void RecordHitboxes(float Time, int32 NumFrames);
+
+	/** [server] get hitbox history client hits are validated against */
+	const FShooterHitboxHistory& GetHitboxHistory() const { return HitboxHistory; }
 private:
 
 	/** pawn mesh: 1st person view */
 	UPROPERTY(VisibleDefaultsOnly, Category = Mesh)
 	USkeletalMeshComponent* Mesh1P;
+
+	/** [server] hitboxes recorded by UShooterHitValidation while character is in play */
+	FShooterHitboxHistory HitboxHistory;
+
+	/** [server] is character registered for hitbox recording, its 3rd person mesh then always refreshes bones */
+	bool bRecordsHitboxes = false;
 protected:
 
 	/** socket or bone name for attaching weapon mesh */
@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShooterRingBuffer.h"
+
+class USkeletalMeshComponent;
+
+DECLARE_STATS_GROUP(TEXT("ShooterHitValidation"), STATGROUP_ShooterHitValidation, STATCAT_Advanced);
+
+/*
+ * Box around one physics body of character, in space of the bone it follows
+ */
+struct FShooterHitbox
+{
+	/** Bone of mesh, INDEX_NONE follows mesh component */
+	int32 BoneIndex;
+
+	FVector Center;
+	FVector Extent;
+};
+
+/*
+ * World transform of hitbox bone at one recorded time
+ */
+struct FShooterHitboxTransform
+{
+	FQuat Rotation;
+	FVector Location;
+};
+
+/*
+ * Server history of character hitboxes, recorded at fixed rate so client hits can be checked against
+ * the pose client saw when it fired instead of current one.
+ * Frames are kept in ring buffer, and their poses in one array allocated when window is set,
+ * so memory is bounded by window and recording never allocates.
+ */
+class SHOOTERGAME_API FShooterHitboxHistory
+{
+public:
+	/** Most frames history can keep, whatever window and record rate are */
+	static constexpr int32 MaxFrames = 128;
+
+	/** Set hitboxes recorded, clears history */
+	void SetHitboxes(TArrayView<const FShooterHitbox> InHitboxes);
+
+	/** Set hitboxes from physics asset bodies of Mesh, or one box of mesh bounds if it has no physics asset. Clears history */
+	void SetHitboxesFromMesh(const USkeletalMeshComponent& Mesh);
+
+	/*
+	 * Set frames kept, clears history if it changes
+	 *
+	 * @param	InNumFrames	Clamped to [2, MaxFrames]
+	 */
+	void SetNumFrames(int32 InNumFrames);
+
+	/** Add frame recorded at Time, overwriting oldest if history is full. Returns its transforms to fill, parallel to hitboxes */
+	TArrayView<FShooterHitboxTransform> AddFrame(float Time);
+
+	/** Add frame with current bone transforms of Mesh */
+	void RecordMesh(float Time, const USkeletalMeshComponent& Mesh);
+
+	/** Remove all frames, keeps hitboxes and memory */
+	void Reset();
+
+	/*
+	 * Hitbox transforms at Time, interpolated between recorded frames. Time out of history is clamped to oldest or newest frame.
+	 *
+	 * @param	OutPose	Parallel to hitboxes
+	 * @return	false if nothing is recorded
+	 */
+	bool Rewind(float Time, TArray<FShooterHitboxTransform>& OutPose) const;
+
+	/** Is Location inside any hitbox of Pose grown by Leeway */
+	bool IsInPose(TArrayView<const FShooterHitboxTransform> Pose, const FVector& Location, float Leeway) const;
+
+	/*
+	 * Is Location inside any hitbox grown by Leeway at Time, without building whole pose
+	 *
+	 * @return	false if nothing is recorded
+	 */
+	bool ValidateHit(float Time, const FVector& Location, float Leeway) const;
+
+	bool IsEmpty() const { return Frames.IsEmpty(); }
+	int32 GetNumFrames() const { return Frames.Num(); }
+	int32 GetNumHitboxes() const { return Hitboxes.Num(); }
+	float GetOldestTime() const { return Frames[0].Time; }
+	float GetNewestTime() const { return Frames[Frames.Num() - 1].Time; }
+
+	/** Bytes of hitboxes and poses */
+	SIZE_T GetAllocatedSize() const { return Hitboxes.GetAllocatedSize() + Poses.GetAllocatedSize(); }
+
+private:
+	/** Recorded frame, its pose is Hitboxes.Num() transforms in Poses starting at PoseIndex */
+	struct FFrame
+	{
+		float Time;
+		int32 PoseIndex;
+	};
+
+	TArray<FShooterHitbox> Hitboxes;
+
+	TShooterRingBuffer<FFrame, MaxFrames> Frames;
+
+	/** Poses of all frames, slots are reused in the same order frames are */
+	TArray<FShooterHitboxTransform> Poses;
+
+	/** Pose slot of next recorded frame */
+	int32 NextPoseSlot = 0;
+
+	/** Frames kept, set by SetNumFrames() */
+	int32 NumFrames = 2;
+
+	/** Find frames around Time and blend weight between them */
+	void FindFrames(float Time, int32& OutFrom, int32& OutTo, float& OutAlpha) const;
+
+	/** Transform of Hitbox blended between two frames */
+	FShooterHitboxTransform BlendTransform(int32 Hitbox, const FFrame& From, const FFrame& To, float Alpha) const;
+
+	/** Is Location inside Hitbox at Transform grown by Leeway */
+	bool IsInHitbox(const FShooterHitbox& Hitbox, const FShooterHitboxTransform& Transform, const FVector& Location, float Leeway) const;
+
+	/** Allocate poses for frames and hitboxes, clears history */
+	void AllocatePoses();
+};
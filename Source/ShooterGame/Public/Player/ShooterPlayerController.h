@@ -7,6 +7,7 @@
 #include "ShooterPlayerController.generated.h"
 
 class AShooterHUD;
+class AShooterRadarFeed;
 
 UCLASS(config=Game)
 class AShooterPlayerController : public APlayerController
@@ -190,6 +191,12 @@ public:
 	/** Associate a new UPlayer with this PlayerController. */
 	virtual void SetPlayer(UPlayer* Player);
 
+	/** [server] spawn radar feed for remote player if it has none in this world, listen server host draws radar from world radar model directly */
+	void InitRadarFeed();
+
+	/** get radar feed replicated to this player, nullptr for local players on server */
+	AShooterRadarFeed* GetRadarFeed() const { return RadarFeed; }
+
 	// end AShooterPlayerController-specific
 
 	virtual void PreClientTravel(const FString& PendingURL, ETravelType TravelType, bool bIsSeamlessTravel) override;
@@ -212,6 +219,10 @@ protected:
 	UPROPERTY(Transient)
 	uint8 bGodMode : 1;
 
+	/** server authoritative radar points of this player */
+	UPROPERTY(Transient, Replicated)
+	AShooterRadarFeed* RadarFeed;
+
 	/** should produce force feedback? */
 	uint8 bIsVibrationEnabled : 1;
 
@@ -235,6 +246,9 @@ protected:
 
 	virtual void BeginDestroy() override;
 
+	/** destroy owned radar feed */
+	virtual void Destroyed() override;
+
 	//Begin AActor interface
 
 	/** after all game elements are created */
@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * Fixed capacity ring buffer with inline storage, never allocates. Adding to full buffer overwrites oldest element.
+ * Runtime capacity can be set up to MaxCapacity, so users can tune it without changing storage type.
+ * Elements are indexed and iterated from oldest to newest.
+ */
+template<typename ElementType, int32 MaxCapacity>
+class TShooterRingBuffer
+{
+	static_assert(MaxCapacity > 0, "Ring buffer capacity should be positive");
+
+public:
+	/** Iterator over live elements, oldest first */
+	template<typename BufferType, typename RefType>
+	class TIterator
+	{
+	public:
+		TIterator(BufferType& InBuffer, int32 InIndex) : Buffer(InBuffer), Index(InIndex) {}
+
+		RefType operator*() const { return Buffer[Index]; }
+		TIterator& operator++() { ++Index; return *this; }
+		bool operator!=(const TIterator& Other) const { return Index != Other.Index; }
+
+	private:
+		BufferType& Buffer;
+		int32 Index;
+	};
+
+	using FIterator = TIterator<TShooterRingBuffer, ElementType&>;
+	using FConstIterator = TIterator<const TShooterRingBuffer, const ElementType&>;
+
+	/*
+	 * Set number of elements kept, drops oldest elements if buffer has more
+	 *
+	 * @param	InCapacity	Clamped to [1, MaxCapacity]
+	 */
+	void SetCapacity(int32 InCapacity)
+	{
+		InCapacity = FMath::Clamp(InCapacity, 1, MaxCapacity);
+		if (InCapacity == Capacity)
+		{
+			return;
+		}
+
+		// re-pack live elements to storage start, capacity change is rare
+		const int32 NumKept = FMath::Min(NumElements, InCapacity);
+		ElementType Kept[MaxCapacity];
+		for (int32 i = 0; i < NumKept; i++)
+		{
+			Kept[i] = MoveTemp((*this)[NumElements - NumKept + i]);
+		}
+		for (int32 i = 0; i < NumKept; i++)
+		{
+			Elements[i] = MoveTemp(Kept[i]);
+		}
+
+		Capacity = InCapacity;
+		Head = 0;
+		NumElements = NumKept;
+	}
+
+	/** Add element as newest one, overwrites oldest element if buffer is full */
+	ElementType& Add(const ElementType& Element)
+	{
+		int32 Slot;
+		if (NumElements < Capacity)
+		{
+			Slot = (Head + NumElements) % Capacity;
+			NumElements++;
+		}
+		else
+		{
+			Slot = Head;
+			Head = (Head + 1) % Capacity;
+		}
+
+		Elements[Slot] = Element;
+		return Elements[Slot];
+	}
+
+	/** Remove Count oldest elements */
+	void PopOldest(int32 Count = 1)
+	{
+		check(Count >= 0 && Count <= NumElements);
+		Head = (Head + Count) % Capacity;
+		NumElements -= Count;
+	}
+
+	/** Remove all elements, capacity is kept */
+	void Reset()
+	{
+		Head = 0;
+		NumElements = 0;
+	}
+
+	/** Element at Index, 0 is oldest */
+	ElementType& operator[](int32 Index)
+	{
+		checkSlow(Index >= 0 && Index < NumElements);
+		return Elements[(Head + Index) % Capacity];
+	}
+
+	const ElementType& operator[](int32 Index) const
+	{
+		checkSlow(Index >= 0 && Index < NumElements);
+		return Elements[(Head + Index) % Capacity];
+	}
+
+	ElementType& Oldest() { return (*this)[0]; }
+	ElementType& Newest() { return (*this)[NumElements - 1]; }
+
+	int32 Num() const { return NumElements; }
+	int32 GetCapacity() const { return Capacity; }
+	bool IsEmpty() const { return NumElements == 0; }
+	bool IsFull() const { return NumElements == Capacity; }
+
+	FIterator begin() { return FIterator(*this, 0); }
+	FIterator end() { return FIterator(*this, NumElements); }
+	FConstIterator begin() const { return FConstIterator(*this, 0); }
+	FConstIterator end() const { return FConstIterator(*this, NumElements); }
+
+private:
+	ElementType Elements[MaxCapacity];
+
+	/** Storage index of oldest element */
+	int32 Head = 0;
+
+	int32 NumElements = 0;
+
+	int32 Capacity = MaxCapacity;
+};
@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#pragma once
+
+#include "ShooterTestControllerBase.h"
+#include "ShooterTestControllerRadarBenchmark.generated.h"
+
+class AShooterHUD;
+class UCanvas;
+class UTextureRenderTarget2D;
+
+/**
+ * Headless radar cost benchmark. Hosts a Highrise FFA match with bots, spawns extra pickups around player,
+ * then drives UShooterRadarCollector::UpdateRadarTick() and AShooterHUD::DrawRadar() itself for a number of frames
+ * (HUD drawing is disabled, so viewport draws nothing) and writes per frame timings and game thread allocations to CSV.
+ *
+ * Run with: -gauntlet=ShooterTestControllerRadarBenchmark -nullrhi -unattended
+ * Options:  -RadarBenchmarkBots=16 -RadarBenchmarkPickups=200 -RadarBenchmarkFrames=1000 -RadarBenchmarkCsv=<path>
+ * Summary (min/median/p99/max) goes to <csv>, per frame samples to <csv name>_Frames.csv, default Saved/Profiling/RadarBenchmark.csv
+ */
+UCLASS()
+class UShooterTestControllerRadarBenchmark : public UShooterTestControllerBase
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnInit() override;
+	virtual void OnPostMapChange(UWorld* World) override;
+
+protected:
+	/** Per frame radar cost */
+	struct FFrameSample
+	{
+		double UpdateTime;
+		double DrawTime;
+		uint64 NumAllocs;
+	};
+
+	virtual void OnTick(float TimeDelta) override;
+	virtual void OnUserCanPlayOnline(const FUniqueNetId& UserId, EUserPrivileges::Type Privilege, uint32 PrivilegeResults) override;
+	virtual void HostGame() override;
+
+	/** Spawn NumPickups health pickups around player pawn */
+	void SpawnPickups();
+
+	/** Update and draw radar once, measured */
+	void MeasureFrame(AShooterHUD* HUD);
+
+	/** Write summary and per frame CSV */
+	bool WriteResults() const;
+
+	/** Local player HUD ready to draw radar, nullptr while match is starting */
+	AShooterHUD* GetRadarHUD() const;
+
+	// Options
+	int32 NumBots;
+	int32 NumPickups;
+	int32 NumFrames;
+	int32 NumWarmupFrames;
+	float MatchStartTimeout;
+	FString CsvPath;
+
+	// State
+	uint8 bHostedGame : 1;
+	uint8 bSpawnedPickups : 1;
+	int32 NumFramesDriven;
+	float TimeWaitingForMatch;
+	TArray<FFrameSample> Samples;
+
+	/** Offscreen canvas radar is drawn to */
+	UPROPERTY()
+	UCanvas* BenchmarkCanvas;
+
+	UPROPERTY()
+	UTextureRenderTarget2D* BenchmarkRenderTarget;
+};
@@ -4,10 +4,13 @@
 
 #include "ShooterTypes.h"
 #include "ShooterRadarCollector.h"
+#include "ShooterRadarProjection.h"
+#include "ShooterRadarIconBatch.h"
+#include "ShooterRadarMinimap.h"
+#include "Online/ShooterRadarFeed.h"
 
 #include "ShooterHUD.generated.h"
 
-
 struct FHitData
 {
 	/** Last hit time. */
@@ -153,6 +156,12 @@ public:
 
 	/** On player controller possesed pawn change, change tracking character for radar collector */
 	void RadarCollectorChangeTrackedCharacter(AShooterCharacter* Character);
+
+	/** Class to recieve radar info from */
+	class UShooterRadarCollector* GetRadarCollector() const { return RadarCollector; }
+
+	/** Draw Radar Circle, Radar North Icon, RadarPoints Icons, Radar Hit Direction Indicator to Canvas, called by DrawHUD() and radar benchmark */
+	void DrawRadar();
 		
 protected:
 	/** Floor for automatic hud scaling. */
@@ -254,21 +263,9 @@ protected:
 	UPROPERTY()
 	FCanvasIcon RadarHitIcon;
 
-	/** Radar enemy icon. */
-	UPROPERTY()
-	FCanvasIcon RadarEnemyIcon;
-
-	/** Radar pickup health icon. */
+	/** Radar icon of each radar category, built from radar categories on BeginPlay. */
 	UPROPERTY()
-	FCanvasIcon RadarHealthIcon;
-
-	/** Radar pickup ammo icon. */
-	UPROPERTY()
-	FCanvasIcon RadarAmmoIcon;
-
-	/** Radar pickup granede launcher ammo icon. */
-	UPROPERTY()
-	FCanvasIcon RadarGrenadesIcon;
+	TArray<FCanvasIcon> RadarCategoryIcons;
 
 	/** Radar up icon fragment. */
 	UPROPERTY()
@@ -286,6 +283,14 @@ protected:
 	UPROPERTY(EditDefaultsOnly)
 		float RadarIconHeightIndicatorTreshold;
 
+	/** How many radar hit markers can be shown at once, up to RADAR_HIT_MARKER_MAX_CAPACITY **/
+	UPROPERTY(EditDefaultsOnly)
+		int32 RadarHitMarkerCapacity;
+
+	/** Hits in one frame closer then this angle (degrees) are shown as one radar hit marker **/
+	UPROPERTY(EditDefaultsOnly)
+		float RadarHitMarkerAggregateAngle;
+
 	/** Radar booster icon. */
 
 	/** UI scaling factor for other resolutions than Full HD. */
@@ -418,25 +423,53 @@ protected:
 	/**
 	 * Draw RadarPoints Icons recieved from RadarCollector.
 
-	 * @param	RadarPoints				Recieved RadarPoints Map from RadarCollector.
-	 * @param	RadarWorldCenter		Actual Radar Center In World (Usually this is HUD Owned Player).
-	 * @param	RadarCenter				RadarCenter on HUD Screen Space (should be scaled).
-	 * @param	RadarRadius				RadarCircleIcon Radius (should be scaled).
-	 * @param	RadarRotRadians			Radar Rotation from X World Axis
+	 * @param	RadarPoints				Recieved RadarPoints registry from RadarCollector.
+	 * @param	ProjectionParams		Radar world to HUD space transform.
 	 * @param	Icon					RadarPoint Icon to draw.
 	 * @param	bShowHeightIndicator	Draws "Higher", "Lower" icons on top of Icon when Points Z axis is higher then RadarIconHeightIndicatorTreshold
 	 * @param	HeightIndicatorOffset	"Higher", "Lower" icons positive offset
 	 * @param	bHeightIndOffsetUseNegY	If true then HeightIndicatorOffset.Y for "Lower" will be -(HightIndicatorOffset.Y)
 	 *                                  and for "Higher" will ramain HeightIndicatorOffset.Y
+	 * @param	ExcludedPointIndex		RadarPoint index not to draw (viewer own radar point), INDEX_NONE to draw all
 	 */
-	void DrawRadarCollectorPoints(TArray<FRadarPoint> &RadarPoints, 
-		FVector RadarWorldCenter, FVector2D RadarCenter, float RadarRadius, float RadarRotRadians,
+	void DrawRadarCollectorPoints(const FRadarPointRegistry& RadarPoints, const FRadarProjectionParams& ProjectionParams,
 		FCanvasIcon &Icon, 
 		bool bShowHeightIndicator = false, FVector2D HeightIndicatorOffset = FVector2D::ZeroVector, 
+		bool bHeightIndOffsetUseNegY = false, int32 ExcludedPointIndex = INDEX_NONE);
+
+	/** Same as above for radar points recieved from server radar feed, server already excluded viewer own radar point */
+	void DrawRadarCollectorPoints(const FRadarFeedPoints& RadarPoints, const FRadarProjectionParams& ProjectionParams,
+		FCanvasIcon &Icon,
+		bool bShowHeightIndicator = false, FVector2D HeightIndicatorOffset = FVector2D::ZeroVector,
 		bool bHeightIndOffsetUseNegY = false);
 
-	/** Draw Radar Circle, Radar North Icon, RadarPoints Icons, Radar Hit Direction Indicator */
-	void DrawRadar();
+	/** Draw projected RadarDrawList icons, see DrawRadarCollectorPoints() for params */
+	void DrawRadarDrawList(FCanvasIcon &Icon, bool bShowHeightIndicator, FVector2D HeightIndicatorOffset,
+		bool bHeightIndOffsetUseNegY, int32 ExcludedPointIndex);
+
+	/** Draw HUDRadarTexture icon, added to RadarIconBatch if radar batched draw is enabled */
+	void DrawRadarIcon(FCanvasIcon& Icon, float X, float Y);
+
+	/** Same as DrawCanvasIconWithRot() for HUDRadarTexture icon, added to RadarIconBatch if radar batched draw is enabled */
+	void DrawRadarIconWithRot(FCanvasIcon& Icon, float X, float Y, float RotationDeg, FVector2D Pivot);
+
+	/** Submit radar icons collected in RadarIconBatch */
+	void FlushRadarIcons();
+
+	/** Radar icons collected during DrawRadar(), submitted as one canvas item */
+	FRadarIconBatch RadarIconBatch;
+
+	/** Projected radar points of currently drawn category, reused between draw calls */
+	TArray<FRadarDrawItem> RadarDrawList;
+
+	/** Buffers for culled radar points projection, reused between draw calls */
+	FRadarProjectionScratch RadarProjectionScratch;
+
+	/** Spotted radar points of currently drawn category, reused between draw calls */
+	FRadarFeedPoints RadarSpottedPoints;
+
+	/** Baked minimap drawn inside radar circle, tiles are streamed around player */
+	FRadarMinimap RadarMinimap;
 
 	/** Class to recieve radar info from */
 	UPROPERTY()
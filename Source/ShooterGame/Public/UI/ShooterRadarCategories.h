@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Templates/SubclassOf.h"
+#include "ShooterRadarCollector.h"
+#include "ShooterRadarFloors.h"
+#include "ShooterRadarCategories.generated.h"
+
+class AShooterWeapon;
+
+/** Radar categories limit, radar feed sends category id in 6 bits */
+#define RADAR_CATEGORY_MAX 64
+
+/** Where HUD radar draws "Higher"/"Lower" fragments of category icon */
+UENUM()
+enum class ERadarHeightIndicator : uint8
+{
+	/** No height indicator */
+	None,
+	/** Fragments are drawn above icon, fits static icons like pickups */
+	AboveIcon,
+	/** Fragments are drawn over icon center, fits moving icons like characters */
+	OverIcon,
+};
+
+/*
+ * One radar category: which actors go to it, how their radar points are shown and drawn
+ */
+USTRUCT()
+struct FRadarCategoryDef
+{
+	GENERATED_BODY()
+
+	/** Category name, for logs and debug */
+	UPROPERTY()
+	FName Name;
+
+	/** Actors of this class or its subclasses go to category */
+	UPROPERTY()
+	TSubclassOf<AActor> ActorClass;
+
+	/** If set, only ammo pickups giving ammo for this weapon class go to category */
+	UPROPERTY()
+	TSubclassOf<AShooterWeapon> AmmoWeaponClass;
+
+	/** Icon top left corner in HUD radar texture */
+	UPROPERTY()
+	FIntPoint IconUV = FIntPoint::ZeroValue;
+
+	/** Icon size in HUD radar texture */
+	UPROPERTY()
+	FIntPoint IconSize = FIntPoint(16, 16);
+
+	/** "Higher"/"Lower" fragments placement */
+	UPROPERTY()
+	ERadarHeightIndicator HeightIndicator = ERadarHeightIndicator::AboveIcon;
+
+	/** Radar point is drawn on radar border if it's out of radar range */
+	UPROPERTY()
+	bool bShowIfOutRadarBorder = false;
+
+	/** Radar point position is sampled only when it's shown, so radar doesn't track actor between reveals */
+	UPROPERTY()
+	bool bUpdatePosOnShowOnly = false;
+
+	/** Actor never moves, position is sampled once and radar points are culled by spatial grid */
+	UPROPERTY()
+	bool bStaticPosition = false;
+
+	/** Seconds radar point is drawn after it's shown, 0.0 to draw it permanently */
+	UPROPERTY()
+	float ShowTime = 0.0f;
+
+	/** Radar points of category are hidden again after ShowTime, radar feed sends them as reveal pings */
+	bool ExpiresOnShow() const { return ShowTime > 0.0f; }
+
+	/** Radar point defaults for actors of category */
+	FRadarPoint MakePointTemplate() const;
+
+	/** Do Class objects go to this category, Class should not be nullptr */
+	bool Matches(UClass* Class) const;
+};
+
+/*
+ * Category table shared by radar model, radar feed and HUD. Category id is index in table,
+ * it's also the draw order. Actor goes to first category it matches, resolved once per class and cached,
+ * so per event routing is one map lookup regardless of categories count.
+ */
+struct SHOOTERGAME_API FRadarCategoryTable
+{
+	/** Set categories, drops resolved classes cache. Categories over RADAR_CATEGORY_MAX are ignored */
+	void Init(const TArray<FRadarCategoryDef>& InCategories);
+
+	/*
+	 * Get category id of Class
+	 *
+	 * @param	Class	Actor class, may be nullptr
+	 * @return	INDEX_NONE if Class is nullptr or doesn't match any category, else category id
+	 */
+	int32 FindCategory(UClass* Class) const;
+
+	/** Get category of valid category id */
+	const FRadarCategoryDef& GetCategory(int32 Category) const { return Categories[Category]; }
+
+	/** Is Category valid category id */
+	bool IsValidCategory(int32 Category) const { return Categories.IsValidIndex(Category); }
+
+	/** Number of classes resolved so far */
+	int32 NumResolvedClasses() const { return ClassToCategory.Num(); }
+
+	int32 Num() const { return Categories.Num(); }
+
+private:
+	TArray<FRadarCategoryDef> Categories;
+
+	/** Class -> category id or INDEX_NONE. Classes are not unloaded while world using table is alive */
+	mutable TMap<const UClass*, int32> ClassToCategory;
+};
+
+/**
+ * Radar categories config, see [/Script/ShooterGame.ShooterRadarSettings] in DefaultGame.ini.
+ * Game modes add own radar categories there, no code changes needed.
+ */
+UCLASS(config=Game)
+class SHOOTERGAME_API UShooterRadarSettings : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Radar categories in draw order, actor goes to first category it matches */
+	UPROPERTY(config)
+	TArray<FRadarCategoryDef> Categories;
+
+	/** Floor heights of multi-storey maps, radar shows floor instead of height difference there. Also see RADAR_FLOOR_TAG */
+	UPROPERTY(config)
+	TArray<FRadarMapFloors> MapFloors;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "ShooterRingBuffer.h"
 #include "ShooterRadarCollector.generated.h"
 
 class AActor;
@@ -13,139 +14,334 @@ class AShooterPickup;
 class AController;
 class UDamageType;
 class UPrimitiveComponent;
+class UShooterRadarSubsystem;
+struct FRadarFloorBands;
 
 #define MAX_PLAYER_NAME_LENGTH 16
-#define RADAR_ENEMY_DISPLAY_TIME 1.0f
 #define RADAR_HIT_MARKER_DISPLAY_TIME 1.0f
 #define RADAR_HIT_MARKER_MAX 5
+#define RADAR_HIT_MARKER_MAX_CAPACITY 16
+#define RADAR_HIT_MARKER_AGGREGATE_ANGLE 5.0f
+
+DECLARE_STATS_GROUP(TEXT("ShooterRadar"), STATGROUP_ShooterRadar, STATCAT_Advanced);
+
+namespace ERadarPointFlags
+{
+	enum Type : uint8
+	{
+		None = 0,
+		/** Should HUD Radar draw this radar point on next draw call */
+		CanShow = 1 << 0,
+		/** Should HUD Radar draw this radar point on radar border if it's out of radar range radius */
+		CanShowIfOutRadarBorder = 1 << 1,
+		/** Should displayed actor position update on ShowTime reset or every draw call */
+		UpdatePosOnShowOnly = 1 << 2,
+		/** Flag value to handle logic based on UpdatePosOnShowOnly */
+		PosUpdateIsBlocked = 1 << 3,
+		/** Actor never moves, position is sampled once on registration */
+		StaticPosition = 1 << 4,
+		/** Actor position is sampled every update, displayed position is interpolated between two last samples */
+		Interpolated = 1 << 5,
+		/** Radar point slot is unused and kept in free list for reuse, has no actor */
+		FreeSlot = 1 << 6,
+	};
+}
 
 /*
- * HUD radar actor point to display information container
+ * Shooter characters positions gathered once per radar update,
+ * so radar points don't each re-read actor transforms
+ */
+struct FRadarPositionSnapshot
+{
+	/** Gather positions of all shooter characters in World */
+	void Gather(UWorld* World);
+
+	/** Get snapshot position of Actor, nullptr if Actor is not in snapshot */
+	const FVector* Find(const AActor* Actor) const { return Positions.Find(Actor); }
+
+private:
+	/** Actor -> actor location at gather time */
+	TMap<const AActor*, FVector> Positions;
+};
+
+/*
+ * HUD radar point default settings, applied to radar point on actor registration
  */
-USTRUCT()
 struct FRadarPoint
+{
+	/** ERadarPointFlags radar point starts with */
+	uint8 Flags = ERadarPointFlags::None;
+
+	/** Amount of time to draw radar point. If 0.0 it's will be draw permanently */
+	float ShowTimeMax = 0.0f;
+};
+
+/*
+ * Radar point slot reference kept across registry updates, slot generation changes when slot is freed,
+ * so handle of removed radar point doesn't resolve to radar point reusing its slot
+ */
+struct FRadarPointHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool IsSet() const { return Index != INDEX_NONE; }
+};
+
+/*
+ * Radar points storage, kept as structure of arrays so HUD can project whole category in one pass.
+ * Radar points live in pooled slots: removed radar point slot goes to free list and is reused by next added radar point,
+ * so arrays never shrink and spawn/death churn doesn't allocate after warm-up. Radar point index is stable while it's registered.
+ * Free slots have nullptr actor and no CanShow flag, so passes over all slots skip them same as hidden radar points.
+ */
+USTRUCT()
+struct FRadarPointRegistry
 {
 	GENERATED_BODY()
 
-	/** Actor to display on radar */
+	/** Actor to display on radar for each radar point */
 	UPROPERTY()
-	AActor* Actor = nullptr;
+	TArray<AActor*> Actors;
+
+	/** Displayed actor last location, split by axis */
+	TArray<float> PosX;
+	TArray<float> PosY;
+	TArray<float> PosZ;
+
+	/** Time elapsed when radar point is been draw */
+	TArray<float> ShowTimes;
+	/** Amount of time to draw radar point. If 0.0 it's will be draw permanently */
+	TArray<float> ShowTimeMaxes;
+
+	/** ERadarPointFlags bitmask for each radar point */
+	TArray<uint8> Flags;
+
+	/** Two last position samples of Interpolated radar points, displayed location is blended between them */
+	TArray<FVector> PrevSamples;
+	TArray<FVector> NextSamples;
+
+	/** Floor band of displayed location, bucketed whenever position changes. 0 if registry has no floor bands */
+	TArray<uint8> Floors;
+
+	/** Slot generation, incremented every time slot is freed */
+	TArray<uint32> Generations;
 
-	/** Should HUD Radar draw this radar point on next draw call */
-	bool bCanShow = false;
-	/** Should HUD Radar draw this radar point on radar border if it's out of radar range radius */
-	bool bCanShowIfOutRadarBorder = false;  // logic for this should be handled externally
+	/*
+	 * Get index of radar point registered for Actor
+	 *
+	 * @param	Actor	Actor ptr to find radar point for
+	 * @return	INDEX_NONE if Actor is nullptr, not registered or radar point is pending remove, else radar point index
+	 */
+	int32 Find(const AActor* Actor) const;
+
+	/*
+	 * Register radar point for Actor if it's not registered yet
+	 *
+	 * @param	Actor			Actor to register, should be valid
+	 * @param	PointTemplate	Radar point default values for new radar point
+	 * @param	bOutAdded		true if new radar point was added, false if Actor is already registered
+	 * @return	radar point index registered for Actor
+	 */
+	int32 FindOrAdd(AActor* Actor, const FRadarPoint& PointTemplate, bool& bOutAdded);
+
+	/** Get handle of radar point at Index to keep across updates */
+	FRadarPointHandle GetHandle(int32 Index) const { return FRadarPointHandle{ Index, Generations[Index] }; }
+
+	/*
+	 * Get index of radar point Handle was taken from
+	 *
+	 * @return	INDEX_NONE if radar point is removed or pending remove, its slot may be reused by other radar point
+	 */
+	int32 Find(const FRadarPointHandle& Handle) const;
+
+	/** Unregister Actor, radar point is pending to be removed in next Update() call */
+	void Remove(const AActor* Actor);
+
+	/** Handling Show/Hide Logic for radar point. Result is updated CanShow flag */
+	void Show(int32 Index, bool bShowOnRadar);
 
-	/** Should displayed actor position update on ShowTime reset or every draw call */
-	bool bUpdatePosOnShowOnly = false;
-	/** Flag value to handle logic based on bUpdatePosOnTimerOnly */
-	bool bPosUpdateIsBlocked = false;
+	/** Is radar point CanShow flag set */
+	bool CanShow(int32 Index) const { return (Flags[Index] & ERadarPointFlags::CanShow) != 0; }
 
 	/** Displayed actor last location */
-	FVector LastPos = FVector::ZeroVector;
-	/** Time elapsed when radar point is been draw */
-	float ShowTime = 0.0f;
+	FVector GetPosition(int32 Index) const { return FVector(PosX[Index], PosY[Index], PosZ[Index]); }
 
-	/** Amount of time to draw radar point. If 0.0 it's will be draw permanently */
-	float ShowTimeMax = 0.0f;
+	/** Override displayed location of radar point, interpolation snaps to it */
+	void SetPosition(int32 Index, const FVector& Position);
 
-	/** Check if RadarPoint is valid */
-	bool IsRadarPointValid()
-	{
-		return IsValid(Actor);
-	}
+	/*
+	 * Set radar point state recorded earlier, position is sampled again from actor on next Update()
+	 *
+	 * @param	InFlags		ERadarPointFlags to restore
+	 * @param	ShowTime	Time elapsed since radar point was shown or hidden
+	 */
+	void Restore(int32 Index, uint8 InFlags, float ShowTime);
 
 	/*
-	 * Update RadarPoint Timer and handle logic on it 
+	 * Set floor bands radar points are bucketed to, radar points floors are updated immediately
 	 *
-	 * @param	DeltaTime	Time since last update
-	 * @return	if RadarPoint is valid and update success, false is RadarPoint is invalid and update fails
+	 * @param	InFloorBands	Floor bands, should outlive registry. nullptr puts all radar points to floor 0
 	 */
-	bool Update(float DeltaTime);
+	void SetFloorBands(const FRadarFloorBands* InFloorBands);
 
-	/** Handling Show/Hide Logic. Result is updated bCanShow param */
-	void Show(bool bShowOnRadar)
-	{
-		if (bShowOnRadar && bUpdatePosOnShowOnly)  // handle bUpdatePosOnShowOnly param
-		{
-			bPosUpdateIsBlocked = false;  // update pos gate open
-		}
-
-		ShowTime = 0.0f; // reset time count
-		bCanShow = bShowOnRadar;
-	}
+	/*
+	 * Enable uniform 2D grid over radar points positions, rebuilt in Update() when points are added/removed/moved.
+	 * Worth it for points which rarely move (pickups), cell size should be about radar world radius.
+	 *
+	 * @param	CellSize	grid cell size in world units, 0 disables grid
+	 */
+	void SetGridCellSize(float CellSize);
+
+	/*
+	 * Gather indices of radar points which can be visible on radar: points in grid cells overlapping radar disc
+	 * and points flagged CanShowIfOutRadarBorder.
+	 *
+	 * @param	Center		Radar world center
+	 * @param	Radius		Radar world radius
+	 * @param	OutIndices	Candidate radar points indices
+	 * @return	false if grid is disabled or out of date, OutIndices is empty then and all radar points should be considered
+	 */
+	bool GatherCandidates(const FVector& Center, float Radius, TArray<int32>& OutIndices) const;
+
+	/*
+	 * Update radar points timers and positions, remove radar points with invalid actor
+	 *
+	 * @param DeltaTime		Time since last registry update
+	 * @param Snapshot		Current frame positions, actor not found in snapshot reads own location
+	 */
+	void Update(float DeltaTime, const FRadarPositionSnapshot& Snapshot);
+
+	/*
+	 * Blend displayed location of Interpolated radar points between two last position samples,
+	 * called every frame when registry is updated at lower rate then it's drawn
+	 *
+	 * @param Alpha		0 is previous sample, 1 is last sample
+	 */
+	void Interpolate(float Alpha);
+
+	/** Remove all radar points */
+	void Reset();
+
+	/** Number of registered radar points */
+	int32 Num() const { return Actors.Num() - FreeSlots.Num(); }
+
+	/** Number of slots, radar point indices are in [0, NumSlots()) range, some of them may be free */
+	int32 NumSlots() const { return Actors.Num(); }
+
+	/** Is slot at Index unused */
+	bool IsFreeSlot(int32 Index) const { return (Flags[Index] & ERadarPointFlags::FreeSlot) != 0; }
+
+private:
+	/*
+	 * Update radar point timer and handle logic on it
+	 *
+	 * @return	true if radar point is valid and update success, false if radar point is invalid and should be removed
+	 */
+	bool UpdatePoint(int32 Index, float DeltaTime, const FRadarPositionSnapshot& Snapshot);
+
+	/** Remove radar point at Index, its slot is put to free list */
+	void FreeSlot(int32 Index);
+
+	/** Set displayed location of radar point and its floor */
+	void SetDisplayedPosition(int32 Index, const FVector& Location);
+
+	/** Rebuild GridCells from current radar points positions */
+	void RebuildGrid();
+
+	/** Actor ptr for each radar point, kept separately so index can be unregistered after Actor is gone */
+	TArray<const AActor*> PointKeys;
+
+	/** Actor -> radar point index */
+	TMap<const AActor*, int32> KeyToIndex;
+
+	/** Free slots indices, last freed slot is reused first */
+	TArray<int32> FreeSlots;
+
+	/** Floor bands displayed locations are bucketed to, nullptr if map has no floors */
+	const FRadarFloorBands* FloorBands = nullptr;
+
+	/** Grid cell size, 0 if grid is disabled */
+	float GridCellSize = 0.0f;
+
+	/** Grid doesn't match radar points anymore and should be rebuilt */
+	bool bGridDirty = true;
+
+	/** Grid cell -> (first index, count) of cell radar points in GridPointIndices */
+	TMap<FIntPoint, FIntPoint> GridCells;
+
+	/** Radar points indices sorted by grid cell */
+	TArray<int32> GridPointIndices;
+
+	/** Radar points flagged CanShowIfOutRadarBorder, always candidates so not stored in cells */
+	TArray<int32> OutOfBorderIndices;
+
+	/** (packed cell, radar point index) scratch of RebuildGrid() */
+	TArray<TPair<int64, int32>> GridCellPoints;
+};
+
+/*
+ * Radar hit marker, hit direction shown on radar circle for RADAR_HIT_MARKER_DISPLAY_TIME
+ */
+struct FRadarHitMarker
+{
+	/** Normalized 2D direction hit came from */
+	FVector2D Direction = FVector2D::ZeroVector;
+
+	/** Time elapsed since hit marker was added */
+	float ShowTime = 0.0f;
+
+	/** Number of hits aggregated in this hit marker */
+	int32 NumHits = 0;
 };
 
 /*
- * Struct to hold and provide information on radar about recent player hits recieved
+ * Struct to hold and provide information on radar about recent player hits recieved.
+ * Hit markers are kept in fixed ring buffer, oldest first, so they expire from the front and no memory is allocated.
  */
 struct FRadarHitMarkerData
 {
-	/** current HitFromDirections/HitMarkerShowTimes index */
-	uint32 Index = 0;
-	
-	/** array to store last N hit direction vectors */
-	FVector HitFromDirections[RADAR_HIT_MARKER_MAX] = {FVector::ZeroVector};
-	/** array to store show time for last N hit direction vectors in HitFromDirections array */
-	float HitMarkerShowTimes[RADAR_HIT_MARKER_MAX] = {-1.0f};
+	typedef TShooterRingBuffer<FRadarHitMarker, RADAR_HIT_MARKER_MAX_CAPACITY> FHitMarkers;
+
+	/** Live hit markers to draw, oldest first */
+	const FHitMarkers& GetHitMarkers() const { return HitMarkers; }
 
 	/*
-	 *  Get valid hit directions we can draw (valid when time to show is not -1.0f) 
+	 * Set how many hit markers are kept and how close hit directions are aggregated
 	 *
-	 * @param	OutHitFromDirections	array to add relevant hit directions to
+	 * @param	Capacity				Hit markers kept, up to RADAR_HIT_MARKER_MAX_CAPACITY
+	 * @param	AggregateAngleDeg		Hits added between two Update() calls with directions closer then this share hit marker
 	 */
-	void GetRelevantHitFromDirections(TArray<FVector> &OutHitFromDirections)
-	{
-		for (uint32 i = 0; i < RADAR_HIT_MARKER_MAX; i++)
-		{
-			if (HitMarkerShowTimes[i] == -1.0f || HitFromDirections[i] == FVector::ZeroVector)
-			{
-				continue;
-			}
-			OutHitFromDirections.Add(HitFromDirections[i]);
-		}
-	}
+	void Configure(int32 Capacity, float AggregateAngleDeg);
 
 	/*
-	 * Change hit direction vector for the very last updated hit direction array position 
+	 * Add hit marker, or aggregate hit with hit marker added since last Update() if directions are near-identical
+	 * (shotgun pellets, explosion), so burst of hits doesn't push out all other hit markers.
 	 *
-	 * @param HitFromDirection	hit direction to add
+	 * @param HitFromDirection	hit direction to add, ignored if it has no 2D component
 	 */
-	void AddHitDirection(FVector HitFromDirection)
-	{
-		HitFromDirections[Index] = HitFromDirection;
-		HitMarkerShowTimes[Index] = 0.0f;
-
-		Index = (Index + 1) % RADAR_HIT_MARKER_MAX;
-	}
+	void AddHitDirection(const FVector& HitFromDirection);
 
 	/* 
-	 * Calculate new HitMarkerShowTime for each hit direction in HitFromDirections array
+	 * Advance hit markers show time and remove expired ones
 	 *
 	 * @param DeltaTime time since last RadarHitMarkerData update
 	 */
-	void Update(float DeltaTime)
-	{
-		for (float& HitMarkerShowTime : HitMarkerShowTimes)
-		{
-			if (HitMarkerShowTime == -1.0f)
-			{
-				continue;
-			}
-
-			HitMarkerShowTime += DeltaTime;
-
-			if (HitMarkerShowTime >= RADAR_HIT_MARKER_DISPLAY_TIME)
-			{
-				HitMarkerShowTime = -1.0f;
-			}
-		}
-	}
+	void Update(float DeltaTime);
+
+private:
+	FHitMarkers HitMarkers;
+
+	/** Number of newest hit markers added since last Update(), aggregation candidates */
+	int32 NumAddedSinceUpdate = 0;
+
+	/** Cos of max angle between aggregated hit directions */
+	float AggregateAngleCos = FMath::Cos(FMath::DegreesToRadians(RADAR_HIT_MARKER_AGGREGATE_ANGLE));
 };
 
 /**
- * This Class is collect's and provide Radar Info for ShooterHUD
- * Kinda MVC, FRadarPoint, FRadarHitMarkerData - model, UShooterRadarCollector - controller, AShooterHUD - view
+ * Per-viewer radar view for ShooterHUD. Radar entities are shared by all viewers in UShooterRadarSubsystem,
+ * view keeps only viewer specific state: tracked character and hit markers.
+ * Kinda MVC, UShooterRadarSubsystem, FRadarHitMarkerData - model, UShooterRadarCollector - controller, AShooterHUD - view
  */
 UCLASS()
 class SHOOTERGAME_API UShooterRadarCollector : public UObject
@@ -153,86 +349,19 @@ class SHOOTERGAME_API UShooterRadarCollector : public UObject
 	GENERATED_BODY()
 
 public:
-	UShooterRadarCollector();
-
-	virtual void BeginDestroy() override final;
-
-	/** Enemies array */
-	UPROPERTY()
-	TArray<FRadarPoint> Enemies;
-
-	/** Health pickups array */
-	UPROPERTY()
-	TArray<FRadarPoint> HealthPickups;
-
-	/** Ammo pickups array */
-	UPROPERTY()
-	TArray<FRadarPoint> AmmoPickups;
-
-	/** Grenade launcher ammo pickups array */
-	UPROPERTY()
-	TArray<FRadarPoint> GrenadesPickups;
-
 	/** Radar hit marker data */
 	FRadarHitMarkerData RadarHitMarkerData;
 
-protected:
-
-	/** Add enemy radar point to Enemies map */
-	void AddEnemy(AShooterCharacter* Enemy);
-	/** Remove enemy radar point from Enemies map */
-	void RemoveEnemy(AShooterCharacter* Enemy);
-	/** Call Show(true) for enemy radar point if found in Enemies map */
-	void ShowEnemy(AShooterCharacter* Enemy);
+	/** Get shared radar entities model of collector world, nullptr if there is no one */
+	UShooterRadarSubsystem* GetRadarModel() const;
 
-	/** Get proper pickup array depends on Pickup actual final class */
-	TArray<FRadarPoint>* GetProperPickupArr(AShooterPickup* Pickup);
-	/** Show pickup radar point, add pickup to Pickups map if not found in map*/
-	void AddPickup(AShooterPickup* Pickup);
-	/** Hide pickup radar point*/
-	void RemovePickup(AShooterPickup* Pickup);
-
-	/*
-	* Traverse RadarPointArr and try to get array index of RadarPoint with selected Actor value.
-	*
-	* @param RadarPointArr	RadarPoint array where to find if selected actor is in RadarPoint struct.
-	* @param Actor			Actor ptr to find in RadarPoint struct
-	*
-	* @returns				-1 if actor not found in any RadarPoint for selected array, 
-							or if actor is nullptr, else return RadarPoint index in array
-	*/
-	const int32 GetActorRadarPointArrIndex(TArray<FRadarPoint> &RadarPointArr, AActor* Actor);
-
-	/*
-	* Call Update() for RadarPoint in array if RadarPoint.Actor != nullptr, else remove RadarPoint from array
-	*
-	* @param RadarPointArr	RadarPoint array where to call Update for each element
-	* @param DeltaTime		Time since last RadarPointArr update;
-	*/
-	void UpdateRadarPointArr(TArray<FRadarPoint>& RadarPointArr, float DeltaTime);
-
-	/** Add character to enemies map */
-	UFUNCTION()
-		void CharacterSpawnedEvent(AShooterCharacter* Character);
-	
-	/** Calls AddEnemy() */
-	UFUNCTION()
-		void CharacterKilledEvent(AShooterCharacter* Character);
-
-	/** Calss RemoveEnemy() */
-	UFUNCTION()
-		void PickupPickEvent(AShooterPickup* Pickup);
-	
-	/** Calls AddPickup() */
-	UFUNCTION()
-		void PickupRespawnEvent(AShooterPickup* Pickup);
-
-	/** Calls ShowEnemy() */
-	UFUNCTION()
-		void CharacterWeaponShotEvent(AShooterCharacter* Character, AShooterWeapon* Weapon);
+	/** Get tracked character radar point index in radar model Category registry, viewer should not see self on radar */
+	int32 GetTrackedCharacterPointIndex(int32 Category) const;
 
+protected:
 	/** Character to detect hits from to provide radar hit marker info */
-	AShooterCharacter* TrackedCharacter;
+	UPROPERTY()
+	AShooterCharacter* TrackedCharacter = nullptr;
 	
 	/**  */
 	void AddHitMarker(FVector HitFromDirection);
@@ -242,16 +371,9 @@ protected:
 		void TrackedCharacterTakePointDmgEvent(AActor* DamagedActor, float Damage, AController* InstigatedBy, FVector HitLocation, UPrimitiveComponent* FHitComponent, FName BoneName, FVector ShotFromDirection, const UDamageType* DamageType, AActor* DamageCauser);
 
 public:
-	/** Calls Update() for radar points in Enemies, Pickups map radar points */
+	/** Update shared radar model (once per frame for all viewers) and hit markers */
 	void UpdateRadarTick(float DeltaTime);
 	
 	/**  */
 	void SetTrackedCharacter(AShooterCharacter* ShooterCharacter);
-
-private:
-	FDelegateHandle DelegateHandle_CharacterSpawn;
-	FDelegateHandle DelegateHandle_CharacterKill;
-	FDelegateHandle DelegateHandle_PickupPick;
-	FDelegateHandle DelegateHandle_PickupRespawn;
-	FDelegateHandle DelegateHandle_CharacterWeaponShot;
 };
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShooterRadarFloors.generated.h"
+
+/** Actors with this tag (usually volumes) mark floor bottom with their bounds min Z */
+#define RADAR_FLOOR_TAG TEXT("RadarFloor")
+
+/** Floors lower then this are merged, also limits floor lookup table size */
+#define RADAR_FLOOR_MIN_HEIGHT 100.0f
+
+/** Floor index is uint8 */
+#define RADAR_FLOOR_MAX 256
+
+/*
+ * Floor heights of one map, see UShooterRadarSettings::MapFloors
+ */
+USTRUCT()
+struct FRadarMapFloors
+{
+	GENERATED_BODY()
+
+	/** Map short package name, e.g. Highrise */
+	UPROPERTY()
+	FString Map;
+
+	/** World Z each floor above the lowest one starts at, in any order */
+	UPROPERTY()
+	TArray<float> FloorHeights;
+};
+
+/*
+ * Map split to horizontal floor bands. Floor 0 is below the lowest floor height, floor N is above N-th floor height.
+ * Floor lookup is one table read plus one compare regardless of floors count: Z range is cut to buckets no taller
+ * then the smallest floor, so each bucket contains at most one floor bottom.
+ */
+struct SHOOTERGAME_API FRadarFloorBands
+{
+	/*
+	 * Build floor bands of World map from config floor heights and RADAR_FLOOR_TAG actors
+	 *
+	 * @param	MapFloors	Config floor heights of all maps, only entry of World map is used
+	 */
+	void Build(UWorld* World, const TArray<FRadarMapFloors>& MapFloors);
+
+	/*
+	 * Set floor heights, floors lower then RADAR_FLOOR_MIN_HEIGHT are merged with floor below, floors over RADAR_FLOOR_MAX are ignored
+	 *
+	 * @param	FloorHeights	World Z each floor above the lowest one starts at, in any order
+	 */
+	void Init(TArray<float> FloorHeights);
+
+	void Reset();
+
+	/** Does map have more then one floor, else all locations are on floor 0 */
+	bool HasFloors() const { return FloorBottoms.Num() > 0; }
+
+	int32 NumFloors() const { return FloorBottoms.Num() + 1; }
+
+	/** Get floor index of world Z */
+	uint8 GetFloor(float Z) const
+	{
+		if (FloorBottoms.Num() == 0 || Z < FloorBottoms[0])
+		{
+			return 0;
+		}
+
+		const int32 Bucket = FMath::Min((int32)((Z - FloorBottoms[0]) * InvBucketHeight), BucketFloors.Num() - 1);
+		uint8 Floor = BucketFloors[Bucket];
+		if (Floor < FloorBottoms.Num() && Z >= FloorBottoms[Floor])
+		{
+			Floor++;  // bucket contains bottom of next floor
+		}
+		return Floor;
+	}
+
+private:
+	/** Floor bottoms above floor 0, ascending */
+	TArray<float> FloorBottoms;
+
+	/** Floor of each bucket bottom, buckets start at FloorBottoms[0] */
+	TArray<uint8> BucketFloors;
+
+	float InvBucketHeight = 0.0f;
+};
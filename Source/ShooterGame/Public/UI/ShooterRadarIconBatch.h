@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CanvasTypes.h"
+#include "Engine/Canvas.h"
+
+/*
+ * Radar icons sharing one texture collected as textured triangles and submitted to canvas as single item,
+ * instead of one FCanvasTileItem batch per icon
+ */
+struct SHOOTERGAME_API FRadarIconBatch
+{
+	/*
+	 * Start new batch
+	 *
+	 * @param	InTexture	Texture all batch icons are taken from
+	 * @param	InColor		Icons tint, usually Canvas DrawColor
+	 */
+	void Reset(UTexture* InTexture, const FLinearColor& InColor);
+
+	/** Add axis aligned icon, same placement as UCanvas::DrawIcon() */
+	void AddIcon(const FCanvasIcon& Icon, float X, float Y, float Scale);
+
+	/*
+	 * Add icon rotated around pivot, same placement as FCanvasTileItem with Rotation and PivotPoint
+	 *
+	 * @param	RotationDeg		Rotation around screen Z axis in degrees
+	 * @param	Pivot			Rotation pivot in icon size fractions
+	 */
+	void AddRotatedIcon(const FCanvasIcon& Icon, float X, float Y, float Scale, float RotationDeg, FVector2D Pivot);
+
+	/*
+	 * Submit batch triangles as one canvas item and clear them
+	 *
+	 * @return	number of canvas items issued, 0 if batch is empty
+	 */
+	int32 Flush(FCanvas* Canvas);
+
+	/** Icons added since last Reset()/Flush() */
+	int32 NumIcons() const { return Triangles.Num() / 2; }
+
+	/** Batched triangles, two per icon */
+	const TArray<FCanvasUVTri>& GetTriangles() const { return Triangles; }
+
+private:
+	/** Add icon quad with corners already in screen space, counter clockwise from top left */
+	void AddQuad(const FCanvasIcon& Icon, const FVector2D& TopLeft, const FVector2D& TopRight, const FVector2D& BottomRight, const FVector2D& BottomLeft);
+
+	UTexture* Texture = nullptr;
+
+	FLinearColor Color = FLinearColor::White;
+
+	TArray<FCanvasUVTri> Triangles;
+};
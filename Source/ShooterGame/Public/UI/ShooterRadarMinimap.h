@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Engine/StreamableManager.h"
+#include "CanvasTypes.h"
+#include "ShooterRadarMinimap.generated.h"
+
+class UTexture2D;
+struct FRadarProjectionParams;
+
+/**
+ * Top-down radar minimap of one map, baked offline by UShooterRadarMinimapCommandlet.
+ * Map area is split into square tiles, each tile is separate mip-mapped texture, so radar streams only tiles around player.
+ */
+UCLASS()
+class SHOOTERGAME_API UShooterRadarMinimapData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** World XY of tiles grid min corner */
+	UPROPERTY(VisibleAnywhere, Category = Minimap)
+	FVector2D WorldOrigin = FVector2D::ZeroVector;
+
+	/** World size of tile side */
+	UPROPERTY(VisibleAnywhere, Category = Minimap)
+	float TileWorldSize = 4096.0f;
+
+	UPROPERTY(VisibleAnywhere, Category = Minimap)
+	int32 NumTilesX = 0;
+
+	UPROPERTY(VisibleAnywhere, Category = Minimap)
+	int32 NumTilesY = 0;
+
+	/** Tile textures, row by row along world X. Texture U goes along world X, V along world Y */
+	UPROPERTY(VisibleAnywhere, Category = Minimap)
+	TArray<TSoftObjectPtr<UTexture2D>> Tiles;
+
+	/** Index of tile X, Y in Tiles */
+	int32 GetTileIndex(int32 X, int32 Y) const { return Y * NumTilesX + X; }
+
+	/** World XY bounds of tile X, Y */
+	FBox2D GetTileBounds(int32 X, int32 Y) const;
+
+	/*
+	 * Get tiles overlapping square around world location
+	 *
+	 * @return	inclusive tile coords range, empty (Max < Min) if square is out of minimap
+	 */
+	FIntRect GetTileRange(const FVector2D& Center, float HalfSize) const;
+
+	/** Package path minimap of map MapName is baked to, e.g. /Game/Minimaps/Highrise/DA_Highrise_Minimap */
+	static FString GetPackagePath(const FString& MapName);
+
+	/** Directory minimap assets of map MapName are baked to */
+	static FString GetPackageDirectory(const FString& MapName);
+};
+
+/*
+ * Radar minimap renderer: streams minimap tiles covering radar area around player and draws them as textured triangles
+ * clipped to radar circle. Radar rotation is applied by placing tile triangles, tile textures are never redrawn.
+ */
+class SHOOTERGAME_API FRadarMinimap
+{
+public:
+	/** Request minimap data of World map, radar draws no minimap until it's loaded or if map has no baked minimap */
+	void Init(UWorld* World);
+
+	/** Release minimap data and all tiles */
+	void Reset();
+
+	/*
+	 * Request tiles around radar center and release far ones. Tiles are kept a bit further then requested,
+	 * so moving back and forth on tile border doesn't reload them.
+	 */
+	void UpdateStreaming(const FVector& WorldCenter, float WorldRadius);
+
+	/*
+	 * Draw loaded tiles overlapping radar circle
+	 *
+	 * @return	number of canvas items issued
+	 */
+	int32 Draw(FCanvas* Canvas, const FRadarProjectionParams& Params, const FLinearColor& Color);
+
+	/** Is minimap data loaded */
+	bool IsAvailable() const { return GetData() != nullptr; }
+
+	/** Number of tiles requested or loaded */
+	int32 NumResidentTiles() const { return TileHandles.Num(); }
+
+	/*
+	 * Clip radar circle, approximated by polygon, to axis aligned rect
+	 *
+	 * @param	NumSegments		Circle polygon segments
+	 * @param	OutPolygon		Convex clipped polygon, empty if circle doesn't overlap rect
+	 * @param	Scratch			Clipping buffer, kept by caller to avoid allocations
+	 */
+	static void ClipCircleToRect(const FVector2D& Center, float Radius, const FBox2D& Rect, int32 NumSegments,
+		TArray<FVector2D>& OutPolygon, TArray<FVector2D>& Scratch);
+
+private:
+	/** Loaded minimap data, nullptr while loading */
+	UShooterRadarMinimapData* GetData() const;
+
+	FStreamableManager Streamable;
+
+	TSharedPtr<FStreamableHandle> DataHandle;
+
+	/** Tile index -> tile load handle, tile is resident while handle is kept */
+	TMap<int32, TSharedPtr<FStreamableHandle>> TileHandles;
+
+	/** Tiles to release, scratch of UpdateStreaming() */
+	TArray<int32> ReleasedTiles;
+
+	/** Clip polygon scratch */
+	TArray<FVector2D> ClipPolygon;
+	TArray<FVector2D> ClipScratch;
+
+	/** Triangles of drawn tile */
+	TArray<FCanvasUVTri> Triangles;
+};
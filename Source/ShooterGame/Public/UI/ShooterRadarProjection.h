@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FRadarPointRegistry;
+
+/*
+ * Radar space transform shared by all radar points projected in one HUD draw call
+ */
+struct FRadarProjectionParams
+{
+	/** Actual Radar Center In World (Usually this is HUD Owned Player) */
+	FVector WorldCenter = FVector::ZeroVector;
+
+	/** How many units in game radar can capture */
+	float WorldRadius = 1.0f;
+
+	/** RadarCenter on HUD Screen Space (should be scaled) */
+	FVector2D ScreenCenter = FVector2D::ZeroVector;
+
+	/** RadarCircleIcon Radius (should be scaled) */
+	float ScreenRadius = 0.0f;
+
+	/** Z axis differance to mark radar point as higher/lower */
+	float HeightThreshold = 0.0f;
+
+	/** Viewer floor band, INDEX_NONE if map has no floors. Radar points on other floors are marked higher/lower then */
+	int32 ViewerFloor = INDEX_NONE;
+
+	/** Draw only radar points on ViewerFloor */
+	bool bViewerFloorOnly = false;
+
+	/** Radar rotation sin/cos, set by SetRotation() */
+	float SinTheta = 0.0f;
+	float CosTheta = -1.0f;
+
+	/** @param	RadarRotRadians		Radar Rotation from X World Axis */
+	void SetRotation(float RadarRotRadians)
+	{
+		SinTheta = sinf(RadarRotRadians);
+		CosTheta = -cosf(RadarRotRadians);
+	}
+
+	/** Radar HUD space position of world XY location, same transform as FShooterRadarProjection for points inside radar, not clamped to radar border */
+	FVector2D WorldToScreen(const FVector2D& Location) const
+	{
+		const float Scale = ScreenRadius / WorldRadius;
+
+		// radar screen axes are swapped, same as in FShooterRadarProjection
+		const float BasicPosX = (WorldCenter.Y - Location.Y) * Scale;
+		const float BasicPosY = -(WorldCenter.X - Location.X) * Scale;
+
+		return FVector2D(
+			ScreenCenter.Y + BasicPosX * CosTheta + BasicPosY * SinTheta,
+			ScreenCenter.X - BasicPosX * SinTheta + BasicPosY * CosTheta);
+	}
+};
+
+/*
+ * Projected radar point, ready to be drawn by HUD
+ */
+struct FRadarDrawItem
+{
+	/** Radar point icon center on HUD Screen Space */
+	float X;
+	float Y;
+
+	/** Radar point index in projected registry */
+	int32 PointIndex;
+
+	/** 1 if point is higher then HeightThreshold, -1 if lower, else 0 */
+	int32 HeightSign;
+};
+
+/*
+ * Reusable buffers for projecting culled radar points subset, kept by caller to avoid per frame allocations
+ */
+struct FRadarProjectionScratch
+{
+	/** Candidate radar points indices in registry */
+	TArray<int32> Indices;
+
+	/** Candidate radar points gathered to packed arrays */
+	TArray<float> PosX;
+	TArray<float> PosY;
+	TArray<float> PosZ;
+	TArray<uint8> Flags;
+};
+
+/*
+ * Batch radar points projection from world space to radar HUD space
+ */
+struct SHOOTERGAME_API FShooterRadarProjection
+{
+	/*
+	 * Project all showable radar points to radar HUD space. Uses VectorRegister path when available.
+	 *
+	 * @param	Params			Radar space transform.
+	 * @param	PosX/PosY/PosZ	Radar points world location, split by axis.
+	 * @param	Flags			Radar points ERadarPointFlags.
+	 * @param	Num				Radar points count.
+	 * @param	OutDrawList		Compact list of radar points to draw, reset before projection.
+	 */
+	static void Project(const FRadarProjectionParams& Params, 
+		const float* PosX, const float* PosY, const float* PosZ, const uint8* Flags, int32 Num, 
+		TArray<FRadarDrawItem>& OutDrawList);
+
+	/** Same as Project() but one point at a time, used as fallback and for reference */
+	static void ProjectScalar(const FRadarProjectionParams& Params,
+		const float* PosX, const float* PosY, const float* PosZ, const uint8* Flags, int32 Num,
+		TArray<FRadarDrawItem>& OutDrawList);
+
+	/*
+	 * Project showable radar points of Registry. If Registry has spatial grid only points in cells overlapping
+	 * radar disc and points flagged CanShowIfOutRadarBorder are projected. Floors are applied if Params.ViewerFloor is set.
+	 *
+	 * @param	Scratch		Buffers to gather culled radar points to.
+	 */
+	static void Project(const FRadarProjectionParams& Params, const FRadarPointRegistry& Registry, 
+		TArray<FRadarDrawItem>& OutDrawList, FRadarProjectionScratch& Scratch);
+
+	/*
+	 * Replace height threshold sign of projected radar points with floor difference to Params.ViewerFloor,
+	 * drop radar points on other floors if Params.bViewerFloorOnly
+	 *
+	 * @param	Floors			Radar points floor bands, indexed by draw item PointIndex
+	 */
+	static void ApplyFloors(const FRadarProjectionParams& Params, const uint8* Floors, TArray<FRadarDrawItem>& InOutDrawList);
+
+private:
+	/** Project registry radar points gathered to Scratch.Indices */
+	static void ProjectCandidates(const FRadarProjectionParams& Params, const FRadarPointRegistry& Registry,
+		TArray<FRadarDrawItem>& OutDrawList, FRadarProjectionScratch& Scratch);
+
+	/** Project radar points [StartIndex, Num) one at a time and append visible to OutDrawList */
+	static void ProjectScalarRange(const FRadarProjectionParams& Params,
+		const float* PosX, const float* PosY, const float* PosZ, const uint8* Flags, int32 StartIndex, int32 Num,
+		TArray<FRadarDrawItem>& OutDrawList);
+};
@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WorldCollision.h"
+
+class AController;
+class UWorld;
+struct FRadarCategoryTable;
+struct FRadarPointRegistry;
+struct FRadarPositionSnapshot;
+
+/*
+ * Round-robin walk over spotter/target pairs, cursor persists between frames so every pair gets its turn under trace budget
+ */
+struct SHOOTERGAME_API FRadarSpotSchedule
+{
+	/*
+	 * Walk pairs from cursor until Budget traces are issued or every pair is visited once
+	 *
+	 * @param	TryTrace	Called with (SpotterIndex, TargetIndex), returns true if trace was issued for pair
+	 * @return	number of traces issued
+	 */
+	int32 Schedule(int32 NumSpotters, int32 NumTargets, int32 Budget, TFunctionRef<bool(int32, int32)> TryTrace);
+
+	/** Flattened index of next pair to visit */
+	int32 Cursor = 0;
+};
+
+/*
+ * Enemy seen by player character, revealed only on radars of its player and allies until ExpireTime
+ */
+struct FRadarSpot
+{
+	TWeakObjectPtr<AActor> Target;
+
+	/** Controller of character which spotted Target */
+	TWeakObjectPtr<AController> Spotter;
+
+	/** Radar category id of Target */
+	int32 Category;
+
+	/** World time spot stops showing at */
+	float ExpireTime;
+};
+
+/*
+ * "Spotted" radar reveal: enemies in player characters view cone are revealed if they are visible.
+ * Visibility is checked by async line traces under per radar update budget, results come next frame by trace delegate,
+ * so game thread never waits for traces. Spots aren't shown by shared radar registries, each radar shows only spots
+ * of its player and allies, see ForEachSpot(). Enabled by ShooterRadar.Spotting.
+ */
+class SHOOTERGAME_API FRadarSpotter
+{
+public:
+	/** Is spotting enabled, see ShooterRadar.Spotting */
+	static bool IsEnabled();
+
+	/*
+	 * Issue visibility traces for next spotter/target pairs, called once per radar update. Spotters are player controlled characters,
+	 * targets are their enemies of radar categories which expire on show. Removes expired spots.
+	 *
+	 * @param	TraceDelegate	Called next frame with trace result, should call ConsumeTrace()
+	 */
+	void IssueTraces(UWorld* World, const FRadarCategoryTable& Categories, const TArray<FRadarPointRegistry>& Registries,
+		const FRadarPositionSnapshot& Snapshot, const FTraceDelegate& TraceDelegate);
+
+	/*
+	 * Handle finished trace, spot its target if it's visible
+	 *
+	 * @param	WorldTime	Current world time spot expires after
+	 * @return	true if target is spotted
+	 */
+	bool ConsumeTrace(const FTraceDatum& TraceData, float WorldTime);
+
+	/** Call Visit for spots revealed to Viewer: spotted by it or its allies. Target spotted by several allies is visited for each */
+	void ForEachSpot(const UWorld* World, const AController* Viewer, TFunctionRef<void(const FRadarSpot&)> Visit) const;
+
+	/** Forget pending traces and spots */
+	void Reset();
+
+	int32 NumPendingTraces() const { return PendingTraces.Num(); }
+
+	int32 NumSpots() const { return Spots.Num(); }
+
+private:
+	FRadarSpotSchedule Schedule;
+
+	/** Issued trace waiting for result */
+	struct FPendingTrace
+	{
+		TWeakObjectPtr<AActor> Target;
+		TWeakObjectPtr<AController> Spotter;
+		int32 Category;
+
+		/** Display time of Target category */
+		float ShowTime;
+
+		/** IssueTraces() call trace was issued by */
+		uint32 UpdateIndex;
+	};
+
+	/** Trace UserData -> pending trace */
+	TMap<uint32, FPendingTrace> PendingTraces;
+
+	/** UserData of next trace */
+	uint32 NextTraceId = 0;
+
+	/** Number of IssueTraces() calls */
+	uint32 UpdateIndex = 0;
+
+	/** Spots not expired yet, one per spotter and target */
+	TArray<FRadarSpot> Spots;
+
+	/** Spotters eyes, gathered per IssueTraces() call, kept to avoid per update allocation */
+	struct FSpotterView
+	{
+		const AActor* Actor;
+		AController* Controller;
+		FVector Location;
+		FVector Direction;
+	};
+	TArray<FSpotterView> Spotters;
+
+	/** Targets and their radar category ids gathered per IssueTraces() call */
+	TArray<AActor*> Targets;
+	TArray<int32> TargetCategories;
+	TArray<FVector> TargetLocations;
+};
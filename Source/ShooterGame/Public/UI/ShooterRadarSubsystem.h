@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterRadarCollector.h"
+#include "ShooterRadarCategories.h"
+#include "ShooterRadarSpotter.h"
+#include "ShooterRadarTimeline.h"
+#include "ShooterRadarSubsystem.generated.h"
+
+class AController;
+class AShooterCharacter;
+class AShooterWeapon;
+class AShooterPickup;
+class UDemoNetDriver;
+
+/**
+ * World radar model, one canonical set of radar entities shared by all radar viewers (split-screen HUDs, spectators).
+ * Subscribes to radar events once per world, so every event is processed once regardless of viewers count.
+ * On server it's also the source of AShooterRadarFeed snapshots sent to remote players.
+ */
+UCLASS()
+class SHOOTERGAME_API UShooterRadarSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/*
+	 * Update radar entities positions and timers with world time elapsed since last update.
+	 * Called by every viewer and radar feed, only first call in frame does the work.
+	 * Model is updated at ShooterRadar.UpdateRate, other frames only interpolate displayed positions.
+	 */
+	void UpdateRadar();
+
+	/** Radar categories of world radar points */
+	const FRadarCategoryTable& GetCategories() const { return Categories; }
+
+	/** Get radar points registry of valid category id */
+	const FRadarPointRegistry& GetRegistry(int32 Category) const { return Registries[Category]; }
+
+	/** Number of enemy reveals by shots since world start, compare with radar feeds pings transmitted */
+	uint32 GetRevealsGenerated() const { return RevealsGenerated; }
+
+	/** Floor bands of world map, built on first radar update when level actors are loaded */
+	const FRadarFloorBands& GetFloorBands() const { return FloorBands; }
+
+	/*
+	 * Visit radar points of enemies spotted by Viewer or its allies and not shown to everyone, see ShooterRadar.Spotting.
+	 * Spots are revealed only on radars of spotter and its allies, so they are drawn and sent to radar feeds per viewer.
+	 *
+	 * @param	Visit	Called with (Category, PointIndex, ExpireTime) of each spotted radar point, ExpireTime is world time
+	 */
+	void ForEachSpottedPoint(const AController* Viewer, TFunctionRef<void(int32, int32, float)> Visit) const;
+
+	/** Radar history recorded during demo playback */
+	const FRadarTimeline& GetTimeline() const { return Timeline; }
+
+	/*
+	 * Enable spatial grid for registries of bStaticPosition categories (pickups), so radar draw only walks radar points near radar center
+	 *
+	 * @param CellSize	Grid cell size in world units, usually radar world radius
+	 */
+	void SetStaticPointsGridCellSize(float CellSize);
+
+protected:
+	/** Radar categories from UShooterRadarSettings */
+	FRadarCategoryTable Categories;
+
+	/** Radar points registry per category id */
+	UPROPERTY()
+	TArray<FRadarPointRegistry> Registries;
+
+	/** Floor bands radar points are bucketed to */
+	FRadarFloorBands FloorBands;
+
+	/** Get registry of Actor category, nullptr if Actor has no radar category */
+	FRadarPointRegistry* FindRegistry(const AActor* Actor);
+
+	/*
+	 * Register radar point of Actor in its category registry
+	 *
+	 * @param	Actor	Actor to register, ignored if it has no radar category
+	 * @param	bShow	Also show radar point, already registered radar point is shown again
+	 */
+	void AddPoint(AActor* Actor, bool bShow);
+	/** Unregister radar point of Actor */
+	void RemovePoint(const AActor* Actor);
+	/*
+	 * Show or hide radar point of Actor if it's registered
+	 *
+	 * @return	true if radar point was found
+	 */
+	bool ShowPoint(const AActor* Actor, bool bShowOnRadar);
+
+	/** Calls AddPoint() */
+	UFUNCTION()
+		void CharacterSpawnedEvent(AShooterCharacter* Character);
+	
+	/** Calls RemovePoint() */
+	UFUNCTION()
+		void CharacterKilledEvent(AShooterCharacter* Character);
+
+	/** Hides pickup radar point */
+	UFUNCTION()
+		void PickupPickEvent(AShooterPickup* Pickup);
+	
+	/** Calls AddPoint() and shows pickup radar point */
+	UFUNCTION()
+		void PickupRespawnEvent(AShooterPickup* Pickup);
+
+	/** Shows character radar point */
+	UFUNCTION()
+		void CharacterWeaponShotEvent(AShooterCharacter* Character, AShooterWeapon* Weapon);
+
+	/** Blend displayed positions of interpolated radar points, Alpha is fraction of update interval elapsed since last update */
+	void InterpolatePositions(float Alpha);
+
+	/** Record spot of actor found visible by async visibility trace issued by Spotter */
+	void SpotTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceData);
+
+	/** Optional "spotted" reveal of visible enemies, see ShooterRadar.Spotting */
+	FRadarSpotter Spotter;
+
+	/** Bound to SpotTraceDone() */
+	FTraceDelegate SpotTraceDelegate;
+
+	/** Is demo played back now, radar changes are recorded to Timeline then */
+	bool IsRecordingTimeline() const;
+
+	/** Record radar point change of Actor to Timeline if it's recorded */
+	void RecordTimelineEvent(const AActor* Actor, int32 Category, ERadarTimelineEvent::Type Type, uint8 Flags = 0);
+
+	/** Record all radar points state to Timeline */
+	void RecordTimelineKeyframe(float Time);
+
+	/** Rebuild radar points from Timeline after replay scrubbing, so radar isn't empty until live events come */
+	void DemoGotoTimeDone(bool bWasSuccessful);
+
+	/** Radar history of demo playback, recorded only while demo is played */
+	FRadarTimeline Timeline;
+
+	/** Timeline points scratch, kept to avoid allocation per keyframe/seek */
+	TArray<FRadarTimelinePoint> TimelinePoints;
+
+	/** Demo driver DemoGotoTimeDone() is bound to */
+	TWeakObjectPtr<UDemoNetDriver> BoundDemoDriver;
+
+	/** Shooter characters positions, gathered once per radar update */
+	FRadarPositionSnapshot PositionSnapshot;
+
+	/** GFrameCounter of last UpdateRadar() call */
+	uint64 LastUpdateFrame = 0;
+
+	/** World time of last UpdateRadar() call, negative before first update */
+	float LastUpdateTime = -1.0f;
+
+	/** Enemy reveals counter */
+	uint32 RevealsGenerated = 0;
+
+private:
+	FDelegateHandle DelegateHandle_CharacterSpawn;
+	FDelegateHandle DelegateHandle_CharacterKill;
+	FDelegateHandle DelegateHandle_PickupPick;
+	FDelegateHandle DelegateHandle_PickupRespawn;
+	FDelegateHandle DelegateHandle_CharacterWeaponShot;
+	FDelegateHandle DelegateHandle_DemoGotoTime;
+};
@@ -0,0 +1,138 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace ERadarTimelineEvent
+{
+	/** Radar point change, mirrors radar model calls */
+	enum Type : uint8
+	{
+		/** Radar point registered with Flags */
+		Add,
+		/** Radar point unregistered */
+		Remove,
+		/** Radar point shown, show time restarts */
+		Show,
+		/** Radar point hidden */
+		Hide,
+	};
+}
+
+/*
+ * Radar point state reconstructed by timeline
+ */
+struct FRadarTimelinePoint
+{
+	/** Timeline key of radar point actor, see FRadarTimeline::FindOrAddKey() */
+	int32 Key = INDEX_NONE;
+
+	/** Radar category id */
+	uint8 Category = 0;
+
+	/** ERadarPointFlags bitmask */
+	uint8 Flags = 0;
+
+	/** Time elapsed since radar point was shown or hidden */
+	float ShowTime = 0.0f;
+};
+
+/*
+ * Radar point change at Time, 12 bytes
+ */
+struct FRadarTimelineEvent
+{
+	float Time = 0.0f;
+
+	/** Timeline key of radar point actor */
+	int32 Key = INDEX_NONE;
+
+	uint8 Category = 0;
+
+	/** ERadarTimelineEvent::Type */
+	uint8 Type = ERadarTimelineEvent::Add;
+
+	/** ERadarPointFlags of added radar point, used by Add only */
+	uint8 Flags = 0;
+};
+
+/*
+ * Compact radar history: full radar points state keyframes every few seconds plus change events between them.
+ * Seek finds last keyframe before seek time by binary search and applies only events after it,
+ * so radar state at any recorded time is rebuilt in O(log n + events per keyframe interval).
+ * Actors are referenced by name keys, so state can be restored on actors recreated by demo scrubbing.
+ */
+class SHOOTERGAME_API FRadarTimeline
+{
+public:
+	/** Get timeline key of actor Name, keys are dense indices */
+	int32 FindOrAddKey(FName Name);
+
+	/** Get actor name of timeline key */
+	FName GetKeyName(int32 Key) const { return KeyNames[Key]; }
+
+	/*
+	 * Record radar point change. Time should not go back, earlier times are clamped to last event time
+	 *
+	 * @param	Flags	ERadarPointFlags of added radar point, used by Add only
+	 */
+	void AddEvent(float Time, int32 Key, uint8 Category, ERadarTimelineEvent::Type Type, uint8 Flags = 0);
+
+	/** Is keyframe due at Time, keyframes are taken every KeyframeInterval seconds */
+	bool NeedsKeyframe(float Time, float KeyframeInterval) const;
+
+	/** Record full radar points state at Time */
+	void AddKeyframe(float Time, const TArray<FRadarTimelinePoint>& Points);
+
+	/*
+	 * Rebuild radar points state at Time
+	 *
+	 * @param	Time		Timeline time, state before first event is empty
+	 * @param	OutPoints	Radar points registered at Time, in no particular order
+	 */
+	void Seek(float Time, TArray<FRadarTimelinePoint>& OutPoints) const;
+
+	/** Forget events and keyframes after Time, called when playback goes back and history is recorded again */
+	void TruncateAfter(float Time);
+
+	/** Forget everything, keys included */
+	void Reset();
+
+	/** Time of last event or keyframe, -1.0 if timeline is empty */
+	float GetEndTime() const;
+
+	int32 NumEvents() const { return Events.Num(); }
+	int32 NumKeyframes() const { return Keyframes.Num(); }
+
+	/** Memory used by timeline, for stats */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FKeyframe
+	{
+		float Time;
+
+		/** First event after keyframe */
+		int32 FirstEvent;
+
+		/** Keyframe points range in KeyframePoints */
+		int32 FirstPoint;
+		int32 NumPoints;
+	};
+
+	/** Apply Event to Points at Time, PointIndices maps key to Points index */
+	static void ApplyEvent(const FRadarTimelineEvent& Event, float Time, TArray<FRadarTimelinePoint>& Points, TArray<int32>& PointIndices);
+
+	TArray<FRadarTimelineEvent> Events;
+	TArray<FKeyframe> Keyframes;
+
+	/** Points of all keyframes, flat */
+	TArray<FRadarTimelinePoint> KeyframePoints;
+
+	TArray<FName> KeyNames;
+	TMap<FName, int32> NameToKey;
+
+	/** Key -> point index scratch of Seek() */
+	mutable TArray<int32> SeekPointIndices;
+};
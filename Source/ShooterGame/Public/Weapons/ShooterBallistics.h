@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * Launch velocities of projectile with fixed launch speed to hit target under gravity
+ */
+struct FShooterBallisticSolution
+{
+	/** Straight (low) and overhead (lofted) launch velocities, same if problem has single solution */
+	FVector LowVelocity;
+	FVector HighVelocity;
+
+	/** Flight time to target of each solution, 0 if target is out of range */
+	float LowTime;
+	float HighTime;
+
+	/** Is target reachable, else both velocities are 45 degree launch towards target for max distance */
+	bool bInRange;
+};
+
+/*
+ * Ballistic problems and their solutions split by component, so they're solved 4 at a time.
+ * Kept by caller and reset between batches to avoid allocations.
+ */
+struct SHOOTERGAME_API FShooterBallisticBatch
+{
+	/** Problems: target relative to launch location, launch speed, gravity */
+	TArray<float> DeltaX;
+	TArray<float> DeltaY;
+	TArray<float> DeltaZ;
+	TArray<float> Speed;
+	TArray<float> GravityZ;
+
+	/** Solutions, filled by Solve() */
+	TArray<float> LowX;
+	TArray<float> LowY;
+	TArray<float> LowZ;
+	TArray<float> LowTime;
+	TArray<float> HighX;
+	TArray<float> HighY;
+	TArray<float> HighZ;
+	TArray<float> HighTime;
+	TArray<uint8> InRange;
+
+	/** Remove all problems, keeps capacity */
+	void Reset();
+
+	/** Add problem, returns its index */
+	int32 Add(const FVector& Start, const FVector& Target, float InSpeed, float InGravityZ);
+
+	int32 Num() const { return DeltaX.Num(); }
+
+	/** Solve all problems, see FShooterBallistics::SolveBatch() */
+	void Solve();
+
+	void GetSolution(int32 Index, FShooterBallisticSolution& OutSolution) const;
+};
+
+/*
+ * Ballistic launch solver, used by tracers, projectile weapons and bots aim
+ */
+struct SHOOTERGAME_API FShooterBallistics
+{
+	/*
+	 * Solve launch velocity of projectile with launch speed Speed to hit Target from Start.
+	 * Straight line is returned without gravity or if target is at start.
+	 */
+	static void Solve(const FVector& Start, const FVector& Target, float Speed, float GravityZ, FShooterBallisticSolution& OutSolution);
+
+	/*
+	 * Solve all problems of Batch into its solution buffers. Uses VectorRegister path when available, results match Solve().
+	 * Solution of problem doesn't depend on other problems in batch, so replayed tracers launch the same on every client.
+	 * Vector path has no scalar tail: problem buffers are padded with zero problems to a multiple of 4 while solving and
+	 * trimmed back after, so callers keep all buffers at Num() and may see their capacity grow by up to 3 entries.
+	 */
+	static void SolveBatch(FShooterBallisticBatch& Batch);
+
+	/** Same as SolveBatch() but one problem at a time, used as fallback and for reference */
+	static void SolveBatchScalar(FShooterBallisticBatch& Batch);
+
+private:
+	/** Resize problem buffers, added problems are zero */
+	static void SetNumProblems(FShooterBallisticBatch& Batch, int32 Num);
+
+	/** Resize solution buffers */
+	static void SetNumSolutions(FShooterBallisticBatch& Batch, int32 Num);
+};
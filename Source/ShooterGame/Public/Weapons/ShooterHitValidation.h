@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Player/ShooterHitboxHistory.h"
+#include "ShooterHitValidation.generated.h"
+
+class AShooterCharacter;
+class AShooterWeapon_Instant;
+
+/*
+ * Client hit on movable actor waiting for server validation
+ */
+struct FShooterHitClaim
+{
+	/** Weapon hit is confirmed to */
+	TWeakObjectPtr<AShooterWeapon_Instant> Weapon;
+
+	/** Shot as client reported it */
+	FHitResult Impact;
+	FVector Origin;
+	FVector ShootDir;
+	int32 RandomSeed;
+	float ReticleSpread;
+
+	/** Server time target hitboxes are rewound to */
+	float ShotTime;
+
+	/** Scale of target bounds if target has no hitbox history */
+	float BoundsScale;
+
+	/** Real time claim was queued at, for validation latency */
+	double QueueTime;
+};
+
+/**
+ * Server lag compensation of client weapon hits. Every character in play records its hitbox history
+ * at ShooterHitValidation.RecordRate for ShooterHitValidation.HistoryWindow seconds (at most FShooterHitboxHistory::MaxFrames frames), and hits client reports
+ * are checked against target hitboxes rewound to the time client fired, instead of current target bounds grown by leeway.
+ * Recording runs after all actors ticked, so history has animated pose of frame.
+ *
+ * With ShooterHitValidation.Batch claims arriving within frame are queued and validated together at end of frame:
+ * grouped by target, target pose is rewound once for claims with the same shot time, and targets are validated
+ * in parallel on worker threads. Queue depth and latency from arrival to verdict are tracked by stats and counters.
+ */
+UCLASS()
+class SHOOTERGAME_API UShooterHitValidation : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+
+	/** Are hits validated against rewound hitboxes, ShooterHitValidation.Rewind */
+	static bool IsEnabled();
+
+	/** Seconds of hitbox history kept, ShooterHitValidation.HistoryWindow clamped to what FShooterHitboxHistory::MaxFrames cover at record rate */
+	static float GetHistoryWindow();
+
+	/** Frames of hitbox history covering history window at record rate */
+	static int32 GetHistoryFrames();
+
+	/** [server] Record hitbox history of Character until it's unregistered */
+	void RegisterCharacter(AShooterCharacter* Character);
+
+	void UnregisterCharacter(AShooterCharacter* Character);
+
+	/** Record current hitboxes of all registered characters */
+	void RecordCharacters();
+
+	/*
+	 * Server time of world client of Shooter saw when it fired shot arriving now: its round trip and view delay ago,
+	 * at most history window ago
+	 */
+	float GetShotTime(const AController* Shooter) const;
+
+	/** Is Target character with recorded hitbox history */
+	bool HasHistory(const AActor* Target) const;
+
+	/*
+	 * Is Location inside hitboxes of Target at ShotTime, grown by ShooterHitValidation.Leeway.
+	 * Target should have history, see HasHistory().
+	 */
+	bool ValidateHit(const AActor* Target, const FVector& Location, float ShotTime);
+
+	/** Are claims queued and validated in one batch per frame, ShooterHitValidation.Batch */
+	static bool IsBatchEnabled();
+
+	/** Is Location inside bounding box Bounds scaled by BoundsScale, used for targets without hitbox history */
+	static bool IsInScaledBounds(const FBox& Bounds, const FVector& Location, float BoundsScale);
+
+	/** Queue claim, its weapon is told verdict at end of frame */
+	void QueueHit(const FShooterHitClaim& Claim);
+
+	/** Validate all queued claims and tell their weapons */
+	void ProcessQueue();
+
+	int32 GetQueueDepth() const { return Claims.Num(); }
+
+	/** Hits validated and rejected since world start */
+	uint32 GetNumValidated() const { return NumValidated; }
+	uint32 GetNumRejected() const { return NumRejected; }
+
+	/** Most claims validated in one batch */
+	int32 GetMaxQueueDepth() const { return MaxQueueDepth; }
+
+	/** Seconds from queueing claim to its verdict, average and worst */
+	double GetAverageLatency() const { return NumLatencies > 0 ? TotalLatency / NumLatencies : 0.0; }
+	double GetMaxLatency() const { return MaxLatency; }
+
+	/** Target poses rewound by batches, less than validated claims when claims share them */
+	uint32 GetNumPosesRewound() const { return NumPosesRewound; }
+
+	/** Verdicts of last batch in order its claims were queued, claims on removed targets are rejected */
+	TArrayView<const uint8> GetLastVerdicts() const { return ClaimResults; }
+
+protected:
+	/** Queued claims of one target */
+	struct FTargetGroup
+	{
+		/** Hitbox history of target, nullptr if claims are checked against Bounds */
+		const FShooterHitboxHistory* History;
+
+		FBox Bounds;
+
+		/** Indices into Claims */
+		TArray<int32> ClaimIndices;
+
+		/** Pose shared by claims with the same shot time */
+		TArray<FShooterHitboxTransform> Pose;
+
+		/** Poses rewound for group */
+		int32 NumPoses;
+	};
+
+	/** Claims waiting for validation */
+	TArray<FShooterHitClaim> Claims;
+
+	/** Verdicts, parallel to Claims, kept until next batch */
+	TArray<uint8> ClaimResults;
+
+	/** Groups of batch, first NumGroups are used, others keep their memory for next batches */
+	TArray<FTargetGroup> Groups;
+
+	int32 NumGroups = 0;
+
+	/** Group of each target in batch */
+	TMap<const AActor*, int32> TargetGroups;
+
+	int32 MaxQueueDepth = 0;
+
+	double TotalLatency = 0.0;
+
+	double MaxLatency = 0.0;
+
+	uint32 NumLatencies = 0;
+
+	uint32 NumPosesRewound = 0;
+
+	/** Group queued claims by target, gathering target histories and bounds on game thread */
+	void GroupClaims();
+
+	/** Validate claims of group, runs on worker thread */
+	void ValidateGroup(FTargetGroup& Group);
+
+	/** Count verdict into stats */
+	void CountHit(bool bIsValid);
+
+	/** Characters recording hitbox history */
+	UPROPERTY()
+	TArray<AShooterCharacter*> Characters;
+
+	/** World time next frame is recorded at */
+	float NextRecordTime = 0.0f;
+
+	uint32 NumValidated = 0;
+
+	uint32 NumRejected = 0;
+};
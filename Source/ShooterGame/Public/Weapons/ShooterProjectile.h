@@ -21,6 +21,9 @@ class AShooterProjectile : public AActor
 	/** setup velocity */
 	void InitVelocity(FVector& ShootDirection);
 
+	/** launch speed and gravity of projectile in World, called on class defaults to aim it */
+	void GetBallisticParams(const UWorld* World, float& OutSpeed, float& OutGravityZ) const;
+
 	/** handle hit */
 	UFUNCTION()
 	void OnImpact(const FHitResult& HitResult);
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterTracerBudget.generated.h"
+
+/*
+ * Cosmetic detail of weapon shot
+ */
+enum class EShooterShotDetail : uint8
+{
+	/** Trail, impact effects and physic tracer */
+	Full,
+
+	/** Trail and impact effects, no physic tracer */
+	Beam,
+
+	/** Shot isn't drawn */
+	None,
+
+	Num
+};
+
+/*
+ * Local view shot detail is chosen for
+ */
+struct FShooterShotViewer
+{
+	FVector Location;
+
+	/** Unit view direction */
+	FVector Direction;
+
+	/** Cos of half angle of view cone, cone contains whole view frustum */
+	float ViewConeCos;
+};
+
+/**
+ * Per client budget of weapon shot effects. Each shot gets full physic tracer, cheap beam, or nothing,
+ * by its distance to nearest local viewer, whether any local view sees it, and by per frame budget of physic tracers
+ * and per second budget of drawn shots. Shots fired by local player are always full.
+ * Tuned by ShooterTracers.Budget.* console variables, e.g. from scalability settings of low-end hardware.
+ */
+UCLASS()
+class SHOOTERGAME_API UShooterTracerBudget : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/** Is budget enabled by ShooterTracers.Budget, else all shots are full */
+	static bool IsEnabled();
+
+	/*
+	 * Choose detail of shot from Origin to EndPoint for local viewers of world, and count it into budget
+	 *
+	 * @param	bLocallyFired	Shot is fired by local player
+	 */
+	EShooterShotDetail EvaluateShot(const FVector& Origin, const FVector& EndPoint, bool bLocallyFired);
+
+	/** Choose detail of shot for given viewers, and count it into budget. All shots are full if there's no viewer */
+	EShooterShotDetail EvaluateShot(TArrayView<const FShooterShotViewer> InViewers, const FVector& Origin, const FVector& EndPoint, bool bLocallyFired);
+
+	/** Shots given Detail since world start */
+	uint32 GetNumShots(EShooterShotDetail Detail) const { return NumShots[(int32)Detail]; }
+
+	/** Shots not drawn because they're too far from all viewers */
+	uint32 GetNumCulledByDistance() const { return NumCulledByDistance; }
+
+	/** Shots not drawn because no viewer sees them */
+	uint32 GetNumCulledByView() const { return NumCulledByView; }
+
+	/** Shots not drawn because per second budget is spent */
+	uint32 GetNumCulledByBudget() const { return NumCulledByBudget; }
+
+	/** Shots drawn as beam instead of full because per frame budget is spent */
+	uint32 GetNumDegradedByBudget() const { return NumDegradedByBudget; }
+
+	/** Viewer of player controller, false if it has no camera */
+	static bool GetViewer(const APlayerController* PlayerController, FShooterShotViewer& OutViewer);
+
+protected:
+	/** Local viewers, gathered once per frame */
+	TArray<FShooterShotViewer> Viewers;
+
+	uint64 ViewersFrame = MAX_uint64;
+
+	/** Frame FullShotsInFrame counts */
+	uint64 BudgetFrame = MAX_uint64;
+
+	int32 FullShotsInFrame = 0;
+
+	/** Drawn shots left in per second budget, refilled continuously */
+	float BudgetTokens = -1.0f;
+
+	double BudgetRefillTime = 0.0;
+
+	uint32 NumShots[(int32)EShooterShotDetail::Num] = {};
+
+	uint32 NumCulledByDistance = 0;
+
+	uint32 NumCulledByView = 0;
+
+	uint32 NumCulledByBudget = 0;
+
+	uint32 NumDegradedByBudget = 0;
+
+	/** Gather local viewers if not done this frame */
+	void UpdateViewers();
+
+	/** Refill per second budget by time passed, and take one shot from it. Returns false if budget is spent */
+	bool ConsumeSecondBudget();
+
+	/** Count shot of Detail */
+	EShooterShotDetail CountShot(EShooterShotDetail Detail);
+};
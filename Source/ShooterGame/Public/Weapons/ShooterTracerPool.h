@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterTracerPool.generated.h"
+
+class AShooterWeapon;
+class AShooterWeaponTracerPhysic;
+
+DECLARE_STATS_GROUP(TEXT("ShooterTracers"), STATGROUP_ShooterTracers, STATCAT_Advanced);
+
+/*
+ * Pooled tracers of one tracer class
+ */
+USTRUCT()
+struct FShooterTracerPoolBucket
+{
+	GENERATED_BODY()
+
+	/** Inactive tracers ready for reuse, hidden with collision and movement off */
+	UPROPERTY()
+	TArray<AShooterWeaponTracerPhysic*> FreeTracers;
+
+	/** Tracers of this class owned by pool, active and free */
+	int32 NumTracers = 0;
+
+	/** Max NumTracers since world start */
+	int32 PeakTracers = 0;
+};
+
+/**
+ * World pool of physic weapon tracers, one bucket per tracer class.
+ * Tracer actors are spawned once and recycled on Destroy or LifeSpan expiry instead of being destroyed,
+ * so sustained automatic fire doesn't spawn and garbage collect actor with its components every shot.
+ */
+UCLASS()
+class SHOOTERGAME_API UShooterTracerPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/** Is pooling enabled by ShooterTracers.Pool, else tracers are spawned and destroyed per shot */
+	static bool IsEnabled();
+
+	/** Tracers pre-warmed per tracer class when weapon using it is spawned, ShooterTracers.PoolPrewarm */
+	static int32 GetPrewarmCount();
+
+	/*
+	 * Get free tracer of TracerClass or spawn new one, and launch it from Weapon muzzle to ImpactPoint
+	 *
+	 * @return	launched tracer, nullptr if it can't be spawned
+	 */
+	AShooterWeaponTracerPhysic* Acquire(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, AShooterWeapon* Weapon, const FVector& ImpactPoint);
+
+	/** Return tracer acquired from pool, tracer is destroyed if its bucket already has ShooterTracers.PoolMaxFree free tracers */
+	void Release(AShooterWeaponTracerPhysic* Tracer);
+
+	/** Spawn free tracers of TracerClass until pool owns at least Count tracers of it */
+	void Prewarm(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, int32 Count);
+
+	/** Number of acquires served by free tracer */
+	uint32 GetNumHits() const { return NumHits; }
+
+	/** Number of acquires that spawned new tracer */
+	uint32 GetNumMisses() const { return NumMisses; }
+
+	/** Max tracers of TracerClass owned by pool at once, 0 if pool has no such tracers */
+	int32 GetPeakSize(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass) const;
+
+	/** Number of free tracers of TracerClass */
+	int32 GetNumFree(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass) const;
+
+protected:
+	/** Tracer class -> its pooled tracers */
+	UPROPERTY()
+	TMap<UClass*, FShooterTracerPoolBucket> Buckets;
+
+	uint32 NumHits = 0;
+
+	uint32 NumMisses = 0;
+
+	/** Spawn tracer owned by pool, it's left inactive */
+	AShooterWeaponTracerPhysic* SpawnTracer(UClass* TracerClass, FShooterTracerPoolBucket& Bucket);
+};
@@ -0,0 +1,240 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Weapons/ShooterBallistics.h"
+#include "ShooterTracerSimulation.generated.h"
+
+class AShooterWeapon;
+class AShooterWeaponTracerPhysic;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/*
+ * Simulation parameters of tracer class, read once from its defaults, see AShooterWeaponTracerPhysic::GetSimulationParams()
+ */
+struct FShooterTracerParams
+{
+	float Radius = 5.0f;
+
+	/** World gravity scaled by projectile gravity scale */
+	float GravityZ = 0.0f;
+
+	float InitialSpeed = 30000.0f;
+
+	float MaxSpeed = 30000.0f;
+
+	float Bounciness = 0.2f;
+
+	float Friction = 1.0f;
+
+	/** Tracer stops when bounce leaves it slower then this */
+	float StopSimulatingSpeed = 1000.0f;
+
+	float LifeSpan = 0.5f;
+
+	/** Lifespan left after bounce, tracer is removed on bounce if <= 0 */
+	float DestroyOnBounceTime = 0.2f;
+
+	/** Bounce only if cos of angle between incoming direction and hit normal is not above this, tracer is removed otherwise */
+	float BounceAngleCos = 0.0f;
+
+	/** Is BounceAngleCos used, else tracer bounces by bShouldBounce */
+	bool bClampBounceAngle = true;
+
+	bool bShouldBounce = true;
+
+	bool bShouldDestroyOnSecondBounce = true;
+
+	bool bShouldDestroyOnOverlap = true;
+
+	/** Max degrees bounce direction is randomly turned by, from tracer random stream */
+	float BounceScatterAngle = 0.0f;
+
+	UStaticMesh* Mesh = nullptr;
+
+	FVector MeshScale = FVector::OneVector;
+};
+
+/*
+ * Simulated tracer, plain data
+ */
+struct FShooterTracer
+{
+	FVector Location;
+
+	FVector Velocity;
+
+	/** Seconds until tracer is removed */
+	float LifeSpan;
+
+	/** Fixed steps simulated since launch */
+	int32 NumSteps;
+
+	/** Random stream seeded by weapon shot, the only source of randomness of tracer */
+	FRandomStream Random;
+
+	/** Weapon and weapon owner unique ids, ignored by tracer sweeps */
+	uint32 IgnoreActorIds[2];
+
+	/** Index of tracer class in UShooterTracerSimulation */
+	uint16 ClassIndex;
+
+	uint8 bIsBouncedFirstTime : 1;
+
+	/** Stopped by slow bounce, lies at Location until its lifespan ends */
+	uint8 bIsStopped : 1;
+
+	/** Is tracer moved along precomputed trajectory segment instead of per tick sweeps */
+	uint8 bIsClosedForm : 1;
+
+	/** Does segment end by overlap that removes tracer, else by blocking hit */
+	uint8 bImpactRemoves : 1;
+
+	/** Closed form trajectory segment: start location and velocity, time since segment start */
+	FVector SegmentStart;
+	FVector SegmentVelocity;
+	float SegmentTime;
+
+	/** Segment time of first impact, MAX_flt if segment has no impact within tracer lifespan */
+	float ImpactTime;
+
+	FVector ImpactLocation;
+	FVector ImpactNormal;
+};
+
+/**
+ * Actorless physic tracers: all tracers of world are plain structs in one array, simulated in one batched tick
+ * with the same rules AShooterWeaponTracerPhysic applies with its projectile movement (gravity, bounce angle, second bounce),
+ * and drawn by one instanced static mesh component per tracer class.
+ * Tracer class is simulated here if it has SimulatedMesh, otherwise it's spawned as actor.
+ *
+ * With ShooterTracers.ClosedForm tracer position is evaluated from its launch velocity each frame, and collision is queried
+ * only when trajectory segment starts: once at spawn along the chord to solved target, and again after each bounce.
+ *
+ * Tracers advance in ShooterTracers.FixedStep steps, so tracer state is pure function of shot origin, target, random seed
+ * and number of steps, whatever frame rate, batch of shots or local weapon animation is. Every client recomputing shot
+ * from replicated hit notify, and every replay, simulates the same tracer.
+ */
+UCLASS()
+class SHOOTERGAME_API UShooterTracerSimulation : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/** FTickableGameObject */
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+
+	/** Is actorless simulation enabled by ShooterTracers.Simulate */
+	static bool IsEnabled();
+
+	/** Can tracers of TracerClass be simulated, they need SimulatedMesh */
+	static bool CanSimulate(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass);
+
+	/*
+	 * Add tracer of TracerClass fired by Weapon flying from Origin to ImpactPoint.
+	 * Launch velocities of tracers spawned within frame are solved together when simulation runs.
+	 *
+	 * @param	RandomSeed	Seed of weapon shot, drives all randomness of tracer
+	 * @return	false if TracerClass can't be simulated
+	 */
+	bool Spawn(TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, AShooterWeapon* Weapon, const FVector& Origin, const FVector& ImpactPoint, int32 RandomSeed);
+
+	/** Advance all tracers by fixed steps fitting into DeltaTime and update their instances */
+	void Simulate(float DeltaTime);
+
+	/** Fixed step tracers advance by, ShooterTracers.FixedStep, 0 if tracers step by frame time */
+	static float GetFixedStep();
+
+	/** Number of simulated tracers, spawned tracers are counted from next Simulate() */
+	int32 Num() const { return Tracers.Num(); }
+
+	const FShooterTracer& GetTracer(int32 Index) const { return Tracers[Index]; }
+
+	/*
+	 * Apply blocking hit to tracer velocity and lifespan, same rules as AShooterWeaponTracerPhysic hit and bounce,
+	 * bounce direction is scattered from tracer random stream
+	 *
+	 * @param	ImpactNormal	Normal of hit surface
+	 * @return	false if tracer should be removed
+	 */
+	static bool ApplyHit(FShooterTracer& Tracer, const FShooterTracerParams& Params, const FVector& ImpactNormal);
+
+	/** Location and velocity on trajectory segment of Tracer at segment time Time */
+	static void EvaluateSegment(const FShooterTracer& Tracer, float GravityZ, float Time, FVector& OutLocation, FVector& OutVelocity);
+
+protected:
+	/** Tracer classes ever simulated, FShooterTracer::ClassIndex */
+	UPROPERTY()
+	TArray<UClass*> Classes;
+
+	/** Class parameters, parallel to Classes */
+	TArray<FShooterTracerParams> ClassParams;
+
+	/** Instances of each class, parallel to Classes */
+	UPROPERTY()
+	TArray<UInstancedStaticMeshComponent*> ClassInstances;
+
+	TArray<FShooterTracer> Tracers;
+
+	/** Tracers spawned since last simulation, waiting for launch velocity */
+	TArray<FShooterTracer> PendingTracers;
+
+	/** Launch problems of PendingTracers, parallel to it */
+	FShooterBallisticBatch PendingLaunches;
+
+	/** Do instance components draw any tracer */
+	bool bHasInstances = false;
+
+	/** Frame time not simulated yet, less than one fixed step */
+	float StepAccumulator = 0.0f;
+
+	/** Sweep hits scratch */
+	TArray<FHitResult> SweepHits;
+
+	/** Instance transforms scratch, per class */
+	TArray<TArray<FTransform>> ClassTransforms;
+
+	/** Get index of TracerClass in Classes, registers class on first use */
+	int32 FindOrAddClass(UClass* TracerClass);
+
+	/** Solve launch velocities of pending tracers in one batch and move them to simulated tracers */
+	void LaunchPendingTracers();
+
+	/** Move tracer by DeltaTime, sweeping against world. Returns false if tracer should be removed */
+	bool MoveTracer(FShooterTracer& Tracer, const FShooterTracerParams& Params, float DeltaTime);
+
+	/** Move tracer by DeltaTime along its trajectory segment, no sweeps until segment impact. Returns false if tracer should be removed */
+	bool MoveTracerClosedForm(FShooterTracer& Tracer, const FShooterTracerParams& Params, float DeltaTime);
+
+	/*
+	 * Start trajectory segment at tracer location and velocity, and find its first impact by sweeping chords of the trajectory
+	 *
+	 * @param	Duration	Segment time searched for impact
+	 * @param	NumChords	Chords trajectory is approximated with, one is enough if segment ends at solved target
+	 */
+	void StartSegment(FShooterTracer& Tracer, const FShooterTracerParams& Params, float Duration, int32 NumChords);
+
+	/** Sweep query params ignoring tracer weapon and its owner */
+	static FCollisionQueryParams MakeQueryParams(const FShooterTracer& Tracer);
+
+	/** Advance tracer by one step. Returns false if tracer should be removed */
+	bool StepTracer(FShooterTracer& Tracer, float StepTime);
+
+	/*
+	 * Match instances of each class to its simulated tracers
+	 *
+	 * @param	ExtrapolationTime	Time since last step, moving tracers are drawn ahead by it
+	 */
+	void UpdateInstances(float ExtrapolationTime);
+};
@@ -9,6 +9,10 @@
 class UProjectileMovementComponent;
 class USphereComponent;
 class AShooterWeapon;
+class UShooterTracerPool;
+class UStaticMesh;
+struct FShooterBallisticSolution;
+struct FShooterTracerParams;
 
 UCLASS()
 class SHOOTERGAME_API AShooterWeaponTracerPhysic : public AActor
@@ -18,11 +22,34 @@ class SHOOTERGAME_API AShooterWeaponTracerPhysic : public AActor
 public:
 	AShooterWeaponTracerPhysic();
 
-	static AShooterWeaponTracerPhysic* SpawnFromWeapon(AShooterWeapon* Weapon, TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, const FHitResult& HitResult);
+	/*
+	 * Spawn tracer of weapon shot flying to HitResult impact point. Tracer class with SimulatedMesh is simulated
+	 * without actor by UShooterTracerSimulation, else tracer is taken from UShooterTracerPool if pooling is enabled.
+	 * Only simulated tracers replay the same on every client, tracer actors fly from local Weapon muzzle.
+	 *
+	 * @param	Origin		Shot origin simulated tracer flies from
+	 * @param	RandomSeed	Seed of weapon shot
+	 * @return	tracer actor, nullptr if tracer is simulated without actor
+	 */
+	static AShooterWeaponTracerPhysic* SpawnFromWeapon(AShooterWeapon* Weapon, TSubclassOf<AShooterWeaponTracerPhysic> TracerClass, const FVector& Origin,
+		const FHitResult& HitResult, int32 RandomSeed);
+
+	/** Is tracer free in its pool, hidden and not simulated */
+	bool IsInPool() const { return bIsInPool; }
+
+	UStaticMesh* GetSimulatedMesh() const { return SimulatedMesh; }
+
+	/** Get parameters UShooterTracerSimulation simulates tracers of this class with, called on class defaults */
+	void GetSimulationParams(UWorld* World, FShooterTracerParams& OutParams) const;
 
 protected:
+	friend class UShooterTracerPool;
+
 	virtual void BeginPlay() override;
 
+	/** Tracer lifespan ends in pool, not in Destroy() */
+	virtual void LifeSpanExpired() override;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Components")
 		USphereComponent* SphereComp;
 
@@ -47,6 +74,23 @@ protected:
 
 	FVector TargetDestination;
 
+	/** Pool tracer returns to instead of being destroyed, null if tracer was spawned without pool */
+	TWeakObjectPtr<UShooterTracerPool> OwningPool;
+
+	bool bIsInPool;
+
+	/** Place tracer at Weapon muzzle and launch it to ImpactPoint, resets state left by previous flight of pooled tracer */
+	void Launch(AShooterWeapon* Weapon, const FVector& ImpactPoint);
+
+	/** Start projectile movement from current location to TargetDestination */
+	void LaunchToTarget();
+
+	/** Stop and hide tracer, called when it returns to pool */
+	void ResetForPool();
+
+	/** Return tracer to its pool or destroy it, used instead of Destroy() */
+	void Recycle();
+
 	/** will ignore projectile movement ShouldBounce
 	  * max allowed bounce angle to hit normal
 	  * zero mean no clamp bounce angle,
@@ -58,6 +102,17 @@ protected:
 	/* Actual Value That Will Be Check if Bounce or not, Calculated from BounceAngleToNormalMin */
 	float BounceAngleCos;
 
+	/** Mesh drawn for tracers of this class simulated without actor by UShooterTracerSimulation, tracers are actors if not set */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Tracer")
+		UStaticMesh* SimulatedMesh;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Tracer")
+		FVector SimulatedMeshScale;
+
+	/** Max degrees simulated tracer bounce is randomly turned by, random stream is seeded by weapon shot so all clients agree */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Tracer", meta = (ClampMin = 0.0f, ClampMax = 90.0f))
+		float BounceScatterAngle;
+
 	UFUNCTION()
 		void OnProjectileBounce(const FHitResult& ImpactResult, const FVector& ImpactVelocity);
 
@@ -72,6 +127,6 @@ protected:
 	/** Adjust Initial Launch Angle relatively Gravity force to hit in right place */
 	void DbgTestAdjustInitialVelocityToHitTarget();
 
-	/**  */
-	void ComputeProjectileInitialVelocitiesToHitTarget(FVector ImpactPoint, TArray<FVector>& OutVelocityArray);
+	/** Solve launch velocity from tracer location to hit ImpactPoint with projectile speed and gravity */
+	void ComputeProjectileInitialVelocitiesToHitTarget(FVector ImpactPoint, FShooterBallisticSolution& OutSolution);
 };
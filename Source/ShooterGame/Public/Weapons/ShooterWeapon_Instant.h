@@ -6,6 +6,8 @@
 #include "ShooterWeapon_Instant.generated.h"
 
 class AShooterImpactEffect;
+enum class EShooterShotDetail : uint8;
+struct FShooterHitClaim;
 
 USTRUCT()
 struct FInstantHitInfo
@@ -55,7 +57,7 @@ struct FInstantWeaponData
 	UPROPERTY(EditDefaultsOnly, Category=WeaponStat)
 	TSubclassOf<UDamageType> DamageType;
 
-	/** hit verification: scale for bounding box of hit actor */
+	/** hit verification: scale for bounding box of hit actor without hitbox history, see UShooterHitValidation */
 	UPROPERTY(EditDefaultsOnly, Category=HitVerification)
 	float ClientSideHitLeeway;
 
@@ -63,6 +65,10 @@ struct FInstantWeaponData
 	UPROPERTY(EditDefaultsOnly, Category=HitVerification)
 	float AllowedViewDotHitDir;
 
+	/** hit verification: max distance of shot origin client reports from muzzle, farther one is replaced by muzzle */
+	UPROPERTY(EditDefaultsOnly, Category=HitVerification)
+	float ClientShotOriginTolerance;
+
 	/** defaults */
 	FInstantWeaponData()
 	{
@@ -75,6 +81,7 @@ struct FInstantWeaponData
 		DamageType = UDamageType::StaticClass();
 		ClientSideHitLeeway = 200.0f;
 		AllowedViewDotHitDir = 0.8f;
+		ClientShotOriginTolerance = 300.0f;
 	}
 };
 
@@ -87,6 +94,17 @@ class AShooterWeapon_Instant : public AShooterWeapon
 	/** get current spread */
 	float GetCurrentSpread() const;
 
+	/** [server] verdict of client hit claim queued by this weapon, confirms hit if it's valid */
+	void OnClientHitValidated(const FShooterHitClaim& Claim, bool bIsValid);
+
+#if WITH_DEV_AUTOMATION_TESTS
+	/** [tests] fire shot from Origin along current aim as owning client confirms it, tracers are TracerClass */
+	void FireConfirmedShotForTest(TSubclassOf<class AShooterWeaponTracerPhysic> TracerClass, const FVector& Origin, int32 RandomSeed);
+
+	/** [tests] replay shot from Origin as remote clients simulate it, tracers are TracerClass */
+	void FireSimulatedShotForTest(TSubclassOf<class AShooterWeaponTracerPhysic> TracerClass, const FVector& Origin, int32 RandomSeed);
+#endif
+
 protected:
 
 	virtual EAmmoType GetAmmoType() const override
@@ -120,13 +138,22 @@ protected:
 	//////////////////////////////////////////////////////////////////////////
 	// Weapon usage
 
-	/** server notified of hit from client to verify */
+	/** server notified of hit from client to verify, Origin is where client shot from and remote clients replay tracer from */
 	UFUNCTION(reliable, server, WithValidation)
-	void ServerNotifyHit(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
+	void ServerNotifyHit(const FHitResult& Impact, FVector_NetQuantize Origin, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
 
 	/** server notified of miss to show trail FX */
 	UFUNCTION(unreliable, server, WithValidation)
-	void ServerNotifyMiss(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
+	void ServerNotifyMiss(FVector_NetQuantize Origin, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
+
+	/** [server] origin of client shot, or muzzle if client one is too far from it */
+	FVector GetClientShotOrigin(const FVector& ClientOrigin) const;
+
+	/** [server] check if client hit of movable actor is within tolerance: in its hitboxes rewound to shot time, or in its bounding box grown by leeway */
+	bool IsClientHitInTolerance(const FHitResult& Impact) const;
+
+	/** [server] validate client hit of movable actor, queued for batch validation or right away */
+	void ValidateClientHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
 
 	/** process the instant hit and notify the server if necessary */
 	void ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
@@ -156,11 +183,17 @@ protected:
 	/** called in network play to do the cosmetic fx  */
 	void SimulateInstantHit(const FVector& Origin, int32 RandomSeed, float ReticleSpread);
 
+	/** [local] detail of shot effects allowed by tracer budget */
+	EShooterShotDetail GetShotDetail(const FVector& EndPoint) const;
+
+	/** spawn trail, impact and physic tracer effects of shot, as detailed as tracer budget allows */
+	void SpawnShotEffects(const FHitResult& Impact, const FVector& EndPoint, const FVector& TracerOrigin, int32 RandomSeed);
+
 	/** spawn effects for impact */
 	void SpawnImpactEffects(const FHitResult& Impact);
 	
-	/** spawn physic tracer actor effect */
-	void SpawnTracerPhysic(const FHitResult& Impact);
+	/** spawn physic tracer effect, simulated tracer is a function of shot origin, impact and random seed */
+	void SpawnTracerPhysic(const FHitResult& Impact, const FVector& Origin, int32 RandomSeed);
 
 	/** spawn trail effect */
 	void SpawnTrailEffect(const FVector& EndPoint);
@@ -51,6 +51,12 @@ class AShooterWeapon_Projectile : public AShooterWeapon
 	/** apply config on projectile */
 	void ApplyWeaponConfig(FProjectileWeaponData& Data);
 
+	/** direction to launch projectile from Origin to hit Target, lofted by projectile gravity */
+	FVector GetLaunchDirection(const FVector& Origin, const FVector& Target) const;
+
+	/** direction to launch projectile from Origin to hit Target moving with TargetVelocity, leading it by flight time */
+	FVector GetLeadDirection(const FVector& Origin, const FVector& Target, const FVector& TargetVelocity) const;
+
 protected:
 
 	virtual EAmmoType GetAmmoType() const override
@@ -71,4 +77,7 @@ protected:
 	/** spawn projectile on server */
 	UFUNCTION(reliable, server, WithValidation)
 	void ServerFireProjectile(FVector Origin, FVector_NetQuantizeNormal ShootDir);
+
+	/** solve launch of projectile class from Origin to Target */
+	void SolveLaunch(const FVector& Origin, const FVector& Target, struct FShooterBallisticSolution& OutSolution) const;
 };